@@ -84,6 +84,13 @@ static int CEPHFS_MkDir(const char *path, mode_t mode, aiori_mod_opt_t *options)
 static int CEPHFS_RmDir(const char *path, aiori_mod_opt_t *options);
 static int CEPHFS_Access(const char *path, int mode, aiori_mod_opt_t *options);
 static int CEPHFS_Stat(const char *path, struct stat *buf, aiori_mod_opt_t *options);
+static int CEPHFS_Setxattr(const char *path, const char *name, const void *value, size_t size, aiori_mod_opt_t *options);
+static int CEPHFS_Getxattr(const char *path, const char *name, void *value, size_t size, aiori_mod_opt_t *options);
+static int CEPHFS_Listxattr(const char *path, char *list, size_t size, aiori_mod_opt_t *options);
+static int CEPHFS_Rename(const char *oldpath, const char *newpath, aiori_mod_opt_t *options);
+static int CEPHFS_Link(const char *oldpath, const char *newpath, aiori_mod_opt_t *options);
+static int CEPHFS_Symlink(const char *target, const char *linkpath, aiori_mod_opt_t *options);
+static int CEPHFS_Readlink(const char *path, char *buf, size_t size, aiori_mod_opt_t *options);
 static void CEPHFS_Sync(aiori_mod_opt_t *);
 static option_help * CEPHFS_options();
 
@@ -110,6 +117,13 @@ ior_aiori_t cephfs_aiori = {
         .rmdir = CEPHFS_RmDir,
         .access = CEPHFS_Access,
         .stat = CEPHFS_Stat,
+        .setxattr = CEPHFS_Setxattr,
+        .getxattr = CEPHFS_Getxattr,
+        .listxattr = CEPHFS_Listxattr,
+        .rename = CEPHFS_Rename,
+        .link = CEPHFS_Link,
+        .symlink = CEPHFS_Symlink,
+        .readlink = CEPHFS_Readlink,
         .sync = CEPHFS_Sync,
         .enable_mdtest = true,
 };
@@ -401,6 +415,45 @@ static int CEPHFS_Stat(const char *path, struct stat *buf, aiori_mod_opt_t *opti
         return ceph_stat(cmount, pfix(path), buf);
 }
 
+static int CEPHFS_Setxattr(const char *path, const char *name, const void *value, size_t size, aiori_mod_opt_t *options)
+{
+        return ceph_setxattr(cmount, pfix(path), name, value, size, 0) < 0 ? -1 : 0;
+}
+
+static int CEPHFS_Getxattr(const char *path, const char *name, void *value, size_t size, aiori_mod_opt_t *options)
+{
+        int ret = ceph_getxattr(cmount, pfix(path), name, value, size);
+        return ret < 0 ? -1 : ret;
+}
+
+static int CEPHFS_Listxattr(const char *path, char *list, size_t size, aiori_mod_opt_t *options)
+{
+        int ret = ceph_listxattr(cmount, pfix(path), list, size);
+        return ret < 0 ? -1 : ret;
+}
+
+static int CEPHFS_Rename(const char *oldpath, const char *newpath, aiori_mod_opt_t *options)
+{
+        return ceph_rename(cmount, pfix(oldpath), pfix(newpath)) < 0 ? -1 : 0;
+}
+
+static int CEPHFS_Link(const char *oldpath, const char *newpath, aiori_mod_opt_t *options)
+{
+        return ceph_link(cmount, pfix(oldpath), pfix(newpath)) < 0 ? -1 : 0;
+}
+
+/* the target is stored as it is, relative targets are not prefixed */
+static int CEPHFS_Symlink(const char *target, const char *linkpath, aiori_mod_opt_t *options)
+{
+        return ceph_symlink(cmount, target, pfix(linkpath)) < 0 ? -1 : 0;
+}
+
+static int CEPHFS_Readlink(const char *path, char *buf, size_t size, aiori_mod_opt_t *options)
+{
+        int ret = ceph_readlink(cmount, pfix(path), buf, size);
+        return ret < 0 ? -1 : ret;
+}
+
 static void CEPHFS_Sync(aiori_mod_opt_t *options)
 {
         int ret = ceph_sync_fs(cmount);
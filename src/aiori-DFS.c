@@ -82,6 +82,19 @@ static int DFS_Mkdir (const char *, mode_t, aiori_mod_opt_t *);
 static int DFS_Rename(const char *, const char *, aiori_mod_opt_t *);
 static int DFS_Rmdir (const char *, aiori_mod_opt_t *);
 static int DFS_Access (const char *, int, aiori_mod_opt_t *);
+static aiori_dir_t *DFS_Opendir(const char *, aiori_mod_opt_t *);
+static void DFS_Closedir(aiori_dir_t *, aiori_mod_opt_t *);
+static aiori_fd_t *DFS_Createat(aiori_dir_t *, const char *, int, aiori_mod_opt_t *);
+static aiori_fd_t *DFS_Openat(aiori_dir_t *, const char *, int, aiori_mod_opt_t *);
+static int DFS_Statat(aiori_dir_t *, const char *, struct stat *, aiori_mod_opt_t *);
+static int DFS_Unlinkat(aiori_dir_t *, const char *, aiori_mod_opt_t *);
+static int DFS_Mkdirat(aiori_dir_t *, const char *, mode_t, aiori_mod_opt_t *);
+static int DFS_Readdir(const char *, aiori_dirent_fn, void *, aiori_mod_opt_t *);
+static int DFS_Setxattr(const char *, const char *, const void *, size_t, aiori_mod_opt_t *);
+static int DFS_Getxattr(const char *, const char *, void *, size_t, aiori_mod_opt_t *);
+static int DFS_Listxattr(const char *, char *, size_t, aiori_mod_opt_t *);
+static int DFS_Symlink(const char *, const char *, aiori_mod_opt_t *);
+static int DFS_Readlink(const char *, char *, size_t, aiori_mod_opt_t *);
 static option_help * DFS_options(aiori_mod_opt_t **, aiori_mod_opt_t *);
 static void DFS_init_xfer_options(aiori_xfer_hint_t *);
 static int DFS_check_params(aiori_mod_opt_t *);
@@ -154,6 +167,20 @@ ior_aiori_t dfs_aiori = {
         .get_options	= DFS_options,
         .check_params	= DFS_check_params,
         .enable_mdtest	= true,
+        .opendir	= DFS_Opendir,
+        .closedir	= DFS_Closedir,
+        .createat	= DFS_Createat,
+        .openat		= DFS_Openat,
+        .statat		= DFS_Statat,
+        .unlinkat	= DFS_Unlinkat,
+        .mkdirat	= DFS_Mkdirat,
+        .rmdirat	= DFS_Unlinkat,
+        .readdir	= DFS_Readdir,
+        .setxattr	= DFS_Setxattr,
+        .getxattr	= DFS_Getxattr,
+        .listxattr	= DFS_Listxattr,
+        .symlink	= DFS_Symlink,
+        .readlink	= DFS_Readlink,
 };
 
 /***************************** F U N C T I O N S ******************************/
@@ -1091,3 +1118,227 @@ out:
                 return -1;
 	return rc;
 }
+
+/*
+ * The directory objects are owned by the handle hash table, the *at calls
+ * pass the parent object to DFS directly instead of looking up the path.
+ */
+static aiori_dir_t *
+DFS_Opendir(const char *path, aiori_mod_opt_t * param)
+{
+        char buf[PATH_MAX];
+
+        /* same as the parent names of parse_filename() */
+        if (path[0] != '/') {
+                path = realpath(path, buf);
+                if (path == NULL)
+                        return NULL;
+        }
+        return (aiori_dir_t *) lookup_insert_dir(path, NULL);
+}
+
+static void
+DFS_Closedir(aiori_dir_t *dir, aiori_mod_opt_t * param)
+{
+        /* released with the hash table in DFS_Finalize() */
+}
+
+static aiori_fd_t *
+DFS_Createat(aiori_dir_t *dir, const char *name, int flags, aiori_mod_opt_t *param)
+{
+        DFS_options_t *o = (DFS_options_t*) param;
+	dfs_obj_t *obj = NULL;
+        int fd_oflag = O_CREAT | O_RDWR;
+	int rc;
+
+        if (flags & IOR_EXCL)
+                fd_oflag |= O_EXCL;
+
+        rc = dfs_open(dfs, (dfs_obj_t *) dir, name, S_IFREG | 0664, fd_oflag,
+                      objectClass, o->chunk_size, NULL, &obj);
+        DCHECK(rc, "dfs_open() of %s Failed", name);
+out:
+        return (aiori_fd_t *)(obj);
+}
+
+static aiori_fd_t *
+DFS_Openat(aiori_dir_t *dir, const char *name, int flags, aiori_mod_opt_t *param)
+{
+        DFS_options_t *o = (DFS_options_t*) param;
+	dfs_obj_t *obj = NULL;
+	int rc;
+
+        rc = dfs_open(dfs, (dfs_obj_t *) dir, name, S_IFREG | 0664, O_RDWR,
+                      objectClass, o->chunk_size, NULL, &obj);
+        DCHECK(rc, "dfs_open() of %s Failed", name);
+out:
+        return (aiori_fd_t *)(obj);
+}
+
+static int
+DFS_Statat(aiori_dir_t *dir, const char *name, struct stat *buf, aiori_mod_opt_t * param)
+{
+        return dfs_stat(dfs, (dfs_obj_t *) dir, name, buf) ? -1 : 0;
+}
+
+static int
+DFS_Unlinkat(aiori_dir_t *dir, const char *name, aiori_mod_opt_t * param)
+{
+        return dfs_remove(dfs, (dfs_obj_t *) dir, name, false, NULL) ? -1 : 0;
+}
+
+static int
+DFS_Mkdirat(aiori_dir_t *dir, const char *name, mode_t mode, aiori_mod_opt_t * param)
+{
+        return dfs_mkdir(dfs, (dfs_obj_t *) dir, name, mode, dir_oclass) ? -1 : 0;
+}
+
+/* the object of a file or directory, released by the caller */
+static dfs_obj_t *
+lookup_obj(const char *path, int flags)
+{
+        dfs_obj_t *parent = NULL;
+        dfs_obj_t *obj = NULL;
+	char *name = NULL, *dir_name = NULL;
+	int rc;
+
+	rc = parse_filename(path, &name, &dir_name);
+        DCHECK(rc, "Failed to parse path %s", path);
+
+	assert(dir_name);
+        assert(name);
+
+        parent = lookup_insert_dir(dir_name, NULL);
+        if (parent == NULL)
+                DERR("Failed to lookup parent: %s", dir_name);
+
+	rc = dfs_lookup_rel(dfs, parent, name, flags, &obj, NULL, NULL);
+        DCHECK(rc, "dfs_lookup_rel() of %s Failed", name);
+
+out:
+	if (name)
+		free(name);
+	if (dir_name)
+		free(dir_name);
+	return obj;
+}
+
+static int
+DFS_Setxattr(const char *path, const char *name, const void *value, size_t size, aiori_mod_opt_t * param)
+{
+        dfs_obj_t *obj = lookup_obj(path, O_RDWR);
+        int rc;
+
+        if (obj == NULL)
+                return -1;
+        rc = dfs_setxattr(dfs, obj, name, value, size, 0);
+        dfs_release(obj);
+        return rc ? -1 : 0;
+}
+
+static int
+DFS_Getxattr(const char *path, const char *name, void *value, size_t size, aiori_mod_opt_t * param)
+{
+        dfs_obj_t *obj = lookup_obj(path, O_RDONLY);
+        daos_size_t len = size;
+        int rc;
+
+        if (obj == NULL)
+                return -1;
+        rc = dfs_getxattr(dfs, obj, name, value, &len);
+        dfs_release(obj);
+        return rc ? -1 : (int) len;
+}
+
+static int
+DFS_Listxattr(const char *path, char *list, size_t size, aiori_mod_opt_t * param)
+{
+        dfs_obj_t *obj = lookup_obj(path, O_RDONLY);
+        daos_size_t len = size;
+        int rc;
+
+        if (obj == NULL)
+                return -1;
+        rc = dfs_listxattr(dfs, obj, list, &len);
+        dfs_release(obj);
+        return rc ? -1 : (int) len;
+}
+
+/* DFS has no hard links, symbolic links store the target as their value */
+static int
+DFS_Symlink(const char *target, const char *linkpath, aiori_mod_opt_t * param)
+{
+        dfs_obj_t *parent = NULL;
+        dfs_obj_t *obj = NULL;
+	char *name = NULL, *dir_name = NULL;
+	int rc;
+
+	rc = parse_filename(linkpath, &name, &dir_name);
+        DCHECK(rc, "Failed to parse path %s", linkpath);
+	assert(dir_name);
+        assert(name);
+
+        parent = lookup_insert_dir(dir_name, NULL);
+        if (parent == NULL)
+                DERR("Failed to lookup parent: %s", dir_name);
+
+        rc = dfs_open(dfs, parent, name, S_IFLNK | 0777, O_CREAT | O_EXCL,
+                      0, 0, target, &obj);
+        DCHECK(rc, "dfs_open() of symlink %s Failed", name);
+        dfs_release(obj);
+out:
+	if (name)
+		free(name);
+	if (dir_name)
+		free(dir_name);
+        if (rc)
+                rc = -1;
+	return rc;
+}
+
+static int
+DFS_Readlink(const char *path, char *buf, size_t size, aiori_mod_opt_t * param)
+{
+        dfs_obj_t *obj = lookup_obj(path, O_RDONLY | O_NOFOLLOW);
+        daos_size_t len = size;
+        int rc;
+
+        if (obj == NULL)
+                return -1;
+        rc = dfs_get_symlink_value(obj, buf, &len);
+        dfs_release(obj);
+        /* the length includes the terminating NUL */
+        return rc ? -1 : (int) (len > 0 ? len - 1 : 0);
+}
+
+#define DFS_READDIR_ENTRIES 64
+
+/* dfs_readdir() does not return . and .. */
+static int
+DFS_Readdir(const char *path, aiori_dirent_fn fn, void *arg, aiori_mod_opt_t * param)
+{
+        struct dirent ents[DFS_READDIR_ENTRIES];
+        daos_anchor_t anchor = {0};
+        dfs_obj_t *dir;
+        int count = 0;
+        int rc;
+
+        dir = (dfs_obj_t *) DFS_Opendir(path, param);
+        if (dir == NULL)
+                return -1;
+
+        while (!daos_anchor_is_eof(&anchor)) {
+                uint32_t nr = DFS_READDIR_ENTRIES;
+
+                rc = dfs_readdir(dfs, dir, &anchor, &nr, ents);
+                if (rc) {
+                        WARNF("dfs_readdir() of %s Failed (%d)", path, rc);
+                        return -1;
+                }
+                /* the type is not returned, DT_UNKNOWN */
+                for (uint32_t i = 0; i < nr; i++)
+                        fn(ents[i].d_name, 0, arg);
+                count += nr;
+        }
+        return count;
+}
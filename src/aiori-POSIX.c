@@ -16,14 +16,16 @@
 #  include "config.h"
 #endif
 
+#ifdef __linux__
+#  define _GNU_SOURCE            /* O_DIRECT, syscall(), statx and MAP_POPULATE */
+#endif
+
 #include <stdio.h>
 #include <stdlib.h>
 
 #ifdef __linux__
-#  include <sys/ioctl.h>          /* necessary for: */
-#  define __USE_GNU               /* O_DIRECT and */
-#  include <fcntl.h>              /* IO operations */
-#  undef __USE_GNU
+#  include <sys/ioctl.h>
+#  include <sys/syscall.h>        /* getdents64 */
 #endif                          /* __linux__ */
 
 #include <errno.h>
@@ -39,9 +41,19 @@
 #  include <gpfs_fcntl.h>
 #endif
 
+#ifdef HAVE_LINUX_IO_URING_H
+#  include <linux/io_uring.h>
+#  include <sys/mman.h>
+#endif
+
+#include <dirent.h>
+
+#ifdef HAVE_SYS_XATTR_H
+#  include <sys/xattr.h>
+#endif
+
 #ifdef HAVE_BEEGFS_BEEGFS_H
 #  include <beegfs/beegfs.h>
-#  include <dirent.h>
 #  include <libgen.h>
 #endif
 
@@ -65,6 +77,21 @@ typedef struct {
 #endif
 } posix_fd;
 
+typedef struct {
+  int fd;
+} posix_dir;
+
+#ifdef SYS_getdents64
+/* the records returned by getdents64, glibc only declares them with the call since 2.30 */
+struct posix_dirent64 {
+  uint64_t d_ino;
+  int64_t d_off;
+  unsigned short d_reclen;
+  unsigned char d_type;
+  char d_name[];
+};
+#endif
+
 
 #ifndef   open64                /* necessary for TRU64 -- */
 #  define open64  open            /* unlikely, but may pose */
@@ -121,6 +148,7 @@ option_help * POSIX_options(aiori_mod_opt_t ** init_backend_options, aiori_mod_o
     o->lustre_start_ost = -1;
     o->beegfs_numTargets = -1;
     o->beegfs_chunkSize = -1;
+    o->readdir_buffer = 32768;
   }
  
   *init_backend_options = (aiori_mod_opt_t*) o;
@@ -128,6 +156,7 @@ option_help * POSIX_options(aiori_mod_opt_t ** init_backend_options, aiori_mod_o
   option_help h [] = {
     {0, "posix.odirect", "Direct I/O Mode", OPTION_FLAG, 'd', & o->direct_io},
     {0, "posix.rangelocks", "Use range locks (read locks for read ops)", OPTION_FLAG, 'd', & o->range_locks},
+    {0, "posix.readdirbuffer", "Bytes of directory entries read per getdents64 call when listing directories", OPTION_OPTIONAL_ARGUMENT, 'd', & o->readdir_buffer},
 #ifdef HAVE_BEEGFS_BEEGFS_H
     {0, "posix.beegfs.NumTargets", "", OPTION_OPTIONAL_ARGUMENT, 'd', & o->beegfs_numTargets},
     {0, "posix.beegfs.ChunkSize", "", OPTION_OPTIONAL_ARGUMENT, 'd', & o->beegfs_chunkSize},
@@ -176,6 +205,7 @@ ior_aiori_t posix_aiori = {
         .mknod = POSIX_Mknod,
         .open = POSIX_Open,
         .xfer = POSIX_Xfer,
+        .writev = POSIX_Writev,
         .close = POSIX_Close,
         .remove = POSIX_Delete,
         .xfer_hints = POSIX_xfer_hints,
@@ -191,7 +221,24 @@ ior_aiori_t posix_aiori = {
         .get_options = POSIX_options,
         .enable_mdtest = true,
         .sync = POSIX_Sync,
-        .check_params = POSIX_check_params
+        .check_params = POSIX_check_params,
+        .opendir = POSIX_Opendir,
+        .closedir = POSIX_Closedir,
+        .createat = POSIX_Createat,
+        .openat = POSIX_Openat,
+        .statat = POSIX_Statat,
+        .unlinkat = POSIX_Unlinkat,
+        .mkdirat = POSIX_Mkdirat,
+        .rmdirat = POSIX_Rmdirat,
+        .readdir = POSIX_Readdir,
+#ifdef HAVE_SYS_XATTR_H
+        .setxattr = POSIX_Setxattr,
+        .getxattr = POSIX_Getxattr,
+        .listxattr = POSIX_Listxattr,
+#endif
+        .link = POSIX_Link,
+        .symlink = POSIX_Symlink,
+        .readlink = POSIX_Readlink,
 };
 
 /***************************** F U N C T I O N S ******************************/
@@ -206,6 +253,8 @@ int POSIX_check_params(aiori_mod_opt_t * param){
   posix_options_t * o = (posix_options_t*) param;
   if (o->beegfs_chunkSize != -1 && (!ISPOWEROFTWO(o->beegfs_chunkSize) || o->beegfs_chunkSize < (1<<16)))
         ERR("beegfsChunkSize must be a power of two and >64k");
+  if (o->readdir_buffer < 1024)
+        ERR("posix.readdirbuffer must be at least 1024 bytes");
   if(o->lustre_stripe_count != 0 || o->lustre_stripe_size != 0 || (o->lustre_pool)){
 #if defined(HAVE_LUSTRE_USER) || defined(HAVE_LUSTRE_LUSTREAPI)
     o->lustre_set_striping = 1;
@@ -714,6 +763,56 @@ aiori_fd_t *POSIX_Open(char *testFileName, int flags, aiori_mod_opt_t * param)
         return (aiori_fd_t*) pfd;
 }
 
+/*
+ * Write the buffers of iov at offset with pwritev(), continuing after partial
+ * writes.
+ */
+IOR_offset_t POSIX_Writev(aiori_fd_t *file, const struct iovec *iov, int iovcnt,
+                          IOR_offset_t offset, aiori_mod_opt_t * param)
+{
+        posix_fd * pfd = (posix_fd *) file;
+        struct iovec vec[iovcnt];
+        IOR_offset_t length = 0, done = 0;
+        int first = 0, xferRetries = 0;
+
+        for (int i = 0; i < iovcnt; i++) {
+                vec[i] = iov[i];
+                length += iov[i].iov_len;
+        }
+        if(hints->dryRun)
+          return length;
+
+        while (done < length) {
+                ssize_t rc = pwritev(pfd->fd, vec + first, iovcnt - first, offset + done);
+                if (rc < 0) {
+                        WARNF("pwritev(%d, %d, %lld) failed %s", pfd->fd, iovcnt - first, offset + done, strerror(errno));
+                        return done;
+                }
+                done += rc;
+                if (done < length) {
+                        WARNF("task %d, partial pwritev(), %lld of %lld bytes at offset %lld\n",
+                                rank, (long long) rc, length - done + rc, offset + done - rc);
+                        if (xferRetries++ > MAX_RETRY || hints->singleXferAttempt){
+                          WARN("too many retries -- aborting");
+                          return done;
+                        }
+                }
+                /* skip what was written */
+                while (first < iovcnt && (size_t) rc >= vec[first].iov_len) {
+                        rc -= vec[first].iov_len;
+                        first++;
+                }
+                if (first < iovcnt) {
+                        vec[first].iov_base = (char *) vec[first].iov_base + rc;
+                        vec[first].iov_len -= rc;
+                }
+        }
+        if (hints->fsyncPerWrite == TRUE){
+          POSIX_Fsync(file, param);
+        }
+        return length;
+}
+
 /*
  * Write or read access to file using the POSIX interface.
  */
@@ -901,6 +1000,223 @@ int POSIX_Rename(const char * oldfile, const char * newfile, aiori_mod_opt_t * m
   return 0;
 }
 
+int POSIX_Link(const char * oldfile, const char * newfile, aiori_mod_opt_t * module_options){
+  if(hints->dryRun)
+    return 0;
+  return link(oldfile, newfile);
+}
+
+int POSIX_Symlink(const char * target, const char * linkpath, aiori_mod_opt_t * module_options){
+  if(hints->dryRun)
+    return 0;
+  return symlink(target, linkpath);
+}
+
+int POSIX_Readlink(const char * path, char * buf, size_t size, aiori_mod_opt_t * module_options){
+  if(hints->dryRun)
+    return 0;
+  return (int) readlink(path, buf, size);
+}
+
+/*
+ * Open a directory for the handle-relative calls. Options that need the path
+ * of the file at creation or per file setup after open are only implemented
+ * by the path based calls, then NULL is returned and the caller uses those.
+ */
+aiori_dir_t *POSIX_Opendir(const char *path, aiori_mod_opt_t * param)
+{
+        posix_options_t * o = (posix_options_t*) param;
+        if(hints->dryRun || o->lustre_set_striping || o->lustre_set_pool || o->lustre_ignore_locks
+           || o->gpfs_release_token || o->gpfs_finegrain_writesharing || o->gpfs_finegrain_readsharing
+           || o->gpuDirect)
+          return NULL;
+#ifdef HAVE_BEEGFS_BEEGFS_H
+        if(beegfs_isOptionSet(o->beegfs_chunkSize) || beegfs_isOptionSet(o->beegfs_numTargets))
+          return NULL;
+#endif
+        int fd = open64(path, O_RDONLY | O_DIRECTORY);
+        if (fd < 0){
+                WARNF("[RANK %03d]: open() of directory \"%s\" failed: %s", rank, path, strerror(errno));
+                return NULL;
+        }
+        posix_dir * pdir = safeMalloc(sizeof(posix_dir));
+        pdir->fd = fd;
+        return (aiori_dir_t*) pdir;
+}
+
+void POSIX_Closedir(aiori_dir_t *dir, aiori_mod_opt_t * param)
+{
+        int fd = ((posix_dir*) dir)->fd;
+        if (close(fd) != 0){
+                ERRF("close(%d) failed", fd);
+        }
+        free(dir);
+}
+
+/*
+ * Create a file relative to a directory, see POSIX_Create().
+ */
+aiori_fd_t *POSIX_Createat(aiori_dir_t *dir, const char *name, int flags, aiori_mod_opt_t * param)
+{
+        int fd_oflag = O_BINARY | O_CREAT | O_RDWR;
+        int mode = 0664;
+        posix_options_t * o = (posix_options_t*) param;
+        if (o->direct_io == TRUE){
+                set_o_direct_flag(& fd_oflag);
+        }
+        posix_fd * pfd = safeMalloc(sizeof(posix_fd));
+        pfd->fd = openat(((posix_dir*) dir)->fd, name, fd_oflag, mode);
+        if (pfd->fd < 0){
+                ERRF("openat(\"%s\", %d, %#o) failed. Error: %s",
+                        name, fd_oflag, mode, strerror(errno));
+        }
+        return (aiori_fd_t*) pfd;
+}
+
+/*
+ * Open a file relative to a directory, see POSIX_Open().
+ */
+aiori_fd_t *POSIX_Openat(aiori_dir_t *dir, const char *name, int flags, aiori_mod_opt_t * param)
+{
+        int fd_oflag = O_BINARY;
+        if(flags & IOR_RDONLY){
+          fd_oflag |= O_RDONLY;
+        }else if(flags & IOR_WRONLY){
+          fd_oflag |= O_WRONLY;
+        }else{
+          fd_oflag |= O_RDWR;
+        }
+        posix_options_t * o = (posix_options_t*) param;
+        if (o->direct_io == TRUE){
+                set_o_direct_flag(&fd_oflag);
+        }
+        posix_fd * pfd = safeMalloc(sizeof(posix_fd));
+        pfd->fd = openat(((posix_dir*) dir)->fd, name, fd_oflag);
+        if (pfd->fd < 0)
+                ERRF("openat(\"%s\", %d) failed: %s", name, fd_oflag, strerror(errno));
+        return (aiori_fd_t*) pfd;
+}
+
+int POSIX_Statat(aiori_dir_t *dir, const char *name, struct stat *buf, aiori_mod_opt_t * param)
+{
+        return fstatat(((posix_dir*) dir)->fd, name, buf, 0);
+}
+
+int POSIX_Unlinkat(aiori_dir_t *dir, const char *name, aiori_mod_opt_t * param)
+{
+        return unlinkat(((posix_dir*) dir)->fd, name, 0);
+}
+
+int POSIX_Mkdirat(aiori_dir_t *dir, const char *name, mode_t mode, aiori_mod_opt_t * param)
+{
+        return mkdirat(((posix_dir*) dir)->fd, name, mode);
+}
+
+int POSIX_Rmdirat(aiori_dir_t *dir, const char *name, aiori_mod_opt_t * param)
+{
+        return unlinkat(((posix_dir*) dir)->fd, name, AT_REMOVEDIR);
+}
+
+static int is_dot_entry(const char *name)
+{
+        return name[0] == '.' && (name[1] == 0 || (name[1] == '.' && name[2] == 0));
+}
+
+/*
+ * List a directory. On Linux the entries are read with getdents64 into a
+ * buffer of posix.readdirbuffer bytes, which sets the number of system calls
+ * needed for a large directory; elsewhere readdir() of the C library is used.
+ */
+int POSIX_Readdir(const char *path, aiori_dirent_fn fn, void *arg, aiori_mod_opt_t * param)
+{
+        int count = 0;
+        if(hints->dryRun)
+          return 0;
+#ifdef SYS_getdents64
+        posix_options_t * o = (posix_options_t*) param;
+        long nread;
+        int fd = open64(path, O_RDONLY | O_DIRECTORY);
+        if (fd < 0){
+                WARNF("[RANK %03d]: open() of directory \"%s\" failed: %s", rank, path, strerror(errno));
+                return -1;
+        }
+        char * buf = safeMalloc(o->readdir_buffer);
+        while ((nread = syscall(SYS_getdents64, fd, buf, o->readdir_buffer)) > 0) {
+                for (long pos = 0; pos < nread; ) {
+                        struct posix_dirent64 * d = (struct posix_dirent64 *) (buf + pos);
+                        pos += d->d_reclen;
+                        if (is_dot_entry(d->d_name))
+                                continue;
+                        fn(d->d_name, d->d_type, arg);
+                        count++;
+                }
+        }
+        if (nread < 0){
+                WARNF("[RANK %03d]: getdents64() of directory \"%s\" failed: %s", rank, path, strerror(errno));
+                count = -1;
+        }
+        free(buf);
+        close(fd);
+#else
+        struct dirent * d;
+        DIR * dir = opendir(path);
+        if (dir == NULL){
+                WARNF("[RANK %03d]: opendir() of \"%s\" failed: %s", rank, path, strerror(errno));
+                return -1;
+        }
+        while ((d = readdir(dir)) != NULL) {
+                if (is_dot_entry(d->d_name))
+                        continue;
+#ifdef _DIRENT_HAVE_D_TYPE
+                fn(d->d_name, d->d_type, arg);
+#else
+                fn(d->d_name, DT_UNKNOWN, arg);
+#endif
+                count++;
+        }
+        closedir(dir);
+#endif
+        return count;
+}
+
+#ifdef HAVE_SYS_XATTR_H
+/*
+ * Extended attributes, the calls of macOS take a position and options.
+ */
+int POSIX_Setxattr(const char *path, const char *name, const void *value, size_t size, aiori_mod_opt_t * param)
+{
+        if(hints->dryRun)
+          return 0;
+#ifdef __APPLE__
+        return setxattr(path, name, value, size, 0, 0);
+#else
+        return setxattr(path, name, value, size, 0);
+#endif
+}
+
+int POSIX_Getxattr(const char *path, const char *name, void *value, size_t size, aiori_mod_opt_t * param)
+{
+        if(hints->dryRun)
+          return size;
+#ifdef __APPLE__
+        return getxattr(path, name, value, size, 0, 0);
+#else
+        return getxattr(path, name, value, size);
+#endif
+}
+
+int POSIX_Listxattr(const char *path, char *list, size_t size, aiori_mod_opt_t * param)
+{
+        if(hints->dryRun)
+          return 0;
+#ifdef __APPLE__
+        return listxattr(path, list, size, 0);
+#else
+        return listxattr(path, list, size);
+#endif
+}
+#endif
+
 /*
  * Use POSIX stat() to return aggregate file size.
  */
@@ -930,3 +1246,192 @@ void POSIX_Finalize(aiori_mod_opt_t * options){
   CUfileError_t err = cuFileDriverClose();
 #endif
 }
+
+#ifdef HAVE_LINUX_IO_URING_H
+/*
+ * A ring of io_uring used through the system calls, the metadata calls of a
+ * caller are queued with a tag and their results are reaped by
+ * POSIX_UringComplete(), queued calls are submitted in batches.
+ */
+struct posix_uring {
+        int fd;
+        unsigned batch;
+        unsigned queued;                /* queued but not submitted */
+        int o_direct;
+        void *sq_ring;
+        size_t sq_ring_size;
+        void *cq_ring;
+        size_t cq_ring_size;
+        struct io_uring_sqe *sqes;
+        size_t sqes_size;
+        unsigned *sq_tail;
+        unsigned *sq_mask;
+        unsigned *sq_array;
+        unsigned *cq_head;
+        unsigned *cq_tail;
+        unsigned *cq_mask;
+        struct io_uring_cqe *cqes;
+};
+
+static const int uring_ops[] = {IORING_OP_OPENAT, IORING_OP_CLOSE, IORING_OP_STATX, IORING_OP_READ,
+                                IORING_OP_WRITE, IORING_OP_FSYNC, IORING_OP_UNLINKAT, IORING_OP_MKDIRAT};
+
+static int uring_enter(posix_uring_t *r, unsigned submit, unsigned wait)
+{
+        int ret;
+        do {
+                ret = syscall(__NR_io_uring_enter, r->fd, submit, wait, wait ? IORING_ENTER_GETEVENTS : 0, NULL, 0);
+        } while (ret < 0 && errno == EINTR);
+        if (ret < 0)
+                ERRF("io_uring_enter() failed: %s", strerror(errno));
+        return ret;
+}
+
+/*
+ * Create a ring for depth calls in flight, NULL if the kernel lacks io_uring or
+ * one of the calls used.
+ */
+posix_uring_t *POSIX_UringInit(unsigned depth, unsigned batch, aiori_mod_opt_t * param)
+{
+        posix_options_t * o = (posix_options_t*) param;
+        struct io_uring_params p;
+        memset(& p, 0, sizeof(p));
+        int fd = syscall(__NR_io_uring_setup, depth, & p);
+        if (fd < 0){
+                WARNF("io_uring_setup() failed: %s", strerror(errno));
+                return NULL;
+        }
+
+        /* the metadata calls were added up to Linux 5.15 */
+        const int nops = IORING_OP_LAST;
+        struct io_uring_probe *probe = safeMalloc(sizeof(*probe) + nops * sizeof(struct io_uring_probe_op));
+        memset(probe, 0, sizeof(*probe) + nops * sizeof(struct io_uring_probe_op));
+        if (syscall(__NR_io_uring_register, fd, IORING_REGISTER_PROBE, probe, nops) < 0){
+                WARNF("io_uring probe failed: %s", strerror(errno));
+                free(probe);
+                close(fd);
+                return NULL;
+        }
+        for (size_t i = 0; i < sizeof(uring_ops) / sizeof(uring_ops[0]); i++){
+                if (uring_ops[i] > probe->last_op || ! (probe->ops[uring_ops[i]].flags & IO_URING_OP_SUPPORTED)){
+                        WARNF("io_uring of this kernel lacks operation %d", uring_ops[i]);
+                        free(probe);
+                        close(fd);
+                        return NULL;
+                }
+        }
+        free(probe);
+
+        posix_uring_t *r = safeMalloc(sizeof(posix_uring_t));
+        memset(r, 0, sizeof(posix_uring_t));
+        r->fd = fd;
+        r->batch = batch;
+        r->o_direct = o->direct_io;
+        r->sq_ring_size = p.sq_off.array + p.sq_entries * sizeof(unsigned);
+        r->cq_ring_size = p.cq_off.cqes + p.cq_entries * sizeof(struct io_uring_cqe);
+        r->sqes_size = p.sq_entries * sizeof(struct io_uring_sqe);
+        r->sq_ring = mmap(NULL, r->sq_ring_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQ_RING);
+        r->cq_ring = mmap(NULL, r->cq_ring_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_CQ_RING);
+        r->sqes = mmap(NULL, r->sqes_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQES);
+        if (r->sq_ring == MAP_FAILED || r->cq_ring == MAP_FAILED || r->sqes == MAP_FAILED)
+                ERRF("mmap() of the io_uring failed: %s", strerror(errno));
+        r->sq_tail = (unsigned *) ((char *) r->sq_ring + p.sq_off.tail);
+        r->sq_mask = (unsigned *) ((char *) r->sq_ring + p.sq_off.ring_mask);
+        r->sq_array = (unsigned *) ((char *) r->sq_ring + p.sq_off.array);
+        r->cq_head = (unsigned *) ((char *) r->cq_ring + p.cq_off.head);
+        r->cq_tail = (unsigned *) ((char *) r->cq_ring + p.cq_off.tail);
+        r->cq_mask = (unsigned *) ((char *) r->cq_ring + p.cq_off.ring_mask);
+        r->cqes = (struct io_uring_cqe *) ((char *) r->cq_ring + p.cq_off.cqes);
+        return r;
+}
+
+void POSIX_UringFree(posix_uring_t *r)
+{
+        munmap(r->sqes, r->sqes_size);
+        munmap(r->cq_ring, r->cq_ring_size);
+        munmap(r->sq_ring, r->sq_ring_size);
+        close(r->fd);
+        free(r);
+}
+
+/* queue a call, the caller keeps at most depth calls in flight */
+static void uring_queue(posix_uring_t *r, int op, int fd, const void *addr, unsigned len, uint64_t off, uint64_t tag, uint32_t op_flags)
+{
+        unsigned tail = *r->sq_tail;
+        unsigned index = tail & *r->sq_mask;
+        struct io_uring_sqe *sqe = & r->sqes[index];
+
+        memset(sqe, 0, sizeof(*sqe));
+        sqe->opcode = op;
+        sqe->fd = fd;
+        sqe->addr = (uint64_t) (uintptr_t) addr;
+        sqe->len = len;
+        sqe->off = off;
+        sqe->rw_flags = op_flags;       /* union of open_flags, statx_flags and unlink_flags */
+        sqe->user_data = tag;
+        r->sq_array[index] = index;
+        __atomic_store_n(r->sq_tail, tail + 1, __ATOMIC_RELEASE);
+        r->queued++;
+        if (r->batch > 0 && r->queued >= r->batch)
+                r->queued -= uring_enter(r, r->queued, 0);
+}
+
+void POSIX_UringOpen(posix_uring_t *r, const char *path, int flags, mode_t mode, uint64_t tag)
+{
+        int fd_oflag = O_BINARY | flags;
+        if (r->o_direct)
+                set_o_direct_flag(& fd_oflag);
+        uring_queue(r, IORING_OP_OPENAT, AT_FDCWD, path, mode, 0, tag, fd_oflag);
+}
+
+void POSIX_UringStat(posix_uring_t *r, const char *path, struct statx *buf, uint64_t tag)
+{
+        uring_queue(r, IORING_OP_STATX, AT_FDCWD, path, STATX_BASIC_STATS, (uint64_t) (uintptr_t) buf, tag, 0);
+}
+
+void POSIX_UringUnlink(posix_uring_t *r, const char *path, int dir, uint64_t tag)
+{
+        uring_queue(r, IORING_OP_UNLINKAT, AT_FDCWD, path, 0, 0, tag, dir ? AT_REMOVEDIR : 0);
+}
+
+void POSIX_UringMkdir(posix_uring_t *r, const char *path, mode_t mode, uint64_t tag)
+{
+        uring_queue(r, IORING_OP_MKDIRAT, AT_FDCWD, path, mode, 0, tag, 0);
+}
+
+void POSIX_UringXfer(posix_uring_t *r, int access, int fd, void *buf, size_t length, IOR_offset_t offset, uint64_t tag)
+{
+        uring_queue(r, access == WRITE ? IORING_OP_WRITE : IORING_OP_READ, fd, buf, length, offset, tag, 0);
+}
+
+void POSIX_UringFsync(posix_uring_t *r, int fd, uint64_t tag)
+{
+        uring_queue(r, IORING_OP_FSYNC, fd, NULL, 0, 0, tag, 0);
+}
+
+void POSIX_UringClose(posix_uring_t *r, int fd, uint64_t tag)
+{
+        uring_queue(r, IORING_OP_CLOSE, fd, NULL, 0, 0, tag, 0);
+}
+
+/*
+ * Reap the result of a call: the return value of the system call or -errno.
+ * Returns 0 if no call completed, with wait it blocks until one completes.
+ */
+int POSIX_UringComplete(posix_uring_t *r, int wait, uint64_t *tag, int *res)
+{
+        unsigned head = *r->cq_head;
+        if (head == __atomic_load_n(r->cq_tail, __ATOMIC_ACQUIRE)){
+                if (! wait && r->queued == 0)
+                        return 0;
+                r->queued -= uring_enter(r, r->queued, wait ? 1 : 0);
+                if (head == __atomic_load_n(r->cq_tail, __ATOMIC_ACQUIRE))
+                        return 0;
+        }
+        struct io_uring_cqe *cqe = & r->cqes[head & *r->cq_mask];
+        *tag = cqe->user_data;
+        *res = cqe->res;
+        __atomic_store_n(r->cq_head, head + 1, __ATOMIC_RELEASE);
+        return 1;
+}
+#endif /* HAVE_LINUX_IO_URING_H */
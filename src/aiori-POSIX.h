@@ -44,6 +44,7 @@ typedef struct{
   int beegfs_chunkSize;            /* srtipe pattern for new files */
   int gpuDirect;
   int range_locks;                 /* use POSIX range locks for writes */
+  int readdir_buffer;              /* bytes of directory entries read per call */
 } posix_options_t;
 
 void POSIX_Sync(aiori_mod_opt_t * param);
@@ -56,9 +57,43 @@ aiori_fd_t *POSIX_Open(char *testFileName, int flags, aiori_mod_opt_t * module_o
 IOR_offset_t POSIX_GetFileSize(aiori_mod_opt_t * test, char *testFileName);
 void POSIX_Delete(char *testFileName, aiori_mod_opt_t * module_options);
 int POSIX_Rename(const char *oldfile, const char *newfile, aiori_mod_opt_t * module_options);
+int POSIX_Link(const char *oldfile, const char *newfile, aiori_mod_opt_t * module_options);
+int POSIX_Symlink(const char *target, const char *linkpath, aiori_mod_opt_t * module_options);
+int POSIX_Readlink(const char *path, char *buf, size_t size, aiori_mod_opt_t * module_options);
+IOR_offset_t POSIX_Writev(aiori_fd_t *fd, const struct iovec *iov, int iovcnt, IOR_offset_t offset, aiori_mod_opt_t * module_options);
 void POSIX_Close(aiori_fd_t *fd, aiori_mod_opt_t * module_options);
+aiori_dir_t *POSIX_Opendir(const char *path, aiori_mod_opt_t * module_options);
+void POSIX_Closedir(aiori_dir_t *dir, aiori_mod_opt_t * module_options);
+aiori_fd_t *POSIX_Createat(aiori_dir_t *dir, const char *name, int flags, aiori_mod_opt_t * module_options);
+aiori_fd_t *POSIX_Openat(aiori_dir_t *dir, const char *name, int flags, aiori_mod_opt_t * module_options);
+int POSIX_Statat(aiori_dir_t *dir, const char *name, struct stat *buf, aiori_mod_opt_t * module_options);
+int POSIX_Unlinkat(aiori_dir_t *dir, const char *name, aiori_mod_opt_t * module_options);
+int POSIX_Mkdirat(aiori_dir_t *dir, const char *name, mode_t mode, aiori_mod_opt_t * module_options);
+int POSIX_Rmdirat(aiori_dir_t *dir, const char *name, aiori_mod_opt_t * module_options);
+int POSIX_Readdir(const char *path, aiori_dirent_fn fn, void *arg, aiori_mod_opt_t * module_options);
+#ifdef HAVE_SYS_XATTR_H
+int POSIX_Setxattr(const char *path, const char *name, const void *value, size_t size, aiori_mod_opt_t * module_options);
+int POSIX_Getxattr(const char *path, const char *name, void *value, size_t size, aiori_mod_opt_t * module_options);
+int POSIX_Listxattr(const char *path, char *list, size_t size, aiori_mod_opt_t * module_options);
+#endif
 option_help * POSIX_options(aiori_mod_opt_t ** init_backend_options, aiori_mod_opt_t * init_values);
 void POSIX_xfer_hints(aiori_xfer_hint_t * params);
 
+#ifdef HAVE_LINUX_IO_URING_H
+#include <linux/stat.h>
+/* asynchronous metadata calls through io_uring, used by mdtest */
+typedef struct posix_uring posix_uring_t;
+posix_uring_t *POSIX_UringInit(unsigned depth, unsigned batch, aiori_mod_opt_t * module_options);
+void POSIX_UringFree(posix_uring_t *ring);
+void POSIX_UringOpen(posix_uring_t *ring, const char *path, int flags, mode_t mode, uint64_t tag);
+void POSIX_UringStat(posix_uring_t *ring, const char *path, struct statx *buf, uint64_t tag);
+void POSIX_UringUnlink(posix_uring_t *ring, const char *path, int dir, uint64_t tag);
+void POSIX_UringMkdir(posix_uring_t *ring, const char *path, mode_t mode, uint64_t tag);
+void POSIX_UringXfer(posix_uring_t *ring, int access, int fd, void *buf, size_t length, IOR_offset_t offset, uint64_t tag);
+void POSIX_UringFsync(posix_uring_t *ring, int fd, uint64_t tag);
+void POSIX_UringClose(posix_uring_t *ring, int fd, uint64_t tag);
+int POSIX_UringComplete(posix_uring_t *ring, int wait, uint64_t *tag, int *res);
+#endif
+
 
 #endif
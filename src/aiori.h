@@ -16,6 +16,7 @@
 #define _AIORI_H
 
 #include <sys/stat.h>
+#include <sys/uio.h>
 #include <stdbool.h>
 
 #include "iordef.h"                                     /* IOR Definitions */
@@ -84,6 +85,17 @@ typedef struct aiori_fd_t{
   void * dummy;
 } aiori_fd_t;
 
+/* an open directory that names may be resolved against by the *at calls */
+typedef struct aiori_dir_t{
+  void * dummy;
+} aiori_dir_t;
+
+/*
+ * called by readdir with the name of every entry of a directory but . and ..,
+ * type is the DT_ value of dirent.h or DT_UNKNOWN (0) if the backend does not know it
+ */
+typedef void (*aiori_dirent_fn)(const char *name, unsigned char type, void *arg);
+
 typedef struct ior_aiori {
         char *name;
         char *name_legacy;
@@ -96,6 +108,9 @@ typedef struct ior_aiori {
         void (*xfer_hints)(aiori_xfer_hint_t * params);
         IOR_offset_t (*xfer)(int access, aiori_fd_t *, IOR_size_t *,
                              IOR_offset_t size, IOR_offset_t offset, aiori_mod_opt_t * module_options);
+        /* optional, write the buffers of iov at offset like one transfer, returns the bytes written */
+        IOR_offset_t (*writev)(aiori_fd_t *, const struct iovec *iov, int iovcnt,
+                               IOR_offset_t offset, aiori_mod_opt_t * module_options);
         void (*close)(aiori_fd_t *, aiori_mod_opt_t * module_options);
         void (*remove)(char *, aiori_mod_opt_t * module_options);
         char* (*get_version)(void);
@@ -112,6 +127,28 @@ typedef struct ior_aiori {
         option_help * (*get_options)(aiori_mod_opt_t ** init_backend_options, aiori_mod_opt_t* init_values); /* initializes the backend options as well and returns the pointer to the option help structure */
         int (*check_params)(aiori_mod_opt_t *); /* check if the provided module_optionseters for the given test and the module options are correct, if they aren't print a message and exit(1) or return 1*/
         void (*sync)(aiori_mod_opt_t * ); /* synchronize every pending operation for this storage */
+        /*
+         Optional handle-relative operations, names are resolved against a directory opened with opendir.
+         opendir may return NULL if the current module options need the path based calls, e.g., to set a layout.
+        */
+        aiori_dir_t *(*opendir)(const char *path, aiori_mod_opt_t * module_options);
+        void (*closedir)(aiori_dir_t *, aiori_mod_opt_t * module_options);
+        aiori_fd_t *(*createat)(aiori_dir_t *, const char *name, int iorflags, aiori_mod_opt_t * module_options);
+        aiori_fd_t *(*openat)(aiori_dir_t *, const char *name, int iorflags, aiori_mod_opt_t * module_options);
+        int (*statat) (aiori_dir_t *, const char *name, struct stat *buf, aiori_mod_opt_t * module_options);
+        int (*unlinkat) (aiori_dir_t *, const char *name, aiori_mod_opt_t * module_options);
+        int (*mkdirat) (aiori_dir_t *, const char *name, mode_t mode, aiori_mod_opt_t * module_options);
+        int (*rmdirat) (aiori_dir_t *, const char *name, aiori_mod_opt_t * module_options);
+        /* optional, list a directory, returns the number of entries or -1 */
+        int (*readdir) (const char *path, aiori_dirent_fn fn, void *arg, aiori_mod_opt_t * module_options);
+        /* optional extended attributes, return -1 on error, get and list the size of the value or names otherwise */
+        int (*setxattr) (const char *path, const char *name, const void *value, size_t size, aiori_mod_opt_t * module_options);
+        int (*getxattr) (const char *path, const char *name, void *value, size_t size, aiori_mod_opt_t * module_options);
+        int (*listxattr) (const char *path, char *list, size_t size, aiori_mod_opt_t * module_options);
+        /* optional links, return -1 on error, readlink the length of the value otherwise */
+        int (*link) (const char *oldpath, const char *newpath, aiori_mod_opt_t * module_options);
+        int (*symlink) (const char *target, const char *linkpath, aiori_mod_opt_t * module_options);
+        int (*readlink) (const char *path, char *buf, size_t size, aiori_mod_opt_t * module_options);
         bool enable_mdtest;
 } ior_aiori_t;
 
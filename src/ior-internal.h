@@ -5,16 +5,27 @@
 #ifndef _IOR_INTERNAL_H
 #define _IOR_INTERNAL_H
 
+#include "utilities.h"
+
 /* Part of ior-output.c */
 void PrintHeader(int argc, char **argv);
 void ShowTestStart(IOR_param_t *params);
 void ShowTestEnd(IOR_test_t *tptr);
-void ShowSetup(IOR_param_t *params);
+void ShowSetup(IOR_param_t *params, const ior_placement_t *placement, const ior_memory_budget_t *budget);
+void PrintPeakMemory(size_t task, size_t node);
 void PrintRepeatEnd();
 void PrintRepeatStart();
 
 void PrintShortSummary(IOR_test_t * test);
 void PrintLongSummaryAllTests(IOR_test_t *tests_head);
+void PrintSweepSummary(IOR_test_t *tests_head);
+void PrintScalingSummary(IOR_test_t *tests_head);
+void PrintConcurrentSummary(IOR_test_t *tests_head);
+void PrintAutotuneTrial(IOR_param_t *params, int trial, double bw);
+void PrintResourceSummary(IOR_test_t *tests_head);
+void PrintPerfCounterSummary(IOR_test_t *tests_head);
+void PrintReorderDistances(const int *count, int levels);
+void PrintAutotuneResult(IOR_param_t *params, int trials, double elapsed, double bw, double ci);
 void PrintLongSummaryHeader();
 void PrintLongSummaryOneTest(IOR_test_t *test);
 void GetTestFileName(char *, IOR_param_t *);
@@ -96,7 +96,7 @@ static void PrintKeyValDouble(char * key, double value){
     return;
   }
   if(outputFormat == OUTPUT_JSON){
-    if(isinf(value)){
+    if(isinf(value) || isnan(value)){
       fprintf(out_resultfile, "\"%s\": \"%.4f\"", key, value);
     }else{
       fprintf(out_resultfile, "\"%s\": %.4f", key, value);
@@ -409,10 +409,50 @@ void ShowTestEnd(IOR_test_t *tptr){
   PrintEndSection();
 }
 
+/*
+ * Where the tasks run and where their buffers reside: every task in JSON,
+ * in the default format a summary and with -vv every task.
+ */
+static void PrintPlacement(IOR_param_t *params, const ior_placement_t *placement)
+{
+  if (outputFormat == OUTPUT_JSON){
+    PrintNamedArrayStart("Placement");
+    for (int i = 0; i < params->numTasks; i++){
+      PrintStartSection();
+      PrintKeyValInt("rank", i);
+      PrintKeyValInt("node", placement[i].node);
+      PrintKeyValInt("cpu", placement[i].cpu);
+      PrintKeyValInt("cpuNumaNode", placement[i].cpuNumaNode);
+      PrintKeyValInt("cpusAllowed", placement[i].cpusAllowed);
+      PrintKeyValInt("bufferNumaNode", placement[i].bufferNumaNode);
+      PrintEndSection();
+    }
+    PrintArrayEnd();
+    return;
+  }
+  int minCpus = placement[0].cpusAllowed, maxCpus = minCpus;
+  int bufferNode = placement[0].bufferNumaNode, sameNode = 0;
+  for (int i = 0; i < params->numTasks; i++){
+    minCpus = placement[i].cpusAllowed < minCpus ? placement[i].cpusAllowed : minCpus;
+    maxCpus = placement[i].cpusAllowed > maxCpus ? placement[i].cpusAllowed : maxCpus;
+    sameNode += placement[i].bufferNumaNode == bufferNode;
+    if (verbose >= VERBOSE_2){
+      fprintf(out_logfile, "task %d: node %d, cpu %d (NUMA node %d), %d CPUs allowed, buffer on NUMA node %d\n",
+              i, placement[i].node, placement[i].cpu, placement[i].cpuNumaNode,
+              placement[i].cpusAllowed, placement[i].bufferNumaNode);
+    }
+  }
+  fprintf(out_logfile, "cpus allowed        : %d - %d per task\n", minCpus, maxCpus);
+  if (sameNode == params->numTasks)
+    fprintf(out_logfile, "buffer NUMA node    : %d on all tasks\n", bufferNode);
+  else
+    fprintf(out_logfile, "buffer NUMA node    : %d on %d of %d tasks\n", bufferNode, sameNode, params->numTasks);
+}
+
 /*
  * Show simple test output with max results for iterations.
  */
-void ShowSetup(IOR_param_t *params)
+void ShowSetup(IOR_param_t *params, const ior_placement_t *placement, const ior_memory_budget_t *budget)
 {
   if (outputFormat == OUTPUT_CSV){
       return;
@@ -429,13 +469,18 @@ void ShowSetup(IOR_param_t *params)
   PrintKeyVal("type", params->collective ? "collective" : "independent");
   PrintKeyValInt("segments", params->segmentCount);
   PrintKeyVal("ordering in a file", params->randomOffset ? "random" : "sequential");
-  if (params->reorderTasks == FALSE && params->reorderTasksRandom == FALSE) {
+  if (params->reorderTasks == FALSE && params->reorderTasksRandom == FALSE && params->reorderTasksTopology == FALSE) {
     PrintKeyVal("ordering inter file", "no tasks offsets");
   }
   if (params->reorderTasks == TRUE) {
     PrintKeyVal("ordering inter file", "constant task offset");
     PrintKeyValInt("task offset", params->taskPerNodeOffset);
   }
+  if (params->reorderTasksTopology == TRUE) {
+    PrintKeyVal("ordering inter file", "topology distance");
+    if (params->topologyFile)
+      PrintKeyVal("topology file", params->topologyFile);
+  }
   if (params->reorderTasksRandom == TRUE) {
     PrintKeyVal("ordering inter file", "random task offset");
     PrintKeyValInt("task offset", params->taskPerNodeOffset);
@@ -450,10 +495,21 @@ void ShowSetup(IOR_param_t *params)
   if (params->memoryPerNode != 0){
     PrintKeyVal("memoryPerNode", HumanReadable(params->memoryPerNode, BASE_TWO));
   }
+  PrintKeyVal("memory/task", HumanReadable(budget->task, BASE_TWO));
+  PrintKeyVal("memory/node", HumanReadable(budget->node, BASE_TWO));
+  if (budget->available != 0){
+    PrintKeyVal("available/node", HumanReadable(budget->available, BASE_TWO));
+  }
   
   PrintKeyVal("memoryBuffer", params->gpuMemoryFlags == IOR_MEMORY_TYPE_CPU ? "CPU" :  params->gpuMemoryFlags == IOR_MEMORY_TYPE_GPU_DEVICE_ONLY ? "GPU" : "Managed");
   PrintKeyVal("dataAccess", params->gpuMemoryFlags > IOR_MEMORY_TYPE_GPU_MANAGED_CHECK_GPU ? "GPU" : "CPU");
   PrintKeyVal("GPUDirect", params->gpuDirect ? "1" : "0");
+  if (params->sharedPatternBuffer)
+    PrintKeyVal("patternBuffer", "shared per node");
+  if (params->cpuBind)
+    PrintKeyVal("cpuBind", params->cpuBind);
+  if (params->numaNode)
+    PrintKeyVal("numaNode", params->numaNode);
 
   PrintKeyValInt("repetitions", params->repetitions);
   PrintKeyVal("xfersize", HumanReadable(params->transferSize, BASE_TWO));
@@ -472,11 +528,32 @@ void ShowSetup(IOR_param_t *params)
   }
   PrintEndSection();
 
+  if (placement)
+    PrintPlacement(params, placement);
+
   PrintNamedArrayStart("Results");
 
   fflush(out_resultfile);
 }
 
+/*
+ * The largest peak resident set size of a task and of the tasks of a node.
+ */
+void PrintPeakMemory(size_t task, size_t node)
+{
+  if (rank != 0 || verbose < VERBOSE_0)
+    return;
+  if (outputFormat == OUTPUT_DEFAULT){
+    fprintf(out_resultfile, "Peak memory: %s per task, ", HumanReadable(task, BASE_TWO));
+    fprintf(out_resultfile, "%s per node\n", HumanReadable(node, BASE_TWO));
+  }else if (outputFormat == OUTPUT_JSON){
+    PrintNamedSectionStart("peakMemory");
+    PrintKeyValInt("task", task);
+    PrintKeyValInt("node", node);
+    PrintEndSection();
+  }
+}
+
 static struct results *bw_ops_values(const int reps, IOR_results_t *measured,
                                      IOR_offset_t transfer_size,
                                      const double *vals, const int access)
@@ -690,6 +767,98 @@ void PrintLongSummaryAllTests(IOR_test_t *tests_head)
   }
 
   PrintArrayEnd();
+
+  PrintSweepSummary(tests_head);
+  PrintScalingSummary(tests_head);
+  PrintConcurrentSummary(tests_head);
+  PrintResourceSummary(tests_head);
+  PrintPerfCounterSummary(tests_head);
+}
+
+/*
+ * Consolidated table of a parameter sweep, the swept parameters are columns
+ */
+static void PrintSweepOperation(IOR_test_t *test, const int access)
+{
+        IOR_results_t *results = test->results;
+        int reps = test->params.repetitions;
+        double * times = malloc(sizeof(double)* reps);
+        struct results *bw;
+
+        for(int i=0; i < reps; i++){
+                times[i] = (access == WRITE) ? results[i].write.time : results[i].read.time;
+        }
+        bw = bw_values(reps, results, times, access);
+        if(outputFormat == OUTPUT_DEFAULT){
+          fprintf(out_resultfile, "%10.2f %10.2f ", bw->max / MEBIBYTE, bw->mean / MEBIBYTE);
+        }else{
+          PrintKeyValDouble(access == WRITE ? "writeBwMaxMIB" : "readBwMaxMIB", bw->max / MEBIBYTE);
+          PrintKeyValDouble(access == WRITE ? "writeBwMeanMIB" : "readBwMeanMIB", bw->mean / MEBIBYTE);
+        }
+        free(bw);
+        free(times);
+}
+
+void PrintSweepSummary(IOR_test_t *tests_head)
+{
+  IOR_test_t *tptr;
+  int printedHeader = 0;
+
+  if (rank != 0 || verbose <= VERBOSE_0 || outputFormat == OUTPUT_CSV)
+          return;
+
+  for (tptr = tests_head; tptr != NULL; tptr = tptr->next) {
+    IOR_param_t *params = & tptr->params;
+    if(params->sweepDims == 0){
+      continue;
+    }
+    if(! printedHeader){
+      if(outputFormat == OUTPUT_DEFAULT){
+        fprintf(out_resultfile, "\nSummary of the parameter sweep:\n");
+        fprintf(out_resultfile, "%5s ", "Test#");
+        for(int d=0; d < params->sweepDims; d++){
+          fprintf(out_resultfile, "%14s ", params->sweep[d].key);
+        }
+        fprintf(out_resultfile, "%10s %10s %10s %10s\n", "wrMax(MiB)", "wrMean", "rdMax(MiB)", "rdMean");
+      }else{
+        PrintNamedArrayStart("sweep");
+      }
+      printedHeader = 1;
+    }
+
+    if(outputFormat == OUTPUT_DEFAULT){
+      fprintf(out_resultfile, "%5d ", params->id);
+      for(int d=0; d < params->sweepDims; d++){
+        fprintf(out_resultfile, "%14lld ", (long long) params->sweep[d].value);
+      }
+      if (params->writeFile){
+        PrintSweepOperation(tptr, WRITE);
+      }else{
+        fprintf(out_resultfile, "%10s %10s ", "NA", "NA");
+      }
+      if (params->readFile || params->checkRead){
+        PrintSweepOperation(tptr, READ);
+      }else{
+        fprintf(out_resultfile, "%10s %10s ", "NA", "NA");
+      }
+      fprintf(out_resultfile, "\n");
+    }else{
+      PrintStartSection();
+      PrintKeyValInt("TestID", params->id);
+      for(int d=0; d < params->sweepDims; d++){
+        PrintKeyValInt(params->sweep[d].key, params->sweep[d].value);
+      }
+      if (params->writeFile)
+        PrintSweepOperation(tptr, WRITE);
+      if (params->readFile || params->checkRead)
+        PrintSweepOperation(tptr, READ);
+      PrintEndSection();
+    }
+  }
+  if(printedHeader && outputFormat == OUTPUT_JSON){
+    PrintArrayEnd();
+  }
+  fflush(out_resultfile);
 }
 
 void PrintShortSummary(IOR_test_t * test)
@@ -798,3 +967,378 @@ static double mean_of_array_of_doubles(double *values, int len)
         return tot / len;
 
 }
+
+static double MeanBandwidth(IOR_test_t *test, const int access)
+{
+        IOR_results_t *results = test->results;
+        int reps = test->params.repetitions;
+        double * times = malloc(sizeof(double)* reps);
+        struct results *bw;
+        double mean;
+
+        for(int i=0; i < reps; i++){
+                times[i] = (access == WRITE) ? results[i].write.time : results[i].read.time;
+        }
+        bw = bw_values(reps, results, times, access);
+        mean = bw->mean;
+        free(bw);
+        free(times);
+        return mean;
+}
+
+/*
+ * Bandwidth and parallel efficiency of the tests selecting nodes.  The
+ * efficiency relates to the first test of the same configuration, usually
+ * the smallest node count: (bw / bw_base) / (nodes / nodes_base).
+ */
+void PrintScalingSummary(IOR_test_t *tests_head)
+{
+  IOR_test_t *tptr, *base;
+  int printedHeader = 0;
+
+  if (rank != 0 || verbose <= VERBOSE_0 || outputFormat == OUTPUT_CSV)
+          return;
+
+  for (tptr = tests_head; tptr != NULL; tptr = tptr->next) {
+    IOR_param_t *params = & tptr->params;
+    if(! params->selectNodes){
+      continue;
+    }
+    for (base = tests_head; base != tptr; base = base->next) {
+      IOR_param_t *b = & base->params;
+      if (b->selectNodes && b->transferSize == params->transferSize
+          && b->segmentCount == params->segmentCount
+          && b->strongScaling == params->strongScaling
+          && (b->strongScaling || b->blockSize == params->blockSize)
+          && b->backend == params->backend)
+        break;
+    }
+    if(! printedHeader){
+      if(outputFormat == OUTPUT_DEFAULT){
+        fprintf(out_resultfile, "\nSummary of the %s scaling study:\n", params->strongScaling ? "strong" : "weak");
+        fprintf(out_resultfile, "%5s %6s %6s %10s %10s %10s %10s\n", "Test#", "Nodes", "Tasks",
+                "write(MiB)", "efficiency", "read(MiB)", "efficiency");
+      }else{
+        PrintNamedArrayStart("scaling");
+      }
+      printedHeader = 1;
+    }
+
+    double ratio = (double) params->numNodes / base->params.numNodes;
+    if(outputFormat == OUTPUT_DEFAULT){
+      fprintf(out_resultfile, "%5d %6d %6d ", params->id, params->numNodes, params->numTasks);
+    }else{
+      PrintStartSection();
+      PrintKeyValInt("TestID", params->id);
+      PrintKeyValInt("numNodes", params->numNodes);
+      PrintKeyValInt("numTasks", params->numTasks);
+    }
+    for(int i = 0; i < 2; i++){
+      int access = i == 0 ? WRITE : READ;
+      int enabled = access == WRITE ? params->writeFile : (params->readFile || params->checkRead);
+      if(! enabled){
+        if(outputFormat == OUTPUT_DEFAULT)
+          fprintf(out_resultfile, "%10s %10s ", "NA", "NA");
+        continue;
+      }
+      double bw = MeanBandwidth(tptr, access);
+      double efficiency = bw / MeanBandwidth(base, access) / ratio;
+      if(outputFormat == OUTPUT_DEFAULT){
+        fprintf(out_resultfile, "%10.2f %10.3f ", bw / MEBIBYTE, efficiency);
+      }else{
+        PrintKeyValDouble(access == WRITE ? "writeBwMeanMIB" : "readBwMeanMIB", bw / MEBIBYTE);
+        PrintKeyValDouble(access == WRITE ? "writeEfficiency" : "readEfficiency", efficiency);
+      }
+    }
+    if(outputFormat == OUTPUT_DEFAULT){
+      fprintf(out_resultfile, "\n");
+    }else{
+      PrintEndSection();
+    }
+  }
+  if(printedHeader && outputFormat == OUTPUT_JSON){
+    PrintArrayEnd();
+  }
+  fflush(out_resultfile);
+}
+
+/*
+ * Tests that ran concurrently on disjoint ranks, the aggregate bandwidth of a
+ * set is the sum of the mean bandwidths of its tests.
+ */
+void PrintConcurrentSummary(IOR_test_t *tests_head)
+{
+  IOR_test_t *tptr;
+  double aggregate[2] = {0, 0};
+  int set = 0;
+
+  if (rank != 0 || verbose <= VERBOSE_0 || outputFormat == OUTPUT_CSV)
+          return;
+
+  for (tptr = tests_head; tptr != NULL; tptr = tptr->next) {
+    IOR_param_t *params = & tptr->params;
+    if(params->concurrentGroup < 0){
+      continue;
+    }
+    if(params->concurrentGroup == 0){
+      set++;
+      aggregate[0] = aggregate[1] = 0;
+      if(outputFormat == OUTPUT_DEFAULT){
+        fprintf(out_resultfile, "\nSummary of concurrent tests (set %d):\n", set);
+        fprintf(out_resultfile, "%5s %5s %9s %6s %10s %10s %8s\n", "Group", "Test#", "firstRank",
+                "Tasks", "write(MiB)", "read(MiB)", "API");
+      }else if(set == 1){
+        PrintNamedArrayStart("concurrent");
+      }
+    }
+    if(outputFormat == OUTPUT_DEFAULT){
+      fprintf(out_resultfile, "%5d %5d %9d %6d ", params->concurrentGroup, params->id,
+              params->firstRank, params->numTasks);
+    }else{
+      PrintStartSection();
+      PrintKeyValInt("set", set);
+      PrintKeyValInt("group", params->concurrentGroup);
+      PrintKeyValInt("TestID", params->id);
+      PrintKeyValInt("firstRank", params->firstRank);
+      PrintKeyValInt("numTasks", params->numTasks);
+      PrintKeyVal("API", params->api);
+    }
+    for(int i = 0; i < 2; i++){
+      int access = i == 0 ? WRITE : READ;
+      int enabled = access == WRITE ? params->writeFile : (params->readFile || params->checkRead);
+      if(! enabled){
+        if(outputFormat == OUTPUT_DEFAULT)
+          fprintf(out_resultfile, "%10s ", "NA");
+        continue;
+      }
+      double bw = MeanBandwidth(tptr, access);
+      aggregate[i] += bw;
+      if(outputFormat == OUTPUT_DEFAULT){
+        fprintf(out_resultfile, "%10.2f ", bw / MEBIBYTE);
+      }else{
+        PrintKeyValDouble(access == WRITE ? "writeBwMeanMIB" : "readBwMeanMIB", bw / MEBIBYTE);
+      }
+    }
+    if(outputFormat == OUTPUT_DEFAULT){
+      fprintf(out_resultfile, "%8s\n", params->api);
+      if(tptr->next == NULL || ! tptr->next->params.concurrent){
+        fprintf(out_resultfile, "%5s %5s %9s %6s %10.2f %10.2f\n", "all", "", "", "",
+                aggregate[0] / MEBIBYTE, aggregate[1] / MEBIBYTE);
+      }
+    }else{
+      PrintEndSection();
+    }
+  }
+  if(set > 0 && outputFormat == OUTPUT_JSON){
+    PrintArrayEnd();
+  }
+  fflush(out_resultfile);
+}
+
+/*
+ * Resources the phases used, summed over the tasks and repetitions: CPU time
+ * per GiB moved, system calls, context switches and faults per transfer and
+ * the bytes sent to storage and network per byte written (or read) by IOR.
+ */
+void PrintResourceSummary(IOR_test_t *tests_head)
+{
+  IOR_test_t *tptr;
+  int printed = 0;
+
+  if (rank != 0 || verbose <= VERBOSE_0 || outputFormat == OUTPUT_CSV)
+          return;
+
+  for (tptr = tests_head; tptr != NULL; tptr = tptr->next) {
+    IOR_param_t *params = & tptr->params;
+    if (params->resourceAccounting <= 0)
+      continue;
+    for (int i = 0; i < 2; i++) {
+      int access = i == 0 ? WRITE : READ;
+      int enabled = access == WRITE ? params->writeFile : (params->readFile || params->checkRead);
+      double res[IOR_NB_RES] = {0};
+      double bytes = 0;
+      if (! enabled)
+        continue;
+      for (int rep = 0; rep < params->repetitions; rep++) {
+        IOR_point_t *point = access == WRITE ? & tptr->results[rep].write : & tptr->results[rep].read;
+        for (int k = 0; k < IOR_NB_RES; k++)
+          res[k] += point->resources[k];
+        bytes += point->aggFileSizeForBW;
+      }
+      if (bytes <= 0)
+        continue;
+      double ops = bytes / params->transferSize;
+      double cpu = res[IOR_RES_CPU_USER] + res[IOR_RES_CPU_SYS];
+      double rwcalls = res[IOR_RES_SYSCR] + res[IOR_RES_SYSCW];
+      double ctxsw = res[IOR_RES_VOL_CTXSW] + res[IOR_RES_INVOL_CTXSW];
+      double faults = res[IOR_RES_MINFLT] + res[IOR_RES_MAJFLT];
+      /* the disks of the nodes if sampled, else what the tasks sent to storage */
+      double device = params->resourceAccounting >= 2 ?
+        res[access == WRITE ? IOR_RES_DISK_WRITE : IOR_RES_DISK_READ] :
+        res[access == WRITE ? IOR_RES_WRITE_BYTES : IOR_RES_READ_BYTES];
+      double net = res[access == WRITE ? IOR_RES_NET_TX : IOR_RES_NET_RX];
+
+      if (outputFormat == OUTPUT_DEFAULT) {
+        if (! printed) {
+          fprintf(out_resultfile, "\nResource usage (summed over tasks and repetitions):\n");
+          fprintf(out_resultfile, "%-9s %5s %12s %15s %10s %10s %10s %10s\n", "Operation", "Test#",
+                  "CPU(s)/GiB", "rw syscalls/op", "ctxsw/op", "faults/op", "dev/app", "net/app");
+        }
+        fprintf(out_resultfile, "%-9s %5d %12.3f %15.2f %10.2f %10.2f %10.3f ", access == WRITE ? "write" : "read",
+                params->id, cpu / (bytes / GIBIBYTE), rwcalls / ops, ctxsw / ops, faults / ops, device / bytes);
+        if (params->resourceAccounting >= 2)
+          fprintf(out_resultfile, "%10.3f\n", net / bytes);
+        else
+          fprintf(out_resultfile, "%10s\n", "NA");
+      } else {
+        if (! printed)
+          PrintNamedArrayStart("resources");
+        PrintStartSection();
+        PrintKeyVal("operation", access == WRITE ? "write" : "read");
+        PrintKeyValInt("TestID", params->id);
+        for (int k = 0; k < IOR_NB_RES; k++) {
+          if (k >= IOR_RES_DISK_READ && params->resourceAccounting < 2)
+            break;
+          PrintKeyValDouble((char *) ResourceNames[k], res[k]);
+        }
+        PrintKeyValDouble("cpuSecondsPerGiB", cpu / (bytes / GIBIBYTE));
+        PrintKeyValDouble("rwSyscallsPerOp", rwcalls / ops);
+        PrintKeyValDouble("ctxSwitchesPerOp", ctxsw / ops);
+        PrintKeyValDouble("faultsPerOp", faults / ops);
+        PrintKeyValDouble("deviceBytesPerAppByte", device / bytes);
+        if (params->resourceAccounting >= 2)
+          PrintKeyValDouble("netBytesPerAppByte", net / bytes);
+        PrintEndSection();
+      }
+      printed = 1;
+    }
+  }
+  if (printed && outputFormat == OUTPUT_JSON)
+    PrintArrayEnd();
+  fflush(out_resultfile);
+}
+
+/* a counter ratio, NA if a counter was not available */
+static void PrintCounterRatio(double value, int precision)
+{
+  if (isnan(value) || isinf(value))
+    fprintf(out_resultfile, " %12s", "NA");
+  else
+    fprintf(out_resultfile, " %12.*f", precision, value);
+}
+
+/*
+ * Hardware events while transferring data, summed over the tasks and
+ * repetitions: cycles and instructions per byte moved, the instructions per
+ * cycle and the last level cache and data TLB misses per transfer.
+ */
+void PrintPerfCounterSummary(IOR_test_t *tests_head)
+{
+  IOR_test_t *tptr;
+  int printed = 0;
+
+  if (rank != 0 || verbose <= VERBOSE_0 || outputFormat == OUTPUT_CSV)
+          return;
+
+  for (tptr = tests_head; tptr != NULL; tptr = tptr->next) {
+    IOR_param_t *params = & tptr->params;
+    if (! params->perfCounters)
+      continue;
+    for (int i = 0; i < 2; i++) {
+      int access = i == 0 ? WRITE : READ;
+      int enabled = access == WRITE ? params->writeFile : (params->readFile || params->checkRead);
+      double perf[IOR_NB_PERF] = {0};
+      double bytes = 0;
+      if (! enabled)
+        continue;
+      for (int rep = 0; rep < params->repetitions; rep++) {
+        IOR_point_t *point = access == WRITE ? & tptr->results[rep].write : & tptr->results[rep].read;
+        for (int k = 0; k < IOR_NB_PERF; k++)
+          perf[k] += point->perf[k];
+        bytes += point->aggFileSizeForBW;
+      }
+      if (bytes <= 0)
+        continue;
+      double ops = bytes / params->transferSize;
+
+      if (outputFormat == OUTPUT_DEFAULT) {
+        if (! printed) {
+          fprintf(out_resultfile, "\nHardware counters while transferring (summed over tasks and repetitions):\n");
+          fprintf(out_resultfile, "%-9s %5s %12s %12s %12s %12s %12s %12s\n", "Operation", "Test#",
+                  "cycles/B", "instr/B", "IPC", "LLC-miss%", "LLC-miss/op", "dTLB-miss/op");
+        }
+        fprintf(out_resultfile, "%-9s %5d", access == WRITE ? "write" : "read", params->id);
+        PrintCounterRatio(perf[IOR_PERF_CYCLES] / bytes, 4);
+        PrintCounterRatio(perf[IOR_PERF_INSTRUCTIONS] / bytes, 4);
+        PrintCounterRatio(perf[IOR_PERF_INSTRUCTIONS] / perf[IOR_PERF_CYCLES], 2);
+        PrintCounterRatio(100.0 * perf[IOR_PERF_CACHE_MISSES] / perf[IOR_PERF_CACHE_REFS], 2);
+        PrintCounterRatio(perf[IOR_PERF_CACHE_MISSES] / ops, 1);
+        PrintCounterRatio(perf[IOR_PERF_DTLB_MISSES] / ops, 1);
+        fprintf(out_resultfile, "\n");
+      } else {
+        if (! printed)
+          PrintNamedArrayStart("perfCounters");
+        PrintStartSection();
+        PrintKeyVal("operation", access == WRITE ? "write" : "read");
+        PrintKeyValInt("TestID", params->id);
+        for (int k = 0; k < IOR_NB_PERF; k++)
+          PrintKeyValDouble((char *) PerfCounterNames[k], perf[k]);
+        PrintKeyValDouble("cyclesPerByte", perf[IOR_PERF_CYCLES] / bytes);
+        PrintKeyValDouble("instructionsPerCycle", perf[IOR_PERF_INSTRUCTIONS] / perf[IOR_PERF_CYCLES]);
+        PrintKeyValDouble("cacheMissesPerOp", perf[IOR_PERF_CACHE_MISSES] / ops);
+        PrintKeyValDouble("dtlbLoadMissesPerOp", perf[IOR_PERF_DTLB_MISSES] / ops);
+        PrintEndSection();
+      }
+      printed = 1;
+    }
+  }
+  if (printed && outputFormat == OUTPUT_JSON)
+    PrintArrayEnd();
+  fflush(out_resultfile);
+}
+
+/*
+ * Distribution of the distance between writer and reader of reordered tasks.
+ */
+void PrintReorderDistances(const int *count, int levels)
+{
+        static const char *names[] = {"node", "switch", "rack", "remote"};
+
+        if (outputFormat != OUTPUT_DEFAULT || verbose < VERBOSE_0)
+                return;
+        fprintf(out_logfile, "reorder distance    :");
+        for (int i = 0; i < levels; i++)
+                fprintf(out_logfile, " %s %d%s", names[i], count[i], i < levels - 1 ? "," : "");
+        fprintf(out_logfile, "\n");
+        fflush(out_logfile);
+}
+
+/*
+ * Progress of the autotune search and its final result.
+ */
+void PrintAutotuneTrial(IOR_param_t *params, int trial, double bw)
+{
+        if (outputFormat != OUTPUT_DEFAULT || verbose < VERBOSE_0)
+                return;
+        fprintf(out_logfile, "autotune trial %d:", trial);
+        for (int d = 0; d < params->tuneDims; d++)
+                fprintf(out_logfile, " %s=%lld", params->tune[d].key, (long long) params->tune[d].value);
+        fprintf(out_logfile, " -> %.2f MiB/s\n", bw / MEBIBYTE);
+        fflush(out_logfile);
+}
+
+void PrintAutotuneResult(IOR_param_t *params, int trials, double elapsed, double bw, double ci)
+{
+        if (outputFormat == OUTPUT_CSV)
+                return;
+        PrintNamedSectionStart("autotune");
+        PrintKeyValInt("trials", trials);
+        PrintKeyValDouble("searchTime", elapsed);
+        for (int d = 0; d < params->tuneDims; d++)
+                PrintKeyValInt(params->tune[d].key, params->tune[d].value);
+        PrintKeyValInt("repetitions", params->repetitions);
+        PrintKeyValDouble("bwMeanMIB", bw / MEBIBYTE);
+        PrintKeyValDouble("bwConfidence95MIB", ci / MEBIBYTE);
+        PrintEndSection();
+        fflush(out_resultfile);
+}
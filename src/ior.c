@@ -55,9 +55,60 @@ enum {
         IOR_NB_TIMERS
 };
 
+/*
+ * The scalars of a finished phase are combined across all tasks with a single
+ * collective.  A floating point value keeps the min, max, mean and the sum of
+ * squared deviations from the mean, tasks are merged pairwise which remains
+ * accurate for absolute timestamps; an integer value keeps min, max and sum.
+ */
+enum {
+        IOR_STAT_OPEN_TIME = IOR_NB_TIMERS,
+        IOR_STAT_RDWR_TIME,
+        IOR_STAT_CLOSE_TIME,
+        IOR_STAT_LATENCY,
+        IOR_NB_STATS
+};
+
+enum {
+        IOR_ISTAT_FILE_SIZE,
+        IOR_ISTAT_DATA_MOVED,
+        IOR_ISTAT_PAIRS,
+        IOR_NB_ISTATS
+};
+
+typedef struct {
+        double count;
+        double mean;
+        double m2;
+        double min;
+        double max;
+} ior_stat_t;
+
+typedef struct {
+        long long min;
+        long long max;
+        long long sum;
+} ior_istat_t;
+
+typedef struct {
+        ior_stat_t val[IOR_NB_STATS];
+        ior_istat_t ival[IOR_NB_ISTATS];
+        double res[IOR_NB_RES]; /* summed over the tasks */
+        double perf[IOR_NB_PERF]; /* summed over the tasks */
+} ior_phase_stats_t;
+
 /* file scope globals */
 extern char **environ;
 static int totalErrorCount;
+static int nodeIndex;                   /* index of the node of this task */
+/* result of the search, printed after the summary */
+static struct {
+        IOR_test_t *best;
+        int trials;
+        double elapsed;
+        double bw;
+        double ci;
+} autotuneResult;
 static const ior_aiori_t *backend;
 
 static void DestroyTests(IOR_test_t *tests_head);
@@ -65,6 +116,10 @@ static char *PrependDir(IOR_param_t *, char *);
 static char **ParseFileName(char *, int *);
 static void InitTests(IOR_test_t *);
 static void TestIoSys(IOR_test_t *);
+static void XferBuffersRelease(void);
+static IOR_test_t *Autotune(IOR_test_t *);
+static IOR_test_t *RunConcurrentTests(IOR_test_t *);
+static void ConcurrentPhaseSync(void);
 static void ValidateTests(IOR_param_t * params, MPI_Comm com);
 static IOR_offset_t WriteOrRead(IOR_param_t *test, int rep, IOR_results_t *results,
                                 aiori_fd_t *fd, const int access,
@@ -92,26 +147,55 @@ static void ior_set_xfer_hints(IOR_param_t * p){
 
 int aiori_warning_as_errors = 0;
 
+/*
+ * Consecutive points of a parameter sweep that run on the same tasks with the
+ * same backend options keep the backend initialized.
+ */
+static int test_shares_backend(IOR_test_t * prev, IOR_test_t * test){
+  if(prev == NULL || test == NULL || test->params.sweepDims == 0){
+    return 0;
+  }
+  if(prev->params.concurrentGroup >= 0 || test->params.concurrentGroup >= 0){
+    return 0;
+  }
+  return prev->params.backend == test->params.backend
+      && prev->params.backend_options == test->params.backend_options
+      && prev->params.numTasks == test->params.numTasks;
+}
+
 /*
  Returns 1 if the process participates in the test
  */
-static int test_initialize(IOR_test_t * test){
+static int test_initialize(IOR_test_t * test, IOR_test_t * prev){
   int range[3];
   IOR_param_t *params = &test->params;
   MPI_Group orig_group, new_group;
 
   /* set up communicator for test */
-  MPI_CHECK(MPI_Comm_group(params->mpi_comm_world, &orig_group),
-            "MPI_Comm_group() error");
-  range[0] = 0;                     /* first rank */
-  range[1] = params->numTasks - 1;  /* last rank */
-  range[2] = 1;                     /* stride */
-  MPI_CHECK(MPI_Group_range_incl(orig_group, 1, &range, &new_group),
-            "MPI_Group_range_incl() error");
-  MPI_CHECK(MPI_Comm_create(params->mpi_comm_world, new_group, & params->testComm),
-            "MPI_Comm_create() error");
-  MPI_CHECK(MPI_Group_free(&orig_group), "MPI_Group_Free() error");
-  MPI_CHECK(MPI_Group_free(&new_group), "MPI_Group_Free() error");
+  if (params->selectNodes) {
+    /* all tasks of the first numNodes nodes, the others are parked */
+    MPI_CHECK(MPI_Comm_split(params->mpi_comm_world, nodeIndex < params->numNodes ? 0 : MPI_UNDEFINED,
+                             0, & params->testComm), "MPI_Comm_split() error");
+  } else if (params->concurrentGroup >= 0) {
+    /* tests of a concurrent set run on disjoint ranges of ranks */
+    int worldRank;
+    MPI_CHECK(MPI_Comm_rank(params->mpi_comm_world, &worldRank), "cannot get rank");
+    int member = worldRank >= params->firstRank && worldRank < params->firstRank + params->numTasks;
+    MPI_CHECK(MPI_Comm_split(params->mpi_comm_world, member ? params->concurrentGroup : MPI_UNDEFINED,
+                             0, & params->testComm), "MPI_Comm_split() error");
+  } else {
+    MPI_CHECK(MPI_Comm_group(params->mpi_comm_world, &orig_group),
+              "MPI_Comm_group() error");
+    range[0] = 0;                     /* first rank */
+    range[1] = params->numTasks - 1;  /* last rank */
+    range[2] = 1;                     /* stride */
+    MPI_CHECK(MPI_Group_range_incl(orig_group, 1, &range, &new_group),
+              "MPI_Group_range_incl() error");
+    MPI_CHECK(MPI_Comm_create(params->mpi_comm_world, new_group, & params->testComm),
+              "MPI_Comm_create() error");
+    MPI_CHECK(MPI_Group_free(&orig_group), "MPI_Group_Free() error");
+    MPI_CHECK(MPI_Group_free(&new_group), "MPI_Group_Free() error");
+  }
 
 
   if (params->testComm == MPI_COMM_NULL) {
@@ -122,6 +206,8 @@ static int test_initialize(IOR_test_t * test){
 
   /* Setup global variables */
   testComm = params->testComm;
+  /* the selected tasks need not be the first ranks, data is laid out by the test rank */
+  MPI_CHECK(MPI_Comm_rank(testComm, &rank), "cannot get rank");
   verbose = test->params.verbose;
   backend = test->params.backend;
 
@@ -130,7 +216,7 @@ static int test_initialize(IOR_test_t * test){
   }
   
 
-  if(backend->initialize){
+  if(backend->initialize && ! test_shares_backend(prev, test)){
     backend->initialize(test->params.backend_options);
   }
   ior_set_xfer_hints(& test->params);
@@ -142,19 +228,21 @@ static int test_initialize(IOR_test_t * test){
   return 1;
 }
 
-static void test_finalize(IOR_test_t * test){
+static void test_finalize(IOR_test_t * test, IOR_test_t * next){
   backend = test->params.backend;
-  if(backend->finalize){
+  if(backend->finalize && ! test_shares_backend(test, next)){
     backend->finalize(test->params.backend_options);
   }
   MPI_CHECK(MPI_Barrier(test->params.mpi_comm_world), "barrier error");
   MPI_CHECK(MPI_Comm_free(& testComm), "MPI_Comm_free() error");
+  MPI_CHECK(MPI_Comm_rank(test->params.mpi_comm_world, &rank), "cannot get rank");
 }
 
 
 IOR_test_t * ior_run(int argc, char **argv, MPI_Comm world_com, FILE * world_out){
         IOR_test_t *tests_head;
         IOR_test_t *tptr;
+        IOR_test_t *prev = NULL;
         out_logfile = world_out;
         out_resultfile = world_out;
 
@@ -166,18 +254,31 @@ IOR_test_t * ior_run(int argc, char **argv, MPI_Comm world_com, FILE * world_out
 
         PrintHeader(argc, argv);
 
-        /* perform each test */
-        for (tptr = tests_head; tptr != NULL; tptr = tptr->next) {
-                int participate = test_initialize(tptr);
-                if( ! participate ) continue;
-                totalErrorCount = 0;
-                TestIoSys(tptr);
-                tptr->results->errors = totalErrorCount;
-                ShowTestEnd(tptr);
-                test_finalize(tptr);
+        if (tests_head->params.autotune) {
+                tests_head = Autotune(tests_head);
+        } else {
+                /* perform each test */
+                for (tptr = tests_head; tptr != NULL; prev = tptr, tptr = tptr->next) {
+                        if (tptr->params.concurrentGroup == 0) {
+                                tptr = RunConcurrentTests(tptr);
+                                continue;
+                        }
+                        int participate = test_initialize(tptr, prev);
+                        if( ! participate ) continue;
+                        totalErrorCount = 0;
+                        TestIoSys(tptr);
+                        tptr->results->errors = totalErrorCount;
+                        ShowTestEnd(tptr);
+                        test_finalize(tptr, tptr->next);
+                }
         }
+        XferBuffersRelease();
+        aligned_buffer_pool_release();
 
         PrintLongSummaryAllTests(tests_head);
+        if (autotuneResult.best != NULL && rank == 0)
+                PrintAutotuneResult(&autotuneResult.best->params, autotuneResult.trials,
+                                    autotuneResult.elapsed, autotuneResult.bw, autotuneResult.ci);
 
         /* display finish time */
         PrintTestEnds();
@@ -190,6 +291,7 @@ int ior_main(int argc, char **argv)
 {
     IOR_test_t *tests_head;
     IOR_test_t *tptr;
+    IOR_test_t *prev = NULL;
 
     out_logfile = stdout;
     out_resultfile = stdout;
@@ -213,9 +315,16 @@ int ior_main(int argc, char **argv)
 
     PrintHeader(argc, argv);
 
-    /* perform each test */
-    for (tptr = tests_head; tptr != NULL; tptr = tptr->next) {
-            int participate = test_initialize(tptr);
+    if (tests_head->params.autotune) {
+        tests_head = Autotune(tests_head);
+    } else {
+        /* perform each test */
+        for (tptr = tests_head; tptr != NULL; prev = tptr, tptr = tptr->next) {
+            if (tptr->params.concurrentGroup == 0) {
+                    tptr = RunConcurrentTests(tptr);
+                    continue;
+            }
+            int participate = test_initialize(tptr, prev);
             if( ! participate ) continue;
 
             // This is useful for trapping a running MPI process.  While
@@ -228,13 +337,19 @@ int ior_main(int argc, char **argv)
 
             TestIoSys(tptr);
             ShowTestEnd(tptr);
-            test_finalize(tptr);
+            test_finalize(tptr, tptr->next);
+        }
     }
+    XferBuffersRelease();
+    aligned_buffer_pool_release();
 
     if (verbose <= VERBOSE_0)
             /* always print final summary */
             verbose = VERBOSE_1;
     PrintLongSummaryAllTests(tests_head);
+    if (autotuneResult.best != NULL && rank == 0)
+            PrintAutotuneResult(&autotuneResult.best->params, autotuneResult.trials,
+                                autotuneResult.elapsed, autotuneResult.bw, autotuneResult.ci);
 
     /* display finish time */
     PrintTestEnds();
@@ -287,31 +402,145 @@ void init_IOR_Param_t(IOR_param_t * p, MPI_Comm com)
         p->testComm = com; // this com might change for smaller tests
         p->mpi_comm_world = com;
 
+        p->concurrentGroup = -1;
+
+        p->autotuneBudget = 300;
+        p->autotuneTrialTime = 5;
+        p->autotuneRepetitions = 5;
+
         p->URI = NULL;
 }
 
+static MPI_Datatype phaseStatsType = MPI_DATATYPE_NULL;
+static MPI_Op phaseStatsOp = MPI_OP_NULL;
+
+static void PhaseStatsSet(ior_phase_stats_t *stats, int i, double value)
+{
+        ior_stat_t *s = &stats->val[i];
+
+        s->count = 1;
+        s->mean = value;
+        s->m2 = 0;
+        s->min = value;
+        s->max = value;
+}
+
+static void PhaseStatsSetInt(ior_phase_stats_t *stats, int i, long long value)
+{
+        ior_istat_t *s = &stats->ival[i];
+
+        s->min = value;
+        s->max = value;
+        s->sum = value;
+}
+
+static void PhaseStatsMerge(void *invec, void *inoutvec, int *len, MPI_Datatype *type)
+{
+        ior_phase_stats_t *in = invec;
+        ior_phase_stats_t *inout = inoutvec;
+
+        for (int n = 0; n < *len; n++, in++, inout++) {
+                for (int i = 0; i < IOR_NB_STATS; i++) {
+                        ior_stat_t *a = &inout->val[i];
+                        ior_stat_t *b = &in->val[i];
+                        if (b->count == 0)
+                                continue;
+                        if (a->count == 0) {
+                                *a = *b;
+                                continue;
+                        }
+                        double count = a->count + b->count;
+                        double delta = b->mean - a->mean;
+                        a->mean += delta * b->count / count;
+                        a->m2 += b->m2 + delta * delta * a->count * b->count / count;
+                        a->count = count;
+                        a->min = b->min < a->min ? b->min : a->min;
+                        a->max = b->max > a->max ? b->max : a->max;
+                }
+                for (int i = 0; i < IOR_NB_ISTATS; i++) {
+                        ior_istat_t *a = &inout->ival[i];
+                        ior_istat_t *b = &in->ival[i];
+                        a->min = b->min < a->min ? b->min : a->min;
+                        a->max = b->max > a->max ? b->max : a->max;
+                        a->sum += b->sum;
+                }
+                for (int i = 0; i < IOR_NB_RES; i++)
+                        inout->res[i] += in->res[i];
+                for (int i = 0; i < IOR_NB_PERF; i++)
+                        inout->perf[i] += in->perf[i];
+        }
+}
+
+/*
+ * Combine the statistics of all tasks, the result is available on all tasks.
+ */
+static void PhaseStatsAllreduce(ior_phase_stats_t *stats, MPI_Comm comm)
+{
+        ior_phase_stats_t local = *stats;
+
+        if (phaseStatsOp == MPI_OP_NULL) {
+                MPI_CHECK(MPI_Type_contiguous(sizeof(ior_phase_stats_t), MPI_BYTE, &phaseStatsType),
+                          "cannot create datatype");
+                MPI_CHECK(MPI_Type_commit(&phaseStatsType), "cannot commit datatype");
+                MPI_CHECK(MPI_Op_create(PhaseStatsMerge, 1, &phaseStatsOp), "cannot create operation");
+        }
+        MPI_CHECK(MPI_Allreduce(&local, stats, 1, phaseStatsType, phaseStatsOp, comm),
+                  "cannot reduce phase statistics");
+}
+
+/*
+ * Collect the scalars of a finished phase from all tasks, the resources used
+ * since resStart and the hardware events are summed into the results when
+ * resourceAccounting and perfCounters are set.
+ */
+static void GatherPhaseStats(IOR_test_t *test, char *testFilename, const double *timer,
+                             IOR_offset_t dataMoved, const int rep, const int access,
+                             double *res, const double *resStart, const double *perf,
+                             ior_phase_stats_t *stats)
+{
+        IOR_param_t *params = &test->params;
+        IOR_point_t *point = (access == WRITE) ? &test->results[rep].write :
+                                                 &test->results[rep].read;
+        int i;
+
+        memset(stats, 0, sizeof(*stats));
+        for (i = 0; i < IOR_NB_TIMERS; i++)
+                PhaseStatsSet(stats, i, timer[i]);
+        PhaseStatsSet(stats, IOR_STAT_OPEN_TIME, timer[IOR_TIMER_OPEN_STOP] - timer[IOR_TIMER_OPEN_START]);
+        PhaseStatsSet(stats, IOR_STAT_RDWR_TIME, timer[IOR_TIMER_RDWR_STOP] - timer[IOR_TIMER_RDWR_START]);
+        PhaseStatsSet(stats, IOR_STAT_CLOSE_TIME, timer[IOR_TIMER_CLOSE_STOP] - timer[IOR_TIMER_CLOSE_START]);
+        /* the average latency of all ops of this task */
+        PhaseStatsSet(stats, IOR_STAT_LATENCY,
+                      (timer[IOR_TIMER_RDWR_STOP] - timer[IOR_TIMER_RDWR_START]) / point->pairs_accessed);
+        PhaseStatsSetInt(stats, IOR_ISTAT_FILE_SIZE,
+                         backend->get_file_size(params->backend_options, testFilename));
+        PhaseStatsSetInt(stats, IOR_ISTAT_DATA_MOVED, dataMoved);
+        if (params->resourceAccounting > 0) {
+                ResourcesDelta(res, resStart);
+                memcpy(stats->res, res, sizeof(stats->res));
+        }
+        if (params->perfCounters)
+                memcpy(stats->perf, perf, sizeof(stats->perf));
+
+        PhaseStatsAllreduce(stats, testComm);
+        if (params->resourceAccounting > 0)
+                memcpy(point->resources, stats->res, sizeof(point->resources));
+        if (params->perfCounters)
+                memcpy(point->perf, stats->perf, sizeof(point->perf));
+}
+
 static void
-DisplayOutliers(int numTasks,
+DisplayOutliers(const ior_stat_t *stat,
                 double timerVal,
                 char *timeString, int access, int outlierThreshold)
 {
         char accessString[MAX_STR];
-        double sum, mean, sqrDiff, var, sd;
+        double mean = stat->mean;
+        double sd = sqrt(stat->m2 / stat->count);
 
         /* for local timerVal, don't compensate for wall clock delta */
         //timerVal += wall_clock_delta;
 
-        MPI_CHECK(MPI_Allreduce
-                  (&timerVal, &sum, 1, MPI_DOUBLE, MPI_SUM, testComm),
-                  "MPI_Allreduce()");
-        mean = sum / numTasks;
-        sqrDiff = pow((mean - timerVal), 2);
-        MPI_CHECK(MPI_Allreduce
-                  (&sqrDiff, &var, 1, MPI_DOUBLE, MPI_SUM, testComm),
-                  "MPI_Allreduce()");
-        var = var / numTasks;
-        sd = sqrt(var);
-
         if (access == WRITE) {
                 strcpy(accessString, "write");
         } else {                /* READ */
@@ -332,21 +561,22 @@ DisplayOutliers(int numTasks,
  * Check for outliers in start/end times and elapsed create/xfer/close times.
  */
 static void
-CheckForOutliers(IOR_param_t *test, const double *timer, const int access)
+CheckForOutliers(IOR_param_t *test, const double *timer, const ior_phase_stats_t *stats,
+                 const int access)
 {
-        DisplayOutliers(test->numTasks, timer[IOR_TIMER_OPEN_START],
+        DisplayOutliers(&stats->val[IOR_TIMER_OPEN_START], timer[IOR_TIMER_OPEN_START],
                         "start time", access, test->outlierThreshold);
-        DisplayOutliers(test->numTasks,
+        DisplayOutliers(&stats->val[IOR_STAT_OPEN_TIME],
                         timer[IOR_TIMER_OPEN_STOP] - timer[IOR_TIMER_OPEN_START],
                         "elapsed create time", access, test->outlierThreshold);
-        DisplayOutliers(test->numTasks,
+        DisplayOutliers(&stats->val[IOR_STAT_RDWR_TIME],
                         timer[IOR_TIMER_RDWR_STOP] - timer[IOR_TIMER_RDWR_START],
                         "elapsed transfer time", access,
                         test->outlierThreshold);
-        DisplayOutliers(test->numTasks,
+        DisplayOutliers(&stats->val[IOR_STAT_CLOSE_TIME],
                         timer[IOR_TIMER_CLOSE_STOP] - timer[IOR_TIMER_CLOSE_START],
                         "elapsed close time", access, test->outlierThreshold);
-        DisplayOutliers(test->numTasks, timer[IOR_TIMER_CLOSE_STOP], "end time",
+        DisplayOutliers(&stats->val[IOR_TIMER_CLOSE_STOP], timer[IOR_TIMER_CLOSE_STOP], "end time",
                         access, test->outlierThreshold);
 }
 
@@ -354,42 +584,32 @@ CheckForOutliers(IOR_param_t *test, const double *timer, const int access)
  * Check if actual file size equals expected size; if not use actual for
  * calculating performance rate.
  */
-static void CheckFileSize(IOR_test_t *test, char * testFilename, IOR_offset_t dataMoved, int rep, const int access)
+static void CheckFileSize(IOR_test_t *test, const ior_phase_stats_t *stats, int rep, const int access)
 {
         IOR_param_t *params = &test->params;
         IOR_results_t *results = test->results;
         IOR_point_t *point = (access == WRITE) ? &results[rep].write :
                                                  &results[rep].read;
+        const ior_istat_t *fileSize = &stats->ival[IOR_ISTAT_FILE_SIZE];
 
-        /* get the size of the file */
-        IOR_offset_t aggFileSizeFromStat, tmpMin, tmpMax, tmpSum;
-        aggFileSizeFromStat = backend->get_file_size(params->backend_options,  testFilename);
+        /* the size of the file as seen by the tasks */
+        IOR_offset_t aggFileSizeFromStat;
 
         if (params->hints.filePerProc == TRUE) {
-            MPI_CHECK(MPI_Allreduce(&aggFileSizeFromStat, &tmpSum, 1,
-                                    MPI_LONG_LONG_INT, MPI_SUM, testComm),
-                      "cannot reduce total data moved");
-            aggFileSizeFromStat = tmpSum;
+            aggFileSizeFromStat = fileSize->sum;
         } else {
-            MPI_CHECK(MPI_Allreduce(&aggFileSizeFromStat, &tmpMin, 1,
-                                    MPI_LONG_LONG_INT, MPI_MIN, testComm),
-                      "cannot reduce total data moved");
-            MPI_CHECK(MPI_Allreduce(&aggFileSizeFromStat, &tmpMax, 1,
-                                    MPI_LONG_LONG_INT, MPI_MAX, testComm),
-                      "cannot reduce total data moved");
-            if (tmpMin != tmpMax) {
+            aggFileSizeFromStat = fileSize->max;
+            if (fileSize->min != fileSize->max) {
                     if (rank == 0) {
                             WARN("inconsistent file size by different tasks");
                     }
                     /* incorrect, but now consistent across tasks */
-                    aggFileSizeFromStat = tmpMin;
+                    aggFileSizeFromStat = fileSize->min;
             }
         }
         point->aggFileSizeFromStat = aggFileSizeFromStat;
 
-        MPI_CHECK(MPI_Allreduce(&dataMoved, &point->aggFileSizeFromXfer,
-                                1, MPI_LONG_LONG_INT, MPI_SUM, testComm),
-                  "cannot total data moved");
+        point->aggFileSizeFromXfer = stats->ival[IOR_ISTAT_DATA_MOVED].sum;
 
         if (strcasecmp(params->api, "HDF5") != 0 && strcasecmp(params->api, "NCMPI") != 0) {
                 if (verbose >= VERBOSE_0 && rank == 0) {
@@ -410,14 +630,43 @@ static void CheckFileSize(IOR_test_t *test, char * testFilename, IOR_offset_t da
         point->aggFileSizeForBW = point->aggFileSizeFromXfer;
 }
 
+/*
+ * With sharedPatternBuffer, the first page of each transfer is written from a
+ * private buffer with the pattern of the task and the offset, the rest from
+ * the buffer shared by the node, see SharedPatternWrite().
+ */
+#define SHARED_PATTERN_HEADER 4096
+
+static size_t SharedPatternHeaderSize(size_t transfer)
+{
+        return transfer < SHARED_PATTERN_HEADER ? transfer : SHARED_PATTERN_HEADER;
+}
+
 /*
  * Compare buffers after reading/writing each transfer.  Displays only first
  * difference in buffers and returns total errors counted.
  */
 static size_t
-CompareData(void *expectedBuffer, size_t size, IOR_param_t *test, IOR_offset_t offset, int fillrank, int access)
+CompareData(void *expectedBuffer, size_t size, IOR_param_t *test, IOR_offset_t offset, int fillrank, int access, IOR_io_buffers *ioBuffers)
 {
         assert(access == WRITECHECK || access == READCHECK);
+        if (ioBuffers->header) {
+                /* the header has the pattern of the task, the rest is the shared payload */
+                size_t header = SharedPatternHeaderSize(size);
+                size_t errors = verify_memory_pattern(offset, expectedBuffer, header, test->timeStampSignatureValue, fillrank, test->dataPacketType, test->gpuMemoryFlags);
+                const char *actual = expectedBuffer;
+                const char *shared = ioBuffers->buffer;
+                if (size > header && memcmp(actual + header, shared + header, size - header) != 0) {
+                        size_t i = header;
+                        while (actual[i] == shared[i])
+                                i++;
+                        fprintf(out_logfile, "[%d] incorrect data on %s at file byte offset %lld, expected 0x%02x, actual 0x%02x\n",
+                                rank, access == WRITECHECK ? "write" : "read", (long long) (offset + i),
+                                (unsigned char) shared[i], (unsigned char) actual[i]);
+                        errors++;
+                }
+                return errors;
+        }
         return verify_memory_pattern(offset, expectedBuffer, size, test->timeStampSignatureValue, fillrank, test->dataPacketType, test->gpuMemoryFlags);
 }
 
@@ -741,24 +990,21 @@ static char *PrependDir(IOR_param_t * test, char *rootDir)
  * Reduce test results, and show if verbose set.
  */
 static void
-ReduceIterResults(IOR_test_t *test, double *timer, const int rep, const int access)
+ReduceIterResults(IOR_test_t *test, const ior_phase_stats_t *stats, const int rep, const int access)
 {
         double reduced[IOR_NB_TIMERS] = { 0 };
         double diff[IOR_NB_TIMERS / 2 + 1];
         double totalTime, accessTime;
         IOR_param_t *params = &test->params;
-        double bw, iops, latency, minlatency;
+        double bw, iops, latency;
         int i;
-        MPI_Op op;
 
         assert(access == WRITE || access == READ);
 
         /* Find the minimum start time of the even numbered timers, and the
            maximum finish time for the odd numbered timers */
         for (i = 0; i < IOR_NB_TIMERS; i++) {
-                op = i % 2 ? MPI_MAX : MPI_MIN;
-                MPI_CHECK(MPI_Reduce(&timer[i], &reduced[i], 1, MPI_DOUBLE,
-                                     op, 0, testComm), "MPI_Reduce()");
+                reduced[i] = i % 2 ? stats->val[i].max : stats->val[i].min;
         }
 
         /* Calculate elapsed times and throughput numbers */
@@ -787,8 +1033,7 @@ ReduceIterResults(IOR_test_t *test, double *timer, const int rep, const int acce
          * minimum (best) latency achieved. So what is reported is the average
          * latency of all ops from a single task, then taking the minimum of
          * that between all tasks. */
-        latency = (timer[IOR_TIMER_RDWR_STOP] - timer[IOR_TIMER_RDWR_START]) / point->pairs_accessed;
-        MPI_CHECK(MPI_Reduce(&latency, &minlatency, 1, MPI_DOUBLE, MPI_MIN, 0, testComm), "MPI_Reduce()");
+        latency = stats->val[IOR_STAT_LATENCY].min;
 
         /* Only rank 0 tallies and prints the results. */
         if (rank != 0)
@@ -833,6 +1078,245 @@ static void RemoveFile(char *testFileName, int filePerProc, IOR_param_t * test)
         }
 }
 
+/*
+ * Topology aware reordering: the tasks are sorted by rack, switch and node,
+ * then each task reads the data of the task a fixed number of positions
+ * further in this order.  Any shift between the largest number of tasks of a
+ * node and the number of tasks minus it guarantees that no task reads data of
+ * its own node, among these the shift maximizing first the minimum and then
+ * the total distance is used.  Returns the rankOffset of this task.
+ */
+enum { DIST_NODE, DIST_SWITCH, DIST_RACK, DIST_REMOTE, DIST_LEVELS };
+
+typedef struct {
+        unsigned long long rack;
+        unsigned long long sw;
+        int node;
+        int rank;
+} reorder_key_t;
+
+static int ReorderKeyCompare(const void *a, const void *b)
+{
+        const reorder_key_t *x = a, *y = b;
+
+        if (x->rack != y->rack)
+                return x->rack < y->rack ? -1 : 1;
+        if (x->sw != y->sw)
+                return x->sw < y->sw ? -1 : 1;
+        if (x->node != y->node)
+                return x->node < y->node ? -1 : 1;
+        return x->rank - y->rank;
+}
+
+static unsigned long long StringHash(const char *str)
+{
+        unsigned long long hash = 14695981039346656037ULL; /* FNV-1a */
+
+        for (; *str != '\0'; str++)
+                hash = (hash ^ (unsigned char) *str) * 1099511628211ULL;
+        return hash;
+}
+
+/*
+ * Look up the switch and rack of this host, rank 0 reads the file for all.
+ * Hosts missing in the file keep the ids passed in, a switch and rack of
+ * their own.
+ */
+static void LookupSwitchAndRack(char *topologyFile, MPI_Comm comm, unsigned long long ids[2])
+{
+        char hostname[MAX_STR];
+        char *content = NULL;
+        long size = 0;
+
+        if (gethostname(hostname, MAX_STR) != 0)
+                ERR("gethostname() failed");
+        if (topologyFile == NULL)
+                return;
+
+        if (rank == 0) {
+                FILE *fd = fopen(topologyFile, "r");
+                if (fd == NULL)
+                        ERRF("cannot open topology file \"%s\"", topologyFile);
+                fseek(fd, 0, SEEK_END);
+                size = ftell(fd);
+                rewind(fd);
+                content = safeMalloc(size + 1);
+                if (fread(content, 1, size, fd) != (size_t) size)
+                        ERRF("cannot read topology file \"%s\"", topologyFile);
+                fclose(fd);
+        }
+        MPI_CHECK(MPI_Bcast(&size, 1, MPI_LONG, 0, comm), "cannot broadcast topology file");
+        if (rank != 0)
+                content = safeMalloc(size + 1);
+        MPI_CHECK(MPI_Bcast(content, size, MPI_CHAR, 0, comm), "cannot broadcast topology file");
+        content[size] = '\0';
+
+        size_t shortLen = strcspn(hostname, ".");
+        char *saveptr = NULL;
+        for (char *line = strtok_r(content, "\n", &saveptr); line != NULL; line = strtok_r(NULL, "\n", &saveptr)) {
+                char host[MAX_STR], sw[MAX_STR], rack[MAX_STR];
+                int n = sscanf(line, "%1023s %1023s %1023s", host, sw, rack);
+                if (n < 2 || host[0] == '#')
+                        continue;
+                if (strcmp(host, hostname) != 0
+                    && (strlen(host) != shortLen || strncmp(host, hostname, shortLen) != 0))
+                        continue;
+                ids[0] = StringHash(sw);
+                ids[1] = n == 3 ? StringHash(rack) : ids[0];
+                break;
+        }
+        free(content);
+}
+
+static int ReorderDistance(const reorder_key_t *a, const reorder_key_t *b)
+{
+        if (a->node == b->node)
+                return DIST_NODE;
+        if (a->sw == b->sw)
+                return DIST_SWITCH;
+        if (a->rack == b->rack)
+                return DIST_RACK;
+        return DIST_REMOTE;
+}
+
+/*
+ * The rank offset to the data of the tasks nodes away.  On an irregular layout
+ * the ranks are ordered by node and shifted by the tasks of the largest node,
+ * see NodeOrderShift(), so the offset differs between the tasks.
+ */
+static int ReorderRankOffset(IOR_param_t *params, int nodes)
+{
+        const ior_topology_t *topo = GetTopology(params->testComm);
+
+        if (! topo->irregular) {
+                int shift = 1; /* assume a by-node (round-robin) mapping of tasks to nodes */
+                if (params->tasksBlockMapping) {
+                        shift = params->numTasksOnNode0; /* switch to by-slot (contiguous block) mapping */
+                }
+                return (nodes * shift) % params->numTasks;
+        }
+        int reader = rank;
+        int writer = NodeOrderShift(topo, reader, (long long) nodes * topo->maxTasksOnNode);
+        return (writer - reader + topo->numTasks) % topo->numTasks;
+}
+
+static int TopologyRankOffset(IOR_param_t *params)
+{
+        MPI_Comm comm = params->testComm;
+        const ior_topology_t *topo = GetTopology(comm);
+        int tasks = topo->numTasks;
+        unsigned long long ids[2];
+        unsigned long long *allIds = safeMalloc(sizeof(unsigned long long) * 2 * tasks);
+        reorder_key_t *order = safeMalloc(sizeof(reorder_key_t) * tasks);
+        int count[DIST_LEVELS] = {0};
+        int best = 0, bestMin = -1;
+        long long bestSum = -1;
+        int i, offset = 0;
+
+        ids[0] = ids[1] = ~0ULL - topo->nodeIndex;
+        LookupSwitchAndRack(params->topologyFile, comm, ids);
+        MPI_CHECK(MPI_Allgather(ids, 2, MPI_UNSIGNED_LONG_LONG, allIds, 2, MPI_UNSIGNED_LONG_LONG, comm),
+                  "cannot gather the switch and rack of the tasks");
+        for (i = 0; i < tasks; i++) {
+                order[i].sw = allIds[2 * i];
+                order[i].rack = allIds[2 * i + 1];
+                order[i].node = topo->nodeOfRank[i];
+                order[i].rank = i;
+        }
+        qsort(order, tasks, sizeof(reorder_key_t), ReorderKeyCompare);
+
+        int lo = topo->maxTasksOnNode, hi = tasks - topo->maxTasksOnNode;
+        if (lo > hi) {
+                if (rank == 0)
+                        WARN("more than half of the tasks are on one node, some tasks read data of their own node");
+                lo = hi = tasks / 2;
+        }
+        /* evaluate up to 64 evenly spaced shifts and the middle one */
+        int step = (hi - lo) / 64 + 1;
+        for (int s = lo; s <= hi + step; s += step) {
+                int shift = s > hi ? tasks / 2 : s;
+                int min = DIST_REMOTE;
+                long long sum = 0;
+                if (shift <= 0 || shift >= tasks)
+                        continue;
+                for (i = 0; i < tasks; i++) {
+                        int d = ReorderDistance(&order[i], &order[(i + shift) % tasks]);
+                        min = d < min ? d : min;
+                        sum += d;
+                }
+                if (min > bestMin || (min == bestMin && sum > bestSum)) {
+                        best = shift;
+                        bestMin = min;
+                        bestSum = sum;
+                }
+        }
+
+        for (i = 0; i < tasks; i++) {
+                const reorder_key_t *reader = &order[i];
+                const reorder_key_t *writer = &order[(i + best) % tasks];
+                count[ReorderDistance(reader, writer)]++;
+                if (reader->rank == rank)
+                        offset = (writer->rank - reader->rank + tasks) % tasks;
+        }
+        if (rank == 0)
+                PrintReorderDistances(count, DIST_LEVELS);
+        free(order);
+        free(allIds);
+        return offset;
+}
+
+/*
+ * Scaling studies run a test on all tasks of the first numNodes nodes, the
+ * number of tasks follows from the node count.
+ */
+static void SelectNodeTasks(IOR_param_t *params, int mpiNumNodes, int mpiNumTasksOnNode0)
+{
+        int local, numTasks;
+
+        if (params->numTasks != -1)
+                ERR("numTasks cannot be used when selecting the tasks by numNodes");
+        if (params->numNodes <= 0)
+                ERR("numNodes must be positive to select the nodes of a test");
+        if (params->numNodes > mpiNumNodes) {
+                if (rank == 0)
+                        WARNF("More nodes requested (%d) than available (%d), running with %d nodes.",
+                              params->numNodes, mpiNumNodes, mpiNumNodes);
+                params->numNodes = mpiNumNodes;
+        }
+        local = nodeIndex < params->numNodes;
+        MPI_CHECK(MPI_Allreduce(&local, &numTasks, 1, MPI_INT, MPI_SUM, params->mpi_comm_world),
+                  "MPI_Allreduce() error");
+        params->numTasks = numTasks;
+
+        if (params->strongScaling) {
+                /* the aggregate size of one node is split among all tasks */
+                IOR_offset_t block = params->blockSize * mpiNumTasksOnNode0 / numTasks;
+                block -= block % params->transferSize;
+                if (block == 0)
+                        ERRF("strongScaling: blockSize %lld is too small for %d nodes",
+                             params->blockSize, params->numNodes);
+                params->blockSize = block;
+        }
+}
+
+/*
+ * A concurrent test runs on the ranks following those of the previous test.
+ */
+static void PlaceConcurrentTest(IOR_test_t *prevTest, IOR_param_t *params, int mpiNumTasks)
+{
+        if (prevTest == NULL)
+                ERR("the first test cannot be concurrent to a previous one");
+        if (params->selectNodes || prevTest->params.selectNodes)
+                ERR("concurrent tests cannot select nodes");
+        if (prevTest->params.concurrentGroup < 0)
+                prevTest->params.concurrentGroup = 0;
+        params->concurrentGroup = prevTest->params.concurrentGroup + 1;
+        params->firstRank = prevTest->params.firstRank + prevTest->params.numTasks;
+        if (params->firstRank + params->numTasks > mpiNumTasks)
+                ERRF("concurrent test %d needs ranks %d to %d but only %d tasks are available, set numTasks of the concurrent tests",
+                     params->id, params->firstRank, params->firstRank + params->numTasks - 1, mpiNumTasks);
+}
+
 /*
  * Setup tests by parsing commandline and creating test script.
  * Perform a sanity-check on the configured parameters.
@@ -846,17 +1330,20 @@ static void InitTests(IOR_test_t *tests)
         int mpiNumNodes = 0;
         int mpiNumTasks = 0;
         int mpiNumTasksOnNode0 = 0;
+        IOR_test_t *prevTest = NULL;
 
         verbose = tests->params.verbose;
         aiori_warning_as_errors = tests->params.warningAsErrors;
 
         /*
-         * These default values are the same for every test and expensive to
-         * retrieve so just do it once.
+         * These default values are the same for every test, the node layout
+         * is determined once and cached with the communicator.
          */
-        mpiNumNodes = GetNumNodes(com);
-        mpiNumTasks = GetNumTasks(com);
-        mpiNumTasksOnNode0 = GetNumTasksOnNode0(com);
+        const ior_topology_t *topo = GetTopology(com);
+        mpiNumNodes = topo->numNodes;
+        mpiNumTasks = topo->numTasks;
+        mpiNumTasksOnNode0 = topo->tasksOnNode0;
+        nodeIndex = topo->nodeIndex;
 
         /*
          * Since there is no guarantee that anyone other than
@@ -870,6 +1357,12 @@ static void InitTests(IOR_test_t *tests)
                 IOR_param_t *params = & tests->params;
                 params->testComm = com;
 
+                if (params->selectNodes) {
+                        SelectNodeTasks(params, mpiNumNodes, mpiNumTasksOnNode0);
+                }
+                params->concurrentGroup = -1;
+                params->firstRank = 0;
+
                 /* use MPI values if not overridden on command-line */
                 if (params->numNodes == -1) {
                         params->numNodes = mpiNumNodes;
@@ -888,24 +1381,131 @@ static void InitTests(IOR_test_t *tests)
                         params->numTasksOnNode0 = mpiNumTasksOnNode0;
                 }
 
-                params->tasksBlockMapping = QueryNodeMapping(com,false);
+                if (params->concurrent) {
+                        PlaceConcurrentTest(prevTest, params, mpiNumTasks);
+                }
+
+                params->tasksBlockMapping = topo->blockMapping;
                 params->expectedAggFileSize =
                   params->blockSize * params->segmentCount * params->numTasks;
 
                 ValidateTests(&tests->params, com);
+                prevTest = tests;
                 tests = tests->next;
         }
 
         init_clock(com);
 }
 
+/* transfer buffer kept across the points of a parameter sweep */
+static void *sweepBuffer = NULL;
+static IOR_offset_t sweepBufferSize = 0;
+static ior_memory_flags sweepBufferFlags;
+
+/* transfer buffer shared by the tasks of a node with sharedPatternBuffer */
+static MPI_Comm sharedPatternComm = MPI_COMM_NULL;
+#if MPI_VERSION >= 3
+static MPI_Win sharedPatternWin = MPI_WIN_NULL;
+#endif
+
+/*
+ * Allocate one transfer buffer per node in a shared memory window, the first
+ * task of the node owns it.
+ */
+static void *SharedPatternBufferSetup(IOR_param_t *test)
+{
+        char *buffer = NULL;
+#if MPI_VERSION >= 3
+        size_t pageSize = sysconf(_SC_PAGESIZE);
+        MPI_Aint size;
+        int disp, localRank;
+
+        MPI_CHECK(MPI_Comm_split_type(test->testComm, MPI_COMM_TYPE_SHARED, 0, MPI_INFO_NULL,
+                                      &sharedPatternComm), "cannot split the communicator by node");
+        MPI_CHECK(MPI_Comm_rank(sharedPatternComm, &localRank), "cannot get rank");
+        /* with a page of slack, so that the buffer can be page aligned for O_DIRECT */
+        size = localRank == 0 ? test->transferSize + pageSize : 0;
+        MPI_CHECK(MPI_Win_allocate_shared(size, 1, MPI_INFO_NULL, sharedPatternComm, &buffer,
+                                          &sharedPatternWin), "cannot allocate the shared pattern buffer");
+        MPI_CHECK(MPI_Win_shared_query(sharedPatternWin, 0, &size, &disp, &buffer),
+                  "cannot query the shared pattern buffer");
+        MPI_CHECK(MPI_Win_lock_all(MPI_MODE_NOCHECK, sharedPatternWin), "cannot lock window");
+        buffer += (pageSize - ((size_t) buffer & (pageSize - 1))) & (pageSize - 1);
+#endif
+        return buffer;
+}
+
+/*
+ * Fill the private header with the pattern of the task and the shared buffer
+ * once per node.  The shared payload has the pattern of rank 0 at offset 0 on
+ * every node, hence any task can verify the payload against its own node's
+ * buffer.
+ */
+static void SharedPatternGenerate(IOR_param_t *test, IOR_io_buffers *ioBuffers, int pretendRank)
+{
+        generate_memory_pattern((char *) ioBuffers->header, SharedPatternHeaderSize(test->transferSize),
+                                test->timeStampSignatureValue, pretendRank, test->dataPacketType, test->gpuMemoryFlags);
+#if MPI_VERSION >= 3
+        int localRank;
+
+        MPI_CHECK(MPI_Comm_rank(sharedPatternComm, &localRank), "cannot get rank");
+        if (localRank == 0) {
+                generate_memory_pattern((char *) ioBuffers->buffer, test->transferSize, test->timeStampSignatureValue,
+                                        0, test->dataPacketType, test->gpuMemoryFlags);
+                update_write_memory_pattern(0, ioBuffers->buffer, test->transferSize, test->setTimeStampSignature,
+                                            0, test->dataPacketType, test->gpuMemoryFlags);
+        }
+        MPI_CHECK(MPI_Win_sync(sharedPatternWin), "cannot synchronize window");
+        MPI_CHECK(MPI_Barrier(sharedPatternComm), "barrier error");
+        MPI_CHECK(MPI_Win_sync(sharedPatternWin), "cannot synchronize window");
+#endif
+}
+
+/*
+ * Write a transfer as the private header followed by the shared payload with
+ * a single writev call.
+ */
+static IOR_offset_t SharedPatternWrite(IOR_param_t *test, aiori_fd_t *fd, IOR_io_buffers *ioBuffers,
+                                       IOR_offset_t transfer, IOR_offset_t offset)
+{
+        IOR_offset_t header = SharedPatternHeaderSize(transfer);
+
+        struct iovec iov[2] = {
+                {ioBuffers->header, header},
+                {(char *) ioBuffers->buffer + header, transfer - header}
+        };
+
+        return backend->writev(fd, iov, header == transfer ? 1 : 2, offset, test->backend_options);
+}
+
 /*
  * Setup transfer buffers, creating and filling as needed.
  */
 static void XferBuffersSetup(IOR_io_buffers* ioBuffers, IOR_param_t* test,
                              int pretendRank)
 {
-        ioBuffers->buffer = aligned_buffer_alloc(test->transferSize, test->gpuMemoryFlags);
+        ioBuffers->header = ioBuffers->readBuffer = NULL;
+        if (test->sharedPatternBuffer) {
+                ioBuffers->buffer = SharedPatternBufferSetup(test);
+                ioBuffers->header = aligned_buffer_alloc(SharedPatternHeaderSize(test->transferSize), test->gpuMemoryFlags);
+                if (test->readFile || test->checkWrite || test->checkRead)
+                        ioBuffers->readBuffer = aligned_buffer_alloc(test->transferSize, test->gpuMemoryFlags);
+                return;
+        }
+        if (test->sweepDims == 0) {
+                ioBuffers->buffer = aligned_buffer_alloc(test->transferSize, test->gpuMemoryFlags);
+                return;
+        }
+        /* sized for the largest transfer of the sweep, allocated once */
+        if (sweepBuffer == NULL || sweepBufferSize < test->transferSize
+            || sweepBufferFlags != test->gpuMemoryFlags) {
+                XferBuffersRelease();
+                sweepBufferSize = test->sweepBufferSize > test->transferSize ?
+                        test->sweepBufferSize : test->transferSize;
+                sweepBufferFlags = test->gpuMemoryFlags;
+                sweepBuffer = aligned_buffer_alloc(sweepBufferSize, sweepBufferFlags);
+        }
+        ioBuffers->buffer = sweepBuffer;
 }
 
 /*
@@ -914,9 +1514,34 @@ static void XferBuffersSetup(IOR_io_buffers* ioBuffers, IOR_param_t* test,
 static void XferBuffersFree(IOR_io_buffers* ioBuffers, IOR_param_t* test)
 
 {
+        if (sharedPatternComm != MPI_COMM_NULL) {
+                aligned_buffer_free(ioBuffers->header, test->gpuMemoryFlags);
+                if (ioBuffers->readBuffer)
+                        aligned_buffer_free(ioBuffers->readBuffer, test->gpuMemoryFlags);
+#if MPI_VERSION >= 3
+                MPI_CHECK(MPI_Win_unlock_all(sharedPatternWin), "cannot unlock window");
+                MPI_CHECK(MPI_Win_free(&sharedPatternWin), "cannot free window");
+#endif
+                MPI_CHECK(MPI_Comm_free(&sharedPatternComm), "cannot free communicator");
+                return;
+        }
+        if (ioBuffers->buffer == sweepBuffer)
+                return;
         aligned_buffer_free(ioBuffers->buffer, test->gpuMemoryFlags);
 }
 
+/*
+ * Free the transfer buffer kept for a parameter sweep.
+ */
+static void XferBuffersRelease(void)
+{
+        if (sweepBuffer == NULL)
+                return;
+        aligned_buffer_free(sweepBuffer, sweepBufferFlags);
+        sweepBuffer = NULL;
+        sweepBufferSize = 0;
+}
+
 
 
 /*
@@ -1015,7 +1640,7 @@ static void *HogMemory(IOR_param_t *params)
                 if (verbose >= VERBOSE_3)
                         fprintf(out_logfile, "This node hogging %ld bytes of memory\n",
                                 params->memoryPerNode);
-                size = params->memoryPerNode / params->numTasksOnNode0;
+                size = params->memoryPerNode / GetTopology(params->mpi_comm_world)->tasksOnNode;
         } else {
                 return NULL;
         }
@@ -1096,47 +1721,37 @@ WriteTimes(IOR_param_t *test, const double *timer, const int iteration,
         }
 }
 
+/*
+ * Each task appends its own record to the details file, collectively.
+ */
 static void StoreRankInformation(IOR_test_t *test, double *timer, const int rep, const int access){
   IOR_param_t *params = &test->params;
   double totalTime = timer[IOR_TIMER_CLOSE_STOP] - timer[IOR_TIMER_OPEN_START];
   double accessTime = timer[IOR_TIMER_RDWR_STOP] - timer[IOR_TIMER_RDWR_START];
-  double times[] = {totalTime, accessTime};
-
-  if(rank == 0){
-    FILE* fd = fopen(params->saveRankDetailsCSV, "a");
-    if (fd == NULL){
-      FAIL("Cannot open saveRankPerformanceDetailsCSV file for writes!");
-    }
-    int size;
-    MPI_Comm_size(params->testComm, & size);
-    double *all_times = malloc(2* size * sizeof(double));
-    MPI_Gather(times, 2, MPI_DOUBLE, all_times, 2, MPI_DOUBLE, 0, params->testComm);
-    IOR_point_t *point = (access == WRITE) ? &test->results[rep].write : &test->results[rep].read;
-    double file_size = ((double) point->aggFileSizeForBW) / size;
-
-    for(int i=0; i < size; i++){
-      char buff[1024];
-      sprintf(buff, "%s,%d,%.10e,%.10e,%.10e,%.10e\n", access==WRITE ? "write" : "read", i, all_times[i*2], all_times[i*2+1], file_size/all_times[i*2], file_size/all_times[i*2+1] );
-      int ret = fwrite(buff, strlen(buff), 1, fd);
-      if(ret != 1){
-        WARN("Couln't append to saveRankPerformanceDetailsCSV file\n");
-        break;
-      }
-    }
-    fclose(fd);
+  IOR_point_t *point = (access == WRITE) ? &test->results[rep].write : &test->results[rep].read;
+  int size;
+  MPI_Comm_size(params->testComm, & size);
+  double file_size = ((double) point->aggFileSizeForBW) / size;
+
+  if(params->saveRankDetailsBinary){
+    IOR_rank_record_t record = {rank, access, params->id, rep, totalTime, accessTime,
+                                file_size/totalTime, file_size/accessTime};
+    AppendRankRecords(params->saveRankDetailsCSV, & record, sizeof(record), params->testComm);
   }else{
-    MPI_Gather(& times, 2, MPI_DOUBLE, NULL, 2, MPI_DOUBLE, 0, testComm);
+    char buff[1024];
+    int len = sprintf(buff, "%s,%d,%.10e,%.10e,%.10e,%.10e\n", access==WRITE ? "write" : "read", rank, totalTime, accessTime, file_size/totalTime, file_size/accessTime);
+    AppendRankRecords(params->saveRankDetailsCSV, buff, len, params->testComm);
   }
 }
 
-static void ProcessIterResults(IOR_test_t *test, double *timer, const int rep, const int access){
+static void ProcessIterResults(IOR_test_t *test, double *timer, const ior_phase_stats_t *stats, const int rep, const int access){
   IOR_param_t *params = &test->params;
 
   if (verbose >= VERBOSE_3)
     WriteTimes(params, timer, rep, access);
-  ReduceIterResults(test, timer, rep, access);
+  ReduceIterResults(test, stats, rep, access);
   if (params->outlierThreshold) {
-    CheckForOutliers(params, timer, access);
+    CheckForOutliers(params, timer, stats, access);
   }
 
   if(params->saveRankDetailsCSV){
@@ -1144,6 +1759,91 @@ static void ProcessIterResults(IOR_test_t *test, double *timer, const int rep, c
   }
 }
 
+/*
+ * Estimate the memory IOR allocates per task and node for the test and fail
+ * before allocating it if a node cannot provide it next to memoryPerTask or
+ * memoryPerNode.
+ */
+static void CheckMemoryBudget(IOR_param_t *params, ior_memory_budget_t *budget)
+{
+        const ior_topology_t *topo = GetTopology(params->testComm);
+        const int host = params->gpuMemoryFlags == IOR_MEMORY_TYPE_CPU;
+        size_t transfer = params->transferSize;
+        size_t reserve = 0;
+
+        if (params->sweepDims > 0 && params->sweepBufferSize > (IOR_offset_t) transfer)
+                transfer = params->sweepBufferSize;
+        if (params->sharedPatternBuffer)
+                transfer = topo->localRank == 0 ? transfer + sysconf(_SC_PAGESIZE) : 0;
+        const int reads = params->readFile || params->checkWrite || params->checkRead;
+        ior_memory_item_t items[] = {
+                {"transfer buffer", host && transfer > 0 ? aligned_buffer_footprint(transfer) : 0},
+                {"shared pattern header", host && params->sharedPatternBuffer ?
+                        aligned_buffer_footprint(SharedPatternHeaderSize(params->transferSize)) : 0},
+                {"read buffer", host && params->sharedPatternBuffer && reads ? aligned_buffer_footprint(params->transferSize) : 0},
+                {"random prefill buffer", host && params->randomPrefillBlocksize && (params->writeFile || params->checkWrite) ?
+                        aligned_buffer_footprint(params->randomPrefillBlocksize) : 0},
+                /* the number of transfers of a task is random for a shared file, count the expected one */
+                {"random offsets", params->randomOffset == 1 ?
+                        params->blockSize / params->transferSize * sizeof(IOR_offset_t) : 0},
+                {"per-operation timer", params->savePerOpDataCSV ? 2 * OP_BUFFER_SIZE * sizeof(double) : 0},
+                {"results", params->repetitions * sizeof(IOR_results_t)},
+        };
+        const int count = sizeof(items) / sizeof(items[0]);
+
+        if (params->memoryPerTask != 0)
+                reserve = params->memoryPerTask;
+        else if (params->memoryPerNode != 0)
+                reserve = params->memoryPerNode / topo->tasksOnNode;
+        MemoryBudget(items, count, reserve, params->testComm, budget);
+        if (rank == 0 && verbose >= VERBOSE_2) {
+                for (int i = 0; i < count; i++)
+                        fprintf(out_logfile, "Memory of a task for the %s: %zu bytes\n", items[i].name, items[i].bytes);
+        }
+        if (budget->exceeded)
+                ERRF("node %d lacks memory: IOR allocates %zu bytes and memoryPerTask/memoryPerNode reserve %zu bytes, only %zu bytes are available",
+                     budget->nodeIndex, budget->node, budget->reserve, budget->available);
+}
+
+/*
+ * Bind the tasks to CPUs and choose the NUMA node of the transfer buffers as
+ * requested, before the buffers are allocated.
+ */
+static void SetupPlacement(IOR_param_t *params)
+{
+        int node = -1;
+
+        if (params->numaNode) {
+                char testFileName[MAX_PATHLEN];
+                GetTestFileName(testFileName, params);
+                node = GetDeviceNumaNode(params->numaNode, testFileName);
+                if (node < 0)
+                        WARNF("cannot determine the NUMA node of \"%s\", the buffers are not placed",
+                              params->numaNode);
+        }
+        SetBufferNumaNode(node);
+        aligned_buffer_huge_pages(params->hugePages);
+        if (BindToCpus(params->cpuBind, node, params->testComm) != 0)
+                WARNF("cannot bind the task to CPUs with cpuBind=%s", params->cpuBind);
+}
+
+/*
+ * Gather where the tasks run and where their buffers reside on rank 0.
+ */
+static ior_placement_t *GatherPlacement(IOR_param_t *params, void *buffer)
+{
+        ior_placement_t mine;
+        ior_placement_t *all = NULL;
+
+        GetPlacement(params->gpuMemoryFlags == IOR_MEMORY_TYPE_CPU ? buffer : NULL, &mine);
+        mine.node = GetTopology(params->testComm)->nodeIndex;
+        if (rank == 0)
+                all = safeMalloc(sizeof(ior_placement_t) * params->numTasks);
+        MPI_CHECK(MPI_Gather(&mine, sizeof(mine), MPI_BYTE, all, sizeof(mine), MPI_BYTE,
+                             0, params->testComm), "cannot gather the placement of the tasks");
+        return all;
+}
+
 /*
  * Using the test parameters, run iteration(s) of single test.
  */
@@ -1153,6 +1853,9 @@ static void TestIoSys(IOR_test_t *test)
         IOR_results_t *results = test->results;
         char testFileName[MAX_STR];
         double timer[IOR_NB_TIMERS];
+        double resStart[IOR_NB_RES], resEnd[IOR_NB_RES];
+        double perf[IOR_NB_PERF];
+        ior_phase_stats_t phaseStats;
         double startTime;
         int pretendRank;
         int rep;
@@ -1160,12 +1863,14 @@ static void TestIoSys(IOR_test_t *test)
         IOR_offset_t dataMoved; /* for data rate calculation */
         void *hog_buf;
         IOR_io_buffers ioBuffers;
+        ior_placement_t *placement = NULL;
+        ior_memory_budget_t budget;
+        size_t peakTask, peakNode;
 
-        /* show test setup */
-        if (rank == 0 && verbose >= VERBOSE_0)
-                ShowSetup(params);
-
-        hog_buf = HogMemory(params);
+        SetupPlacement(params);
+        if (params->perfCounters)
+                PerfCountersSetup(params->testComm);
+        CheckMemoryBudget(params, &budget);
 
         pretendRank = (rank + rankOffset) % params->numTasks;
 
@@ -1176,7 +1881,21 @@ static void TestIoSys(IOR_test_t *test)
         }
 
         XferBuffersSetup(&ioBuffers, params, pretendRank);
-        
+
+        if (params->cpuBind || params->numaNode || outputFormat == OUTPUT_JSON)
+                placement = GatherPlacement(params, ioBuffers.buffer);
+
+        /* show test setup */
+        if (rank == 0 && verbose >= VERBOSE_0)
+                ShowSetup(params, placement, &budget);
+        free(placement);
+
+        hog_buf = HogMemory(params);
+
+        int topologyRankOffset = 0;
+        if (params->reorderTasksTopology)
+                topologyRankOffset = TopologyRankOffset(params);
+
         /* Initial time stamp */
         startTime = GetTimeStamp();
 
@@ -1219,7 +1938,10 @@ static void TestIoSys(IOR_test_t *test)
                           (&params->timeStampSignatureValue, 1, MPI_UNSIGNED, 0,
                            testComm), "cannot broadcast start time value");
 
-                generate_memory_pattern((char*) ioBuffers.buffer, params->transferSize, params->timeStampSignatureValue, pretendRank, params->dataPacketType, params->gpuMemoryFlags);
+                if (params->sharedPatternBuffer)
+                        SharedPatternGenerate(params, &ioBuffers, pretendRank);
+                else
+                        generate_memory_pattern((char*) ioBuffers.buffer, params->transferSize, params->timeStampSignatureValue, pretendRank, params->dataPacketType, params->gpuMemoryFlags);
 
                 /* use repetition count for number of multiple files */
                 if (params->multiFile)
@@ -1243,7 +1965,9 @@ static void TestIoSys(IOR_test_t *test)
 
                         params->stoneWallingWearOutIterations = params_saved_wearout;
                         MPI_CHECK(MPI_Barrier(testComm), "barrier error");
+                        ConcurrentPhaseSync();
                         params->open = WRITE;
+                        ResourcesSample(resStart, params->resourceAccounting, testComm);
                         timer[IOR_TIMER_OPEN_START] = GetTimeStamp();
                         fd = backend->create(testFileName, IOR_WRONLY | IOR_CREAT | IOR_TRUNC, params->backend_options);
                         if(fd == NULL) FAIL("Cannot create file");
@@ -1256,6 +1980,8 @@ static void TestIoSys(IOR_test_t *test)
                                         "Commencing write performance test: %s",
                                         CurrentTimeString());
                         }
+                        if (params->perfCounters)
+                                PerfCountersStart();
                         timer[IOR_TIMER_RDWR_START] = GetTimeStamp();
                         dataMoved = WriteOrRead(params, rep, &results[rep], fd, WRITE, &ioBuffers);
                         if (params->verbose >= VERBOSE_4) {
@@ -1263,6 +1989,8 @@ static void TestIoSys(IOR_test_t *test)
                           fflush(out_logfile);
                         }
                         timer[IOR_TIMER_RDWR_STOP] = GetTimeStamp();
+                        if (params->perfCounters)
+                                PerfCountersStop(perf);
                         if (params->intraTestBarriers)
                                 MPI_CHECK(MPI_Barrier(testComm),
                                           "barrier error");
@@ -1270,13 +1998,15 @@ static void TestIoSys(IOR_test_t *test)
                         backend->close(fd, params->backend_options);
 
                         timer[IOR_TIMER_CLOSE_STOP] = GetTimeStamp();
+                        ResourcesSample(resEnd, params->resourceAccounting, testComm);
                         MPI_CHECK(MPI_Barrier(testComm), "barrier error");
 
                         /* check if stat() of file doesn't equal expected file size,
                            use actual amount of byte moved */
-                        CheckFileSize(test, testFileName, dataMoved, rep, WRITE);
+                        GatherPhaseStats(test, testFileName, timer, dataMoved, rep, WRITE, resEnd, resStart, perf, &phaseStats);
+                        CheckFileSize(test, &phaseStats, rep, WRITE);
 
-                        ProcessIterResults(test, timer, rep, WRITE);
+                        ProcessIterResults(test, timer, &phaseStats, rep, WRITE);
 
                         /* check if in this round we run write with stonewalling */
                         if(params->deadlineForStonewalling > 0){
@@ -1297,11 +2027,10 @@ static void TestIoSys(IOR_test_t *test)
                         }
                         if (params->reorderTasks) {
                                 /* move two nodes away from writing node */
-                                int shift = 1; /* assume a by-node (round-robin) mapping of tasks to nodes */
-                                if (params->tasksBlockMapping) {
-                                    shift = params->numTasksOnNode0; /* switch to by-slot (contiguous block) mapping */
-                                }
-                                rankOffset = (2 * shift) % params->numTasks;
+                                rankOffset = ReorderRankOffset(params, 2);
+                        }
+                        if (params->reorderTasksTopology) {
+                                rankOffset = topologyRankOffset;
                         }
                         
                         GetTestFileName(testFileName, params);
@@ -1333,11 +2062,11 @@ static void TestIoSys(IOR_test_t *test)
                         /* Constant process offset reading */
                         if (params->reorderTasks) {
                                 /* move one node away from writing node */
-                                int shift = 1; /* assume a by-node (round-robin) mapping of tasks to nodes */
-                                if (params->tasksBlockMapping) {
-                                    shift=params->numTasksOnNode0; /* switch to a by-slot (contiguous block) mapping */
-                                }
-                                rankOffset = (params->taskPerNodeOffset * shift) % params->numTasks;
+                                rankOffset = ReorderRankOffset(params, params->taskPerNodeOffset);
+                        }
+                        /* read the data of the most distant node */
+                        if (params->reorderTasksTopology) {
+                                rankOffset = topologyRankOffset;
                         }
                         /* random process offset reading */
                         if (params->reorderTasksRandom == 1) {
@@ -1401,7 +2130,9 @@ static void TestIoSys(IOR_test_t *test)
                         }
                         DelaySecs(params->interTestDelay);
                         MPI_CHECK(MPI_Barrier(testComm), "barrier error");
+                        ConcurrentPhaseSync();
                         params->open = READ;
+                        ResourcesSample(resStart, params->resourceAccounting, testComm);
                         timer[IOR_TIMER_OPEN_START] = GetTimeStamp();
                         fd = backend->open(testFileName, IOR_RDONLY, params->backend_options);
                         if(fd == NULL) FAIL("Cannot open file");
@@ -1414,21 +2145,27 @@ static void TestIoSys(IOR_test_t *test)
                                         "Commencing read performance test: %s\n",
                                         CurrentTimeString());
                         }
+                        if (params->perfCounters)
+                                PerfCountersStart();
                         timer[IOR_TIMER_RDWR_START] = GetTimeStamp();
                         dataMoved = WriteOrRead(params, rep, &results[rep], fd, operation_flag, &ioBuffers);
                         timer[IOR_TIMER_RDWR_STOP] = GetTimeStamp();
+                        if (params->perfCounters)
+                                PerfCountersStop(perf);
                         if (params->intraTestBarriers)
                                 MPI_CHECK(MPI_Barrier(testComm),
                                           "barrier error");
                         timer[IOR_TIMER_CLOSE_START] = GetTimeStamp();
                         backend->close(fd, params->backend_options);
                         timer[IOR_TIMER_CLOSE_STOP] = GetTimeStamp();
+                        ResourcesSample(resEnd, params->resourceAccounting, testComm);
 
                         /* check if stat() of file doesn't equal expected file size,
                            use actual amount of byte moved */
-                        CheckFileSize(test, testFileName, dataMoved, rep, READ);
+                        GatherPhaseStats(test, testFileName, timer, dataMoved, rep, READ, resEnd, resStart, perf, &phaseStats);
+                        CheckFileSize(test, &phaseStats, rep, READ);
 
-                        ProcessIterResults(test, timer, rep, READ);
+                        ProcessIterResults(test, timer, &phaseStats, rep, READ);
                 }
 
                 if (!params->keepFile
@@ -1455,8 +2192,11 @@ static void TestIoSys(IOR_test_t *test)
         } else {
                 PrintShortSummary(test);
         }
+        GatherPeakMemory(params->testComm, &peakTask, &peakNode);
+        PrintPeakMemory(peakTask, peakNode);
 
         XferBuffersFree(&ioBuffers, params);
+        PerfCountersClose();
 
         if (hog_buf != NULL)
                 free(hog_buf);
@@ -1480,6 +2220,22 @@ static void ValidateTests(IOR_param_t * test, MPI_Comm com)
           ERR("the StoneWallingStatusFile is only sensible for a write test when using  stoneWallingWearOut");
         if (test->deadlineForStonewalling == 0 && test->stoneWallingWearOut > 0)
           ERR("the stoneWallingWearOut is only sensible when setting a stonewall deadline with -D");
+        if (test->stoneWallingWorkStealing && test->stoneWallingWearOut == 0)
+          ERR("stoneWallingWorkStealing redistributes the wear out, it requires stoneWallingWearOut");
+        if (test->stoneWallingWorkStealing && (test->filePerProc || test->randomOffset || test->collective))
+          ERR("stoneWallingWorkStealing requires a single shared file with sequential, independent access");
+#if MPI_VERSION < 3
+        if (test->stoneWallingWorkStealing)
+          ERR("stoneWallingWorkStealing requires MPI-3 one-sided communication");
+        if (test->sharedPatternBuffer)
+          ERR("sharedPatternBuffer requires MPI-3 shared memory windows");
+#endif
+        if (test->sharedPatternBuffer && ! test->backend->writev)
+          ERRF("sharedPatternBuffer writes a private header and the shared payload with writev, which the %s backend lacks", test->api);
+        if (test->resourceAccounting < 0 || test->resourceAccounting > 2)
+          ERR("resourceAccounting must be 0, 1 (tasks) or 2 (tasks and nodes)");
+        if (test->sharedPatternBuffer && (test->gpuMemoryFlags != IOR_MEMORY_TYPE_CPU || test->stoneWallingWorkStealing))
+          ERR("sharedPatternBuffer cannot be combined with GPU buffers or stoneWallingWorkStealing");
         if (test->stoneWallingStatusFile && test->testscripts)
           WARN("the StoneWallingStatusFile only preserves the last experiment, make sure that each run uses a separate status file!");
         if (test->repetitions <= 0)
@@ -1550,6 +2306,22 @@ static void ValidateTests(IOR_param_t * test, MPI_Comm com)
         /* parameter consistency */
         if (test->reorderTasks == TRUE && test->reorderTasksRandom == TRUE)
                 ERR("Both Constant and Random task re-ordering specified. Choose one and resubmit");
+        if (test->reorderTasksTopology && (test->reorderTasks || test->reorderTasksRandom))
+                ERR("Topology task re-ordering cannot be combined with constant or random re-ordering");
+        if (test->randomOffset && test->reorderTasksTopology
+            && test->filePerProc == FALSE)
+                ERR("random offset and topology reorder tasks specified with single-shared-file. Choose one and resubmit");
+        if (test->topologyFile && ! test->reorderTasksTopology)
+                WARN("topologyFile is only used with reorderTasksTopology");
+        if (test->cpuBind && strcasecmp(test->cpuBind, "none") != 0 && strcasecmp(test->cpuBind, "core") != 0
+            && strcasecmp(test->cpuBind, "share") != 0 && strcasecmp(test->cpuBind, "numa") != 0)
+                ERRF("unknown cpuBind \"%s\", use none, core, share or numa", test->cpuBind);
+        if (test->cpuBind && strcasecmp(test->cpuBind, "numa") == 0 && test->numaNode == NULL)
+                ERR("cpuBind=numa requires numaNode");
+        if (test->numaNode && test->gpuMemoryFlags != IOR_MEMORY_TYPE_CPU)
+                WARN("numaNode only places buffers in host memory");
+        if (aligned_buffer_huge_pages(test->hugePages) != 0)
+                ERRF("unknown hugePages \"%s\", use none, thp, 2m or 1g", test->hugePages);
         if (test->randomOffset && test->reorderTasksRandom
             && test->filePerProc == FALSE)
                 ERR("random offset and random reorder tasks specified with single-shared-file. Choose one and resubmit");
@@ -1674,13 +2446,20 @@ IOR_offset_t *GetOffsetArrayRandom(IOR_param_t * test, int pretendRank, IOR_offs
 static IOR_offset_t WriteOrReadSingle(IOR_offset_t offset, int pretendRank, IOR_offset_t transfer, int * errors, IOR_param_t * test, aiori_fd_t * fd, IOR_io_buffers* ioBuffers, int access, OpTimer* ot, double startTime){
   IOR_offset_t amtXferred = 0;
 
-  void *buffer = ioBuffers->buffer;
+  /* a shared pattern buffer is read-only */
+  void *buffer = access != WRITE && ioBuffers->readBuffer ? ioBuffers->readBuffer : ioBuffers->buffer;
   if (access == WRITE) {
           /* fills each transfer with a unique pattern
-           * containing the offset into the file */
-          update_write_memory_pattern(offset, ioBuffers->buffer, transfer, test->setTimeStampSignature, pretendRank, test->dataPacketType, test->gpuMemoryFlags);
+           * containing the offset into the file, with a shared buffer only its private header */
+          if (ioBuffers->header)
+                  update_write_memory_pattern(offset, ioBuffers->header, SharedPatternHeaderSize(transfer), test->setTimeStampSignature, pretendRank, test->dataPacketType, test->gpuMemoryFlags);
+          else
+                  update_write_memory_pattern(offset, ioBuffers->buffer, transfer, test->setTimeStampSignature, pretendRank, test->dataPacketType, test->gpuMemoryFlags);
           double start = GetTimeStamp();
-          amtXferred = backend->xfer(access, fd, buffer, transfer, offset, test->backend_options);
+          if (ioBuffers->header)
+                  amtXferred = SharedPatternWrite(test, fd, ioBuffers, transfer, offset);
+          else
+                  amtXferred = backend->xfer(access, fd, buffer, transfer, offset, test->backend_options);
           if(ot) OpTimerValue(ot, start - startTime, GetTimeStamp() - start);
           if (amtXferred != transfer)
                   ERR("cannot write to file");
@@ -1707,7 +2486,7 @@ static IOR_offset_t WriteOrReadSingle(IOR_offset_t offset, int pretendRank, IOR_
           if(ot) OpTimerValue(ot, start - startTime, GetTimeStamp() - start);
           if (amtXferred != transfer)
                   ERR("cannot read from file write check");
-          *errors += CompareData(buffer, transfer, test, offset, pretendRank, WRITECHECK);
+          *errors += CompareData(buffer, transfer, test, offset, pretendRank, WRITECHECK, ioBuffers);
   } else if (access == READCHECK) {
           invalidate_buffer_pattern(buffer, transfer, test->gpuMemoryFlags);          
           double start = GetTimeStamp();
@@ -1716,17 +2495,17 @@ static IOR_offset_t WriteOrReadSingle(IOR_offset_t offset, int pretendRank, IOR_
           if (amtXferred != transfer){
             ERR("cannot read from file");
           }
-          *errors += CompareData(buffer, transfer, test, offset, pretendRank, READCHECK);
+          *errors += CompareData(buffer, transfer, test, offset, pretendRank, READCHECK, ioBuffers);
   }
   return amtXferred;
 }
 
-static void prefillSegment(IOR_param_t *test, void * randomPrefillBuffer, int pretendRank, aiori_fd_t *fd, IOR_io_buffers *ioBuffers, int startSegment, int endSegment){
+static void prefillSegment(IOR_param_t *test, void * randomPrefillBuffer, int pretendRank, aiori_fd_t *fd, int startSegment, int endSegment){
   // prefill the whole file already with an invalid pattern
   int offsets = test->blockSize / test->randomPrefillBlocksize;
-  void * oldBuffer = ioBuffers->buffer;
+  /* the prefill buffer is private, also with sharedPatternBuffer */
+  IOR_io_buffers prefillBuffers = {.buffer = randomPrefillBuffer};
   int errors;
-  ioBuffers->buffer = randomPrefillBuffer;
   for (IOR_offset_t i = startSegment; i < endSegment; i++){
     for (int j = 0; j < offsets; j++) {
       IOR_offset_t offset = j * test->randomPrefillBlocksize;
@@ -1735,12 +2514,95 @@ static void prefillSegment(IOR_param_t *test, void * randomPrefillBuffer, int pr
       } else {
         offset += (i * test->numTasks * test->blockSize) + (pretendRank * test->blockSize);
       }
-      WriteOrReadSingle(offset, pretendRank, test->randomPrefillBlocksize, & errors, test, fd, ioBuffers, WRITE, NULL, 0);
+      WriteOrReadSingle(offset, pretendRank, test->randomPrefillBlocksize, & errors, test, fd, & prefillBuffers, WRITE, NULL, 0);
     }
   }
-  ioBuffers->buffer = oldBuffer;
 }
 
+#if MPI_VERSION >= 3
+/*
+ * Work stealing for stoneWallingWearOut: instead of each task catching up to
+ * the maximum number of pairs on its own, the missing transfers of all tasks
+ * are numbered and handed out by a shared counter on rank 0.  A transfer is
+ * accessed with the pattern of the task owning it, hence data written by
+ * another task is read back and verified as if the owner had written it.
+ */
+static IOR_offset_t StealRemainingTransfers(IOR_param_t *test, IOR_point_t *point, uint64_t pairCnt,
+                                            int pretendRank, int *errors, aiori_fd_t *fd,
+                                            IOR_io_buffers *ioBuffers, int access, OpTimer *ot,
+                                            double startForStonewall)
+{
+        MPI_Comm comm = test->testComm;
+        int tasks = test->numTasks;
+        IOR_offset_t offsets = test->blockSize / test->transferSize;
+        IOR_offset_t dataMoved = 0;
+        long long mine[2] = {(long long) (point->pairs_accessed - pairCnt), pretendRank};
+        long long *missing = safeMalloc(sizeof(long long) * 2 * tasks); /* missing pairs and pretendRank of each task */
+        long long total = 0, counter = 0, next, stolen = 0;
+        const long long one = 1;
+        int patternRank = pretendRank;
+        MPI_Win win;
+
+        MPI_CHECK(MPI_Allgather(mine, 2, MPI_LONG_LONG_INT, missing, 2, MPI_LONG_LONG_INT, comm),
+                  "cannot gather missing pairs");
+        for (int t = 0; t < tasks; t++)
+                total += missing[2 * t];
+
+        MPI_CHECK(MPI_Win_create(&counter, rank == 0 ? sizeof(counter) : 0, sizeof(counter),
+                                 MPI_INFO_NULL, comm, &win), "cannot create window");
+        MPI_CHECK(MPI_Win_lock_all(0, win), "cannot lock window");
+        while (1) {
+                MPI_CHECK(MPI_Fetch_and_op(&one, &next, MPI_LONG_LONG_INT, 0, 0, MPI_SUM, win),
+                          "cannot fetch next transfer");
+                MPI_CHECK(MPI_Win_flush(0, win), "cannot flush window");
+                if (next >= total)
+                        break;
+
+                int owner = 0;
+                long long first = 0;
+                while (next >= first + missing[2 * owner]) {
+                        first += missing[2 * owner];
+                        owner++;
+                }
+                int ownerRank = (int) missing[2 * owner + 1];
+                uint64_t pair = point->pairs_accessed - missing[2 * owner] + (next - first);
+                IOR_offset_t segment = (pair / offsets) % test->segmentCount;
+                IOR_offset_t offset = (pair % offsets) * test->transferSize
+                        + segment * tasks * test->blockSize + ownerRank * test->blockSize;
+
+                if (access == WRITE && ownerRank != patternRank) {
+                        /* the buffer carries the pattern of the task it is written for */
+                        generate_memory_pattern((char *) ioBuffers->buffer, test->transferSize,
+                                                test->timeStampSignatureValue, ownerRank,
+                                                test->dataPacketType, test->gpuMemoryFlags);
+                        patternRank = ownerRank;
+                }
+                dataMoved += WriteOrReadSingle(offset, ownerRank, test->transferSize, errors, test, fd,
+                                               ioBuffers, access, ot, startForStonewall);
+                if (ownerRank != pretendRank) {
+                        stolen++;
+                        if (verbose >= VERBOSE_2)
+                                fprintf(out_logfile, "%d: accessed offset %lld on behalf of task %d\n",
+                                        rank, (long long) offset, ownerRank);
+                }
+        }
+        if (patternRank != pretendRank)
+                generate_memory_pattern((char *) ioBuffers->buffer, test->transferSize,
+                                        test->timeStampSignatureValue, pretendRank,
+                                        test->dataPacketType, test->gpuMemoryFlags);
+        MPI_CHECK(MPI_Win_unlock_all(win), "cannot unlock window");
+        MPI_CHECK(MPI_Win_free(&win), "cannot free window");
+        free(missing);
+
+        MPI_CHECK(MPI_Reduce(&stolen, &point->stonewall_stolen_pairs, 1, MPI_LONG_LONG_INT, MPI_SUM, 0, comm),
+                  "cannot reduce stolen pairs");
+        if (rank == 0 && verbose >= VERBOSE_1)
+                fprintf(out_logfile, "stonewalling work stealing: %lld of %lld remaining pairs accessed by another task\n",
+                        point->stonewall_stolen_pairs, total);
+        return dataMoved;
+}
+#endif
+
 /*
  * Write or Read data to file(s).  This loops through the strides, writing
  * out the data to each block in transfer sizes, until the remainder left is 0.
@@ -1795,7 +2657,7 @@ static IOR_offset_t WriteOrRead(IOR_param_t *test, int rep, IOR_results_t *resul
 
         if(randomPrefillBuffer && test->deadlineForStonewalling == 0){
           double t_start = GetTimeStamp();
-          prefillSegment(test, randomPrefillBuffer, pretendRank, fd, ioBuffers, 0, test->segmentCount);
+          prefillSegment(test, randomPrefillBuffer, pretendRank, fd, 0, test->segmentCount);
           if(rank == 0 && verbose > VERBOSE_1){
             fprintf(out_logfile, "Random prefill took: %fs\n", GetTimeStamp() - t_start);
           }
@@ -1808,7 +2670,7 @@ static IOR_offset_t WriteOrRead(IOR_param_t *test, int rep, IOR_results_t *resul
             if(randomPrefillBuffer && test->deadlineForStonewalling != 0){
               // prefill the whole segment with data, this needs to be done collectively
               double t_start = GetTimeStamp();
-              prefillSegment(test, randomPrefillBuffer, pretendRank, fd, ioBuffers, i, i+1);
+              prefillSegment(test, randomPrefillBuffer, pretendRank, fd, i, i+1);
               MPI_Barrier(test->testComm);
               if(rank == 0 && verbose > VERBOSE_1){
                 fprintf(out_logfile, "Random: synchronizing segment count with barrier and prefill took: %fs\n", GetTimeStamp() - t_start);
@@ -1862,18 +2724,17 @@ static IOR_offset_t WriteOrRead(IOR_param_t *test, int rep, IOR_results_t *resul
           if (verbose >= VERBOSE_1){
             fprintf(out_logfile, "%d: stonewalling pairs accessed: %lld\n", rank, (long long) pairCnt);
           }
-          long long data_moved_ll = (long long) dataMoved;
-          long long pairs_accessed_min = 0;
-          MPI_CHECK(MPI_Allreduce(& pairCnt, &point->pairs_accessed,
-                                  1, MPI_LONG_LONG_INT, MPI_MAX, testComm), "cannot reduce pairs moved");
+          ior_phase_stats_t stats;
+          memset(& stats, 0, sizeof(stats));
+          PhaseStatsSetInt(& stats, IOR_ISTAT_PAIRS, pairCnt);
+          PhaseStatsSetInt(& stats, IOR_ISTAT_DATA_MOVED, dataMoved);
+          PhaseStatsAllreduce(& stats, testComm);
+          point->pairs_accessed = stats.ival[IOR_ISTAT_PAIRS].max;
           double stonewall_runtime = GetTimeStamp() - startForStonewall;
           point->stonewall_time = stonewall_runtime;
-          MPI_CHECK(MPI_Reduce(& pairCnt, & pairs_accessed_min,
-                                  1, MPI_LONG_LONG_INT, MPI_MIN, 0, testComm), "cannot reduce pairs moved");
-          MPI_CHECK(MPI_Reduce(& data_moved_ll, &point->stonewall_min_data_accessed,
-                                  1, MPI_LONG_LONG_INT, MPI_MIN, 0, testComm), "cannot reduce pairs moved");
-          MPI_CHECK(MPI_Reduce(& data_moved_ll, &point->stonewall_total_data_accessed,
-                                  1, MPI_LONG_LONG_INT, MPI_SUM, 0, testComm), "cannot reduce pairs moved");
+          long long pairs_accessed_min = stats.ival[IOR_ISTAT_PAIRS].min;
+          point->stonewall_min_data_accessed = stats.ival[IOR_ISTAT_DATA_MOVED].min;
+          point->stonewall_total_data_accessed = stats.ival[IOR_ISTAT_DATA_MOVED].sum;
 
           if(rank == 0){
             point->stonewall_avg_data_accessed = point->stonewall_total_data_accessed / test->numTasks;
@@ -1881,6 +2742,12 @@ static IOR_offset_t WriteOrRead(IOR_param_t *test, int rep, IOR_results_t *resul
              pairs_accessed_min, point->pairs_accessed,
              point->stonewall_min_data_accessed /1024.0 / 1024 / 1024, point->stonewall_avg_data_accessed / 1024.0 / 1024 / 1024 , point->stonewall_time);
           }
+#if MPI_VERSION >= 3
+          if(test->stoneWallingWorkStealing){
+            dataMoved += StealRemainingTransfers(test, point, pairCnt, pretendRank, & errors, fd, ioBuffers,
+                                                 access, ot, startForStonewall);
+          }else
+#endif
           if(pairCnt != point->pairs_accessed){
             // some work needs still to be done, complete the current block !
             i--;
@@ -1937,3 +2804,331 @@ static IOR_offset_t WriteOrRead(IOR_param_t *test, int rep, IOR_results_t *resul
 
         return (dataMoved);
 }
+
+/*
+ * Auto-tuning: a coordinate descent over the discrete values of the tuned
+ * parameters.  Every trial is a short, stonewalled run of the test, the
+ * objective is the bandwidth averaged over its write and read phases.
+ */
+typedef struct {
+        int idx[IOR_MAX_SWEEP_DIMS];     /* index into the values of each parameter */
+        double score;                    /* bandwidth in bytes/s, -1 if invalid */
+} autotune_point_t;
+
+typedef struct {
+        IOR_test_t *base;
+        IOR_offset_t *values[IOR_MAX_SWEEP_DIMS];
+        int counts[IOR_MAX_SWEEP_DIMS];
+        autotune_point_t *points;        /* evaluated points */
+        int pointCount;
+        int testCount;
+        IOR_test_t *head;                /* trials, for the summary */
+        IOR_test_t *tail;
+        double startTime;
+        double elapsed;                  /* seconds spent, as seen by rank 0 */
+} autotune_t;
+
+/* two-sided 95% quantiles of Student's t-distribution for 1..30 degrees of freedom */
+static const double student_t95[] = {12.706, 4.303, 3.182, 2.776, 2.571, 2.447,
+        2.365, 2.306, 2.262, 2.228, 2.201, 2.179, 2.160, 2.145, 2.131, 2.120,
+        2.110, 2.101, 2.093, 2.086, 2.080, 2.074, 2.069, 2.064, 2.060, 2.056,
+        2.052, 2.048, 2.045, 2.042};
+
+/*
+ * Mean bandwidth of a test across repetitions and its sample standard
+ * deviation, only valid on rank 0.
+ */
+static double TestMeanBandwidth(IOR_test_t *test, double *sd)
+{
+        IOR_param_t *params = &test->params;
+        int reps = params->repetitions;
+        double sum = 0, sumsq = 0;
+
+        for (int i = 0; i < reps; i++) {
+                IOR_results_t *r = &test->results[i];
+                double bw = 0;
+                int phases = 0;
+                if (params->writeFile && r->write.time > 0) {
+                        bw += r->write.aggFileSizeForBW / r->write.time;
+                        phases++;
+                }
+                if ((params->readFile || params->checkRead) && r->read.time > 0) {
+                        bw += r->read.aggFileSizeForBW / r->read.time;
+                        phases++;
+                }
+                if (phases > 0)
+                        bw /= phases;
+                sum += bw;
+                sumsq += bw * bw;
+        }
+        *sd = 0;
+        if (reps > 1)
+                *sd = sqrt(fmax(0, (sumsq - sum * sum / reps) / (reps - 1)));
+        return sum / reps;
+}
+
+static int AutotuneValues(IOR_sweep_t *range, int worldSize, IOR_offset_t **values)
+{
+        IOR_offset_t stop = range->stop == -1 ? worldSize : range->stop;
+        IOR_offset_t v;
+        int count = 0;
+
+        for (v = range->start; v <= stop; v = range->multiply ? v * range->step : v + range->step)
+                count++;
+        *values = safeMalloc(sizeof(IOR_offset_t) * count);
+        count = 0;
+        for (v = range->start; v <= stop; v = range->multiply ? v * range->step : v + range->step)
+                (*values)[count++] = v;
+        return count;
+}
+
+/*
+ * Run the test with the values of the point idx, returns NULL if the values
+ * do not form a valid configuration.
+ */
+static IOR_test_t *AutotuneRun(autotune_t *at, int *idx, int reps)
+{
+        IOR_param_t params = at->base->params;
+        IOR_test_t *test;
+        int worldSize;
+
+        MPI_CHECK(MPI_Comm_size(params.mpi_comm_world, &worldSize), "cannot get number of tasks");
+        for (int d = 0; d < params.tuneDims; d++) {
+                params.tune[d].value = at->values[d][idx[d]];
+                ApplyTunedValue(&params, params.tune[d].key, params.tune[d].value);
+        }
+        if (params.transferSize <= 0 || params.blockSize < params.transferSize
+            || params.blockSize % params.transferSize != 0
+            || params.numTasks <= 0 || params.numTasks > worldSize)
+                return NULL;
+
+        if (params.deadlineForStonewalling == 0) {
+                params.deadlineForStonewalling = params.autotuneTrialTime;
+                params.stoneWallingWearOut = 1;
+        }
+        params.repetitions = reps;
+        params.expectedAggFileSize = params.blockSize * params.segmentCount * params.numTasks;
+        ValidateTests(&params, params.mpi_comm_world);
+
+        test = CreateTest(&params, at->testCount++);
+        AllocResults(test);
+        if (at->tail == NULL)
+                at->head = test;
+        else
+                at->tail->next = test;
+        at->tail = test;
+
+        if (test_initialize(test, NULL)) {
+                totalErrorCount = 0;
+                TestIoSys(test);
+                test->results->errors = totalErrorCount;
+                ShowTestEnd(test);
+                test_finalize(test, NULL);
+        }
+        return test;
+}
+
+/*
+ * Bandwidth of the point idx, runs a trial unless it was evaluated before.
+ */
+static double AutotuneEvaluate(autotune_t *at, int *idx)
+{
+        IOR_param_t *params = &at->base->params;
+        autotune_point_t *point;
+        IOR_test_t *test;
+        double result[2] = {-1, 0};
+        double sd;
+
+        for (int i = 0; i < at->pointCount; i++) {
+                if (memcmp(at->points[i].idx, idx, sizeof(int) * IOR_MAX_SWEEP_DIMS) == 0)
+                        return at->points[i].score;
+        }
+
+        test = AutotuneRun(at, idx, params->repetitions);
+        if (test != NULL && rank == 0)
+                result[0] = TestMeanBandwidth(test, &sd);
+        result[1] = GetTimeStamp() - at->startTime;
+        MPI_CHECK(MPI_Bcast(result, 2, MPI_DOUBLE, 0, params->mpi_comm_world),
+                  "cannot broadcast trial result");
+        at->elapsed = result[1];
+
+        at->points = realloc(at->points, sizeof(autotune_point_t) * (at->pointCount + 1));
+        if (at->points == NULL)
+                ERR("realloc() of autotune points failed");
+        point = &at->points[at->pointCount++];
+        memcpy(point->idx, idx, sizeof(int) * IOR_MAX_SWEEP_DIMS);
+        point->score = result[0];
+
+        if (rank == 0 && test != NULL)
+                PrintAutotuneTrial(&test->params, at->pointCount, point->score);
+        return point->score;
+}
+
+static IOR_test_t *Autotune(IOR_test_t *base)
+{
+        IOR_param_t *params = &base->params;
+        autotune_t at;
+        int cur[IOR_MAX_SWEEP_DIMS];
+        int worldSize;
+        int improved = 1;
+        double bestScore;
+        double mean = 0, sd, ci = 0;
+        IOR_test_t *best;
+
+        if (base->next != NULL)
+                ERR("--autotune supports a single test only");
+        MPI_CHECK(MPI_Comm_size(params->mpi_comm_world, &worldSize), "cannot get number of tasks");
+
+        if (params->tuneDims == 0) {
+                /* by default tune the transfer size up to the block size */
+                IOR_sweep_t *range = &params->tune[params->tuneDims++];
+                memset(range, 0, sizeof(IOR_sweep_t));
+                strcpy(range->key, "transferSize");
+                range->start = params->blockSize / 1024 > 4096 ? params->blockSize / 1024 : 4096;
+                range->start = range->start > params->blockSize ? params->blockSize : range->start;
+                range->stop = params->blockSize;
+                range->step = 2;
+                range->multiply = 1;
+        }
+
+        memset(&at, 0, sizeof(at));
+        memset(cur, 0, sizeof(cur));
+        at.base = base;
+        at.startTime = GetTimeStamp();
+        for (int d = 0; d < params->tuneDims; d++) {
+                at.counts[d] = AutotuneValues(&params->tune[d], worldSize, &at.values[d]);
+                cur[d] = at.counts[d] / 2;
+        }
+
+        bestScore = AutotuneEvaluate(&at, cur);
+        while (improved && at.elapsed < params->autotuneBudget) {
+                improved = 0;
+                for (int d = 0; d < params->tuneDims && at.elapsed < params->autotuneBudget; d++) {
+                        /* move along this parameter as long as a neighbor is better */
+                        while (at.elapsed < params->autotuneBudget) {
+                                int bestDir = 0;
+                                for (int dir = -1; dir <= 1 && at.elapsed < params->autotuneBudget; dir += 2) {
+                                        int cand[IOR_MAX_SWEEP_DIMS];
+                                        double score;
+                                        memcpy(cand, cur, sizeof(cand));
+                                        cand[d] += dir;
+                                        if (cand[d] < 0 || cand[d] >= at.counts[d])
+                                                continue;
+                                        score = AutotuneEvaluate(&at, cand);
+                                        if (score > bestScore) {
+                                                bestScore = score;
+                                                bestDir = dir;
+                                        }
+                                }
+                                if (bestDir == 0)
+                                        break;
+                                cur[d] += bestDir;
+                                improved = 1;
+                        }
+                }
+        }
+        if (bestScore < 0)
+                ERR("autotune found no valid configuration, transferSize must divide blockSize");
+
+        /* measure the best configuration to provide a confidence interval */
+        best = AutotuneRun(&at, cur, params->autotuneRepetitions);
+        if (rank == 0) {
+                int reps = best->params.repetitions;
+                mean = TestMeanBandwidth(best, &sd);
+                if (reps > 1)
+                        ci = (reps - 1 <= 30 ? student_t95[reps - 2] : 1.96) * sd / sqrt(reps);
+        }
+        autotuneResult.best = best;
+        autotuneResult.trials = at.pointCount;
+        autotuneResult.elapsed = GetTimeStamp() - at.startTime;
+        autotuneResult.bw = mean;
+        autotuneResult.ci = ci;
+
+        for (int d = 0; d < params->tuneDims; d++)
+                free(at.values[d]);
+        free(at.points);
+        FreeResults(base);
+        free(base);
+        return at.head;
+}
+
+/*
+ * Concurrent tests: a test with the concurrent flag runs at the same time as
+ * the preceding test(s) on the following ranks.  The n-th write or read phase
+ * of all tests of the set starts at the same time; tests with fewer phases
+ * keep joining the synchronization after they are done.
+ */
+static MPI_Comm concurrentComm = MPI_COMM_NULL;
+static int concurrentSyncs;             /* phase starts left to synchronize */
+
+static void ConcurrentPhaseSync(void)
+{
+        if (concurrentComm == MPI_COMM_NULL)
+                return;
+        MPI_CHECK(MPI_Barrier(concurrentComm), "barrier error");
+        concurrentSyncs--;
+}
+
+/*
+ * Run the set of concurrent tests starting with first, returns its last test.
+ */
+static IOR_test_t *RunConcurrentTests(IOR_test_t *first)
+{
+        MPI_Comm com = first->params.mpi_comm_world;
+        IOR_test_t *tptr, *last = first, *mine = NULL;
+        FILE *saved_resultfile = out_resultfile;
+        int worldRank;
+
+        MPI_CHECK(MPI_Comm_rank(com, &worldRank), "cannot get rank");
+        for (tptr = first; tptr != NULL && (tptr == first || tptr->params.concurrent); tptr = tptr->next) {
+                IOR_param_t *p = &tptr->params;
+                last = tptr;
+                if (worldRank >= p->firstRank && worldRank < p->firstRank + p->numTasks)
+                        mine = tptr;
+        }
+
+        MPI_CHECK(MPI_Comm_split(com, mine != NULL ? 0 : MPI_UNDEFINED, 0, &concurrentComm),
+                  "MPI_Comm_split() error");
+        if (mine != NULL) {
+                IOR_param_t *p = &mine->params;
+                int planned = p->repetitions * ((p->writeFile ? 1 : 0) + ((p->readFile || p->checkRead) ? 1 : 0));
+                MPI_CHECK(MPI_Allreduce(&planned, &concurrentSyncs, 1, MPI_INT, MPI_MAX, concurrentComm),
+                          "MPI_Allreduce() error");
+                /* only the first test reports while running, the others are in the summary */
+                if (p->concurrentGroup > 0) {
+                        out_resultfile = fopen("/dev/null", "w");
+                        if (out_resultfile == NULL)
+                                out_resultfile = saved_resultfile;
+                }
+        }
+
+        if (test_initialize(mine != NULL ? mine : first, NULL)) {
+                totalErrorCount = 0;
+                TestIoSys(mine);
+                mine->results->errors = totalErrorCount;
+                while (concurrentSyncs > 0)
+                        ConcurrentPhaseSync();
+                ShowTestEnd(mine);
+                test_finalize(mine, NULL);
+        }
+        if (out_resultfile != saved_resultfile) {
+                fclose(out_resultfile);
+                out_resultfile = saved_resultfile;
+        }
+        if (concurrentComm != MPI_COMM_NULL)
+                MPI_CHECK(MPI_Comm_free(&concurrentComm), "MPI_Comm_free() error");
+
+        /* the first task of each other test sends its results to rank 0 */
+        for (tptr = first->next; tptr != last->next; tptr = tptr->next) {
+                int count = sizeof(IOR_results_t) * tptr->params.repetitions;
+                if (worldRank == tptr->params.firstRank) {
+                        MPI_CHECK(MPI_Send(tptr->results, count, MPI_BYTE, 0,
+                                           tptr->params.concurrentGroup, com), "MPI_Send() error");
+                } else if (worldRank == 0) {
+                        MPI_CHECK(MPI_Recv(tptr->results, count, MPI_BYTE, tptr->params.firstRank,
+                                           tptr->params.concurrentGroup, com, MPI_STATUS_IGNORE),
+                                  "MPI_Recv() error");
+                }
+        }
+        return last;
+}
@@ -51,6 +51,8 @@ typedef struct IO_BUFFERS
     void* buffer;
     void* checkBuffer;
     void* readCheckBuffer;
+    void* header;                 /* sharedPatternBuffer: the private start of each transfer */
+    void* readBuffer;             /* sharedPatternBuffer: read into this, the shared buffer is read-only */
 
 } IOR_io_buffers;
 
@@ -68,6 +70,24 @@ typedef struct IO_BUFFERS
  *         USER_GUIDE
  */
 
+#define IOR_MAX_SWEEP_DIMS 8
+
+/*
+ * A parameter swept over a range, given as "key=START..STOP[:xFACTOR|:+STEP]",
+ * or tuned within it, given as "tune=key:START..STOP[:xFACTOR|:+STEP]".
+ * Before expansion start/stop/step describe the range, afterwards every
+ * generated test carries the value of its point.
+ */
+typedef struct
+{
+    char key[64];                    /* name of the swept directive */
+    IOR_offset_t start;              /* first value */
+    IOR_offset_t stop;               /* last value, -1 for "max" (numTasks) */
+    IOR_offset_t step;               /* increment or factor */
+    int multiply;                    /* step is a factor, not an increment */
+    IOR_offset_t value;              /* value of this point of the sweep */
+} IOR_sweep_t;
+
 typedef struct
 {
     const struct ior_aiori * backend;
@@ -86,9 +106,17 @@ typedef struct
     int dualMount;                   /* dual mount points */
     ior_memory_flags gpuMemoryFlags;  /* use the GPU to store the data */
     int gpuDirect;                /* use gpuDirect, this influences gpuMemoryFlags as well */
+    int sharedPatternBuffer;      /* the tasks of a node write from one buffer in MPI shared memory */
+    int resourceAccounting;       /* resources used per phase, 1: of the tasks, 2: also devices of the nodes */
+    int perfCounters;             /* count hardware events while reading or writing */
     int gpuID;                       /* the GPU to use for gpuDirect or memory options */
     int numTasks;                    /* number of tasks for test */
     int numNodes;                    /* number of nodes for test */
+    int selectNodes;                 /* run on all tasks of the first numNodes nodes */
+    int concurrent;                  /* run at the same time as the previous test, on the next ranks */
+    int concurrentGroup;             /* index within a set of concurrent tests, -1 if not concurrent */
+    int firstRank;                   /* first rank of mpi_comm_world running the test */
+    int strongScaling;               /* with selectNodes: blockSize is the work of a single node */
     int numTasksOnNode0;             /* number of tasks on node 0 (usually all the same, but don't have to be, use with caution) */
     int tasksBlockMapping;           /* are the tasks in contiguous blocks across nodes or round-robin */
     int repetitions;                 /* number of repetitions of test */
@@ -104,6 +132,11 @@ typedef struct
     int taskPerNodeOffset;           /* task node offset for reading files   */
     int reorderTasksRandom;          /* reorder tasks for random file read back */
     int reorderTasksRandomSeed;      /* reorder tasks for random file read seed */
+    int reorderTasksTopology;        /* reorder tasks for read back by distance in the node topology */
+    char * topologyFile;             /* lines of "host switch [rack]" for reorderTasksTopology */
+    char * cpuBind;                  /* bind tasks to CPUs: none, core, share or numa */
+    char * numaNode;                 /* NUMA node of the buffers: a number, file or a device name */
+    char * hugePages;                /* pages backing the buffers: none, thp, 2m or 1g */
     int checkWrite;                  /* check read after write */
     int checkRead;                   /* check read after read */
     int keepFile;                    /* don't delete the testfile on exit */
@@ -117,6 +150,7 @@ typedef struct
 
     char * savePerOpDataCSV;            /* save details about each I/O operation into this file */
     char * saveRankDetailsCSV;       /* save the details about the performance to a file */
+    int saveRankDetailsBinary;       /* the details file holds IOR_rank_record_t instead of CSV */
     int summary_every_test;          /* flag to print summary every test, not just at end */
     int uniqueDir;                   /* use unique directory for each fpp */
     int useExistingTestFile;         /* do not delete test file before access */
@@ -125,6 +159,7 @@ typedef struct
     int minTimeDuration;             /* minimum runtime */
     uint64_t stoneWallingWearOutIterations; /* the number of iterations for the stonewallingWearOut, needed for readBack */
     char * stoneWallingStatusFile;
+    int stoneWallingWorkStealing;    /* during the wear out, tasks take over the missing transfers of slower tasks */
 
     int maxTimeDuration;             /* max time in minutes to run each test */
     int outlierThreshold;            /* warn on outlier N seconds from mean */
@@ -154,9 +189,32 @@ typedef struct
     int intraTestBarriers;           /* barriers between open/op and op/close */
     int warningAsErrors;             /* treat any warning as an error */
 
+    int sweepDims;                   /* number of swept parameters */
+    IOR_sweep_t sweep[IOR_MAX_SWEEP_DIMS]; /* swept parameters */
+    IOR_offset_t sweepBufferSize;    /* largest transferSize of the sweep */
+
+    int autotune;                    /* search the tuned parameters for the best bandwidth */
+    int autotuneBudget;              /* time budget of the search in seconds */
+    int autotuneTrialTime;           /* stonewalling deadline of a trial in seconds */
+    int autotuneRepetitions;         /* repetitions to measure the best configuration */
+    int tuneDims;                    /* number of tuned parameters */
+    IOR_sweep_t tune[IOR_MAX_SWEEP_DIMS]; /* bounds of the tuned parameters */
+
     aiori_xfer_hint_t hints;
 } IOR_param_t;
 
+/* record of a task in a binary per-rank details file */
+typedef struct {
+   int32_t rank;
+   int32_t access;                  /* WRITE or READ */
+   int32_t testID;
+   int32_t iteration;
+   double  runtimeWithOpenClose;
+   double  runtime;
+   double  throughputWithOpenClose;
+   double  throughput;
+} IOR_rank_record_t;
+
 /* each pointer for a single test */
 typedef struct {
    double time;
@@ -166,6 +224,9 @@ typedef struct {
    long long  stonewall_min_data_accessed; // of all processes
    long long  stonewall_avg_data_accessed; // across all processes
    long long  stonewall_total_data_accessed; // sum accross all processes
+   long long  stonewall_stolen_pairs; // transfers done on behalf of other processes during the wear out
+   double     resources[IOR_NB_RES]; // used in the phase, summed over all processes
+   double     perf[IOR_NB_PERF]; // hardware events while transferring, summed over all processes, NAN if unavailable
 
    IOR_offset_t aggFileSizeFromStat;
    IOR_offset_t aggFileSizeFromXfer;
@@ -187,6 +248,7 @@ typedef struct IOR_test_t {
 
 IOR_test_t *CreateTest(IOR_param_t *init_params, int test_num);
 void AllocResults(IOR_test_t *test);
+void FreeResults(IOR_test_t *test);
 
 char * GetPlatformName(void);
 void init_IOR_Param_t(IOR_param_t *p, MPI_Comm global_com);
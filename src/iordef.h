@@ -33,6 +33,35 @@ typedef enum{
     IOR_MEMORY_TYPE_GPU_DEVICE_ONLY = 3,
 } ior_memory_flags;
 
+/* resources used by a phase, see ResourcesSample() */
+enum {
+  IOR_RES_CPU_USER,     /* CPU seconds in user space */
+  IOR_RES_CPU_SYS,      /* CPU seconds in the kernel */
+  IOR_RES_VOL_CTXSW,    /* voluntary context switches */
+  IOR_RES_INVOL_CTXSW,  /* involuntary context switches */
+  IOR_RES_MINFLT,       /* page faults served without I/O */
+  IOR_RES_MAJFLT,       /* page faults requiring I/O */
+  IOR_RES_SYSCR,        /* read-like system calls */
+  IOR_RES_SYSCW,        /* write-like system calls */
+  IOR_RES_READ_BYTES,   /* bytes the task caused to be read from storage */
+  IOR_RES_WRITE_BYTES,  /* bytes the task caused to be sent to storage */
+  IOR_RES_DISK_READ,    /* bytes read by the block devices of the node */
+  IOR_RES_DISK_WRITE,   /* bytes written by the block devices of the node */
+  IOR_RES_NET_RX,       /* bytes received by the network interfaces of the node */
+  IOR_RES_NET_TX,       /* bytes sent by the network interfaces of the node */
+  IOR_NB_RES
+};
+
+/* hardware events counted by a phase, see PerfCountersStop() */
+enum {
+  IOR_PERF_CYCLES,
+  IOR_PERF_INSTRUCTIONS,
+  IOR_PERF_CACHE_REFS,     /* last level cache references */
+  IOR_PERF_CACHE_MISSES,   /* last level cache misses */
+  IOR_PERF_DTLB_MISSES,    /* data TLB load misses */
+  IOR_NB_PERF
+};
+
 #ifdef _WIN32
 #   define _CRT_SECURE_NO_WARNINGS
 #   define _CRT_RAND_S
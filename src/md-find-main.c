@@ -0,0 +1,13 @@
+#include <mpi.h>
+#include <stdlib.h>
+
+#include "md-find.h"
+
+int main(int argc, char ** argv){
+  MPI_Init(& argc, & argv);
+  mdfind_results_t * results = md_find_run(argc, argv, MPI_COMM_WORLD, stdout);
+  int ret = results->errors ? 1 : 0;
+  free(results);
+  MPI_Finalize();
+  return ret;
+}
@@ -0,0 +1,505 @@
+#include <mpi.h>
+
+#include <time.h>
+#include <stdio.h>
+#include <errno.h>
+#include <string.h>
+#include <stdlib.h>
+#include <dirent.h>
+#include <sys/stat.h>
+
+#include "md-find.h"
+#include "config.h"
+#include "aiori.h"
+#include "utilities.h"
+#include "parse_options.h"
+
+/*
+md-find walks a directory tree in parallel, like find or du it stats every entry.
+The tree can be created by mdtest or any existing tree, symbolic links are not followed.
+
+Each process keeps a stack of the directories it found but did not list yet.
+A process without directories requests work from a random process, which replies with
+the older half of its stack, that are the directories close to the top of the tree.
+Termination is detected with a token passed around the ring of processes (Dijkstra):
+a process forwards the token once it has no directories, a process that gave directories
+to a process of a higher rank colors the token, and rank 0 ends the traversal when a
+token returns uncolored.
+ */
+
+#define LLU (long long unsigned)
+
+#define oprintf(...) do { fprintf(o.logfile, __VA_ARGS__); fflush(o.logfile); } while(0);
+
+// the messages of a traversal
+enum { TAG_REQUEST = 1, TAG_WORK, TAG_TOKEN, TAG_DONE };
+// the colors of the processes and the token
+enum { WHITE = 0, BLACK };
+
+struct find_options{
+  ior_aiori_t const * backend;
+  void * backend_options;
+  aiori_xfer_hint_t hints;
+  MPI_Comm com;
+  FILE * logfile;
+
+  char * interface;
+  char * directory; // directory to traverse
+  int iterations;
+  int scaling;
+  int poll_entries;
+
+  int verbosity;
+  int process_report;
+  int quiet_output;
+
+  int rank;
+  int size;
+
+  mdfind_results_t * results; // the results
+};
+
+static struct find_options o;
+
+// the state of a process during a traversal
+typedef struct{
+  MPI_Comm com;
+  int rank;
+  int size;
+
+  // the directories to list, the oldest first
+  char ** dirs;
+  size_t count;
+  size_t capacity;
+
+  // termination detection
+  int color;
+  int has_token;
+  int token_color;
+  int round_started; // rank 0: the token was sent
+  int done;
+
+  unsigned seed;
+  int since_poll;
+
+  // statistics of the process
+  uint64_t entries;
+  uint64_t listed;
+  uint64_t bytes;
+  uint64_t errors;
+  uint64_t steal_requests;
+  uint64_t steals;
+  double busy;
+} walk_t;
+
+// a directory that is listed
+typedef struct{
+  walk_t * w;
+  const char * path;
+  size_t len;
+} listing_t;
+
+static void init_options(){
+  o = (struct find_options){
+  .interface = "POSIX",
+  .directory = "./out",
+  .iterations = 1,
+  .poll_entries = 128,
+  };
+}
+
+static void push_dir(walk_t * w, char * path){
+  if (w->count == w->capacity){
+    w->capacity = w->capacity ? w->capacity * 2 : 1024;
+    w->dirs = realloc(w->dirs, w->capacity * sizeof(char *));
+    if (w->dirs == NULL){
+      ERR("Out of memory for the directories to list");
+    }
+  }
+  w->dirs[w->count++] = path;
+}
+
+// reply to a request for work with the older half of the directories or none
+static void give_work(walk_t * w, int dest){
+  size_t n = (w->count + 1) / 2;
+  size_t len = 0;
+  char * buf = NULL;
+
+  for (size_t i = 0; i < n; i++){
+    len += strlen(w->dirs[i]) + 1;
+  }
+  if (n > 0){
+    buf = safeMalloc(len);
+    char * p = buf;
+    for (size_t i = 0; i < n; i++){
+      size_t l = strlen(w->dirs[i]) + 1;
+      memcpy(p, w->dirs[i], l);
+      p += l;
+      free(w->dirs[i]);
+    }
+    memmove(w->dirs, w->dirs + n, (w->count - n) * sizeof(char *));
+    w->count -= n;
+    // the token may have passed the receiver already
+    if (dest > w->rank){
+      w->color = BLACK;
+    }
+  }
+  MPI_CHECK(MPI_Send(buf, len, MPI_CHAR, dest, TAG_WORK, w->com), "MPI_Send error");
+  free(buf);
+}
+
+// handle the pending requests, tokens and the termination
+static void serve(walk_t * w){
+  MPI_Status status;
+  int flag;
+
+  for(;;){
+    MPI_CHECK(MPI_Iprobe(MPI_ANY_SOURCE, TAG_REQUEST, w->com, & flag, & status), "MPI_Iprobe error");
+    if (! flag){
+      break;
+    }
+    MPI_CHECK(MPI_Recv(NULL, 0, MPI_CHAR, status.MPI_SOURCE, TAG_REQUEST, w->com, MPI_STATUS_IGNORE), "MPI_Recv error");
+    give_work(w, status.MPI_SOURCE);
+  }
+  MPI_CHECK(MPI_Iprobe(MPI_ANY_SOURCE, TAG_TOKEN, w->com, & flag, & status), "MPI_Iprobe error");
+  if (flag){
+    MPI_CHECK(MPI_Recv(& w->token_color, 1, MPI_INT, status.MPI_SOURCE, TAG_TOKEN, w->com, MPI_STATUS_IGNORE), "MPI_Recv error");
+    w->has_token = 1;
+  }
+  MPI_CHECK(MPI_Iprobe(MPI_ANY_SOURCE, TAG_DONE, w->com, & flag, & status), "MPI_Iprobe error");
+  if (flag){
+    MPI_CHECK(MPI_Recv(NULL, 0, MPI_CHAR, status.MPI_SOURCE, TAG_DONE, w->com, MPI_STATUS_IGNORE), "MPI_Recv error");
+    w->done = 1;
+  }
+}
+
+// forward the token of an idle process, rank 0 ends the traversal or starts the next round
+static void pass_token(walk_t * w){
+  int color = w->color == BLACK ? BLACK : w->token_color;
+
+  w->has_token = 0;
+  if (w->rank == 0){
+    if (w->round_started && color == WHITE){
+      for (int r = 1; r < w->size; r++){
+        MPI_CHECK(MPI_Send(NULL, 0, MPI_CHAR, r, TAG_DONE, w->com), "MPI_Send error");
+      }
+      w->done = 1;
+      return;
+    }
+    w->round_started = 1;
+    color = WHITE;
+  }
+  w->color = WHITE;
+  MPI_CHECK(MPI_Send(& color, 1, MPI_INT, (w->rank + w->size - 1) % w->size, TAG_TOKEN, w->com), "MPI_Send error");
+}
+
+// request directories from a random process, serve the others while waiting for the reply
+static void steal(walk_t * w){
+  MPI_Status status;
+  int victim = rand_r(& w->seed) % (w->size - 1);
+  int flag = 0;
+  int len;
+
+  if (victim >= w->rank){
+    victim++;
+  }
+  w->steal_requests++;
+  MPI_CHECK(MPI_Send(NULL, 0, MPI_CHAR, victim, TAG_REQUEST, w->com), "MPI_Send error");
+  while (! flag){
+    MPI_CHECK(MPI_Iprobe(victim, TAG_WORK, w->com, & flag, & status), "MPI_Iprobe error");
+    if (! flag){
+      serve(w);
+    }
+  }
+  MPI_CHECK(MPI_Get_count(& status, MPI_CHAR, & len), "MPI_Get_count error");
+  char * buf = safeMalloc(len + 1);
+  MPI_CHECK(MPI_Recv(buf, len, MPI_CHAR, victim, TAG_WORK, w->com, MPI_STATUS_IGNORE), "MPI_Recv error");
+  if (len > 0){
+    w->steals++;
+  }
+  for (char * p = buf; p < buf + len; p += strlen(p) + 1){
+    push_dir(w, strdup(p));
+  }
+  free(buf);
+}
+
+static void find_entry(const char * name, unsigned char type, void * arg){
+  listing_t * l = (listing_t *) arg;
+  walk_t * w = l->w;
+  char * path = safeMalloc(l->len + strlen(name) + 2);
+  struct stat buf;
+
+  if (l->len == 1 && l->path[0] == '/'){
+    sprintf(path, "/%s", name);
+  }else{
+    sprintf(path, "%s/%s", l->path, name);
+  }
+  w->entries++;
+  if (o.backend->stat(path, & buf, o.backend_options) != 0){
+    // the stat of the backends follows links, the target of a link may not exist
+    if (type == DT_LNK){
+      free(path);
+      return;
+    }
+    if (o.verbosity){
+      WARNF("unable to stat %s", path);
+    }
+    w->errors++;
+    free(path);
+  }else if (S_ISDIR(buf.st_mode) && type != DT_LNK){
+    push_dir(w, path);
+  }else{
+    w->bytes += buf.st_size;
+    free(path);
+  }
+
+  // large directories are listed by one process, serve the others meanwhile
+  if (++w->since_poll >= o.poll_entries){
+    w->since_poll = 0;
+    serve(w);
+  }
+}
+
+static void list_dir(walk_t * w, const char * path){
+  listing_t l = {.w = w, .path = path, .len = strlen(path)};
+
+  if (o.verbosity >= 2){
+    oprintf("%d: list %s\n", o.rank, path);
+  }
+  if (o.backend->readdir(path, find_entry, & l, o.backend_options) == -1){
+    w->errors++;
+  }
+  w->listed++;
+}
+
+static void walk(walk_t * w){
+  while(! w->done){
+    if (w->count > 0){
+      char * path = w->dirs[--w->count];
+      double start = GetTimeStamp();
+      list_dir(w, path);
+      w->busy += GetTimeStamp() - start;
+      free(path);
+      serve(w);
+      continue;
+    }
+    if (w->size == 1){
+      break;
+    }
+    serve(w);
+    if (w->has_token){
+      pass_token(w);
+    }
+    if (! w->done){
+      steal(w);
+    }
+  }
+
+  // the other processes may wait for replies to their last requests
+  MPI_Request req;
+  int flag = 0;
+  MPI_CHECK(MPI_Ibarrier(w->com, & req), "MPI_Ibarrier error");
+  while (! flag){
+    serve(w);
+    MPI_CHECK(MPI_Test(& req, & flag, MPI_STATUS_IGNORE), "MPI_Test error");
+  }
+}
+
+static void print_process_reports(walk_t * w){
+  double mine[] = {w->entries, w->listed, w->busy, w->steal_requests, w->steals};
+  double * all = NULL;
+  if (w->rank == 0){
+    all = safeMalloc(sizeof(mine) * w->size);
+  }
+  MPI_CHECK(MPI_Gather(mine, 5, MPI_DOUBLE, all, 5, MPI_DOUBLE, 0, w->com), "MPI_Gather error");
+  if (w->rank == 0){
+    for (int r = 0; r < w->size; r++){
+      double * p = all + 5 * r;
+      oprintf("  rank %d entries: %llu dirs: %llu busy: %.3fs steals: %llu of %llu requests\n", r, LLU p[0], LLU p[1], p[2], LLU p[4], LLU p[3]);
+    }
+    free(all);
+  }
+}
+
+// traverse the tree with the processes of com, the statistics are returned on rank 0 of com
+static void run_traversal(MPI_Comm com, mdfind_result_t * res){
+  walk_t w = {0};
+  struct stat buf;
+
+  MPI_CHECK(MPI_Comm_dup(com, & w.com), "MPI_Comm_dup error");
+  MPI_Comm_rank(w.com, & w.rank);
+  MPI_Comm_size(w.com, & w.size);
+  w.seed = w.rank * 1103515245u + 12345;
+  w.has_token = w.rank == 0;
+
+  MPI_CHECK(MPI_Barrier(w.com), "MPI_Barrier error");
+  double start = GetTimeStamp();
+  if (w.rank == 0){
+    w.entries++;
+    if (o.backend->stat(o.directory, & buf, o.backend_options) != 0 || ! S_ISDIR(buf.st_mode)){
+      WARNF("%s is not a directory", o.directory);
+      w.errors++;
+    }else{
+      push_dir(& w, strdup(o.directory));
+    }
+  }
+  walk(& w);
+  double runtime = GetTimeStamp() - start;
+
+  uint64_t sums[] = {w.entries, w.listed, w.bytes, w.errors, w.steal_requests, w.steals};
+  uint64_t totals[6];
+  MPI_CHECK(MPI_Reduce(sums, totals, 6, MPI_UINT64_T, MPI_SUM, 0, w.com), "MPI_Reduce error");
+  double times[] = {runtime, w.busy, -w.busy};
+  double max_times[3];
+  MPI_CHECK(MPI_Reduce(times, max_times, 3, MPI_DOUBLE, MPI_MAX, 0, w.com), "MPI_Reduce error");
+  double busy_sum;
+  MPI_CHECK(MPI_Reduce(& w.busy, & busy_sum, 1, MPI_DOUBLE, MPI_SUM, 0, w.com), "MPI_Reduce error");
+  uint64_t entries_min, entries_max;
+  MPI_CHECK(MPI_Reduce(& w.entries, & entries_min, 1, MPI_UINT64_T, MPI_MIN, 0, w.com), "MPI_Reduce error");
+  MPI_CHECK(MPI_Reduce(& w.entries, & entries_max, 1, MPI_UINT64_T, MPI_MAX, 0, w.com), "MPI_Reduce error");
+
+  if (w.rank == 0){
+    *res = (mdfind_result_t){
+      .procs = w.size,
+      .entries = totals[0], .dirs = totals[1], .bytes = totals[2], .errors = totals[3],
+      .steal_requests = totals[4], .steals = totals[5],
+      .runtime = max_times[0],
+      .rate = totals[0] / max_times[0],
+      .dir_rate = totals[1] / max_times[0],
+      .entries_min = entries_min, .entries_max = entries_max,
+      .busy_min = -max_times[2], .busy_avg = busy_sum / w.size, .busy_max = max_times[1],
+    };
+    if (! o.quiet_output){
+      oprintf("procs: %d entries: %llu dirs: %llu size: %.1f MiB errors: %llu time: %.3fs rate: %.1f entries/s %.1f dirs/s\n",
+        res->procs, LLU res->entries, LLU res->dirs, res->bytes / 1024.0 / 1024, LLU res->errors, res->runtime, res->rate, res->dir_rate);
+      oprintf("  balance entries min/avg/max: %llu/%.1f/%llu (max/avg: %.2f) busy min/avg/max: %.3f/%.3f/%.3fs steals: %llu of %llu requests\n",
+        LLU res->entries_min, (double) res->entries / res->procs, LLU res->entries_max, res->entries_max * (double) res->procs / res->entries,
+        res->busy_min, res->busy_avg, res->busy_max, LLU res->steals, LLU res->steal_requests);
+    }
+  }
+  if (o.process_report){
+    print_process_reports(& w);
+  }
+  free(w.dirs);
+  MPI_Comm_free(& w.com);
+}
+
+// the speedup of the mean rate of every process count relative to the first one
+static void print_scaling(mdfind_results_t * results){
+  double base = 0;
+  oprintf("\nScaling\n%8s %14s %14s %10s %10s\n", "procs", "entries/s", "dirs/s", "speedup", "efficiency");
+  for (int i = 0; i < results->count; i += o.iterations){
+    double rate = 0, dir_rate = 0;
+    for (int j = i; j < i + o.iterations; j++){
+      rate += results->result[j].rate / o.iterations;
+      dir_rate += results->result[j].dir_rate / o.iterations;
+    }
+    if (i == 0){
+      base = rate;
+    }
+    int procs = results->result[i].procs;
+    oprintf("%8d %14.1f %14.1f %10.2f %10.2f\n", procs, rate, dir_rate, rate / base, rate / base / procs * results->result[0].procs);
+  }
+}
+
+static option_help options [] = {
+  {'a', "api", "The API (plugin) to use for the benchmark, use list to show all compiled plugins.", OPTION_OPTIONAL_ARGUMENT, 's', & o.interface},
+  {'d', "directory", "The directory to traverse, e.g., the directory of an mdtest run created with -C", OPTION_OPTIONAL_ARGUMENT, 's', & o.directory},
+  {'i', "iterations", "Number of traversals", OPTION_OPTIONAL_ARGUMENT, 'd', & o.iterations},
+  {0, "scaling", "Traverse with 1, 2, 4, ... processes up to all processes and print the speedup", OPTION_FLAG, 'd', & o.scaling},
+  {0, "poll-entries", "Serve the requests of other processes after this many entries of a directory", OPTION_OPTIONAL_ARGUMENT, 'd', & o.poll_entries},
+  {'q', "quiet", "Avoid irrelevant printing.", OPTION_FLAG, 'd', & o.quiet_output},
+  {0, "process-reports", "Independent report per process/rank", OPTION_FLAG, 'd', & o.process_report},
+  {'v', "verbose", "Increase the verbosity level", OPTION_FLAG, 'd', & o.verbosity},
+  LAST_OPTION
+  };
+
+mdfind_results_t* md_find_run(int argc, char ** argv, MPI_Comm world_com, FILE * logfile){
+  init_options();
+  init_clock(world_com);
+
+  o.com = world_com;
+  o.logfile = logfile;
+  out_logfile = logfile;
+
+  MPI_Comm_rank(o.com, & o.rank);
+  MPI_Comm_size(o.com, & o.size);
+  rank = o.rank;
+
+  if (o.rank == 0 && ! o.quiet_output){
+    oprintf("Args: %s", argv[0]);
+    for(int i=1; i < argc; i++){
+      oprintf(" \"%s\"", argv[i]);
+    }
+    oprintf("\n");
+  }
+
+  memset(& o.hints, 0, sizeof(o.hints));
+
+  options_all_t * global_options = airoi_create_all_module_options(options);
+  option_parse(argc, argv, global_options);
+  o.backend = aiori_select(o.interface);
+  if (o.backend == NULL){
+      ERR("Unrecognized I/O API");
+  }
+  if (! o.backend->enable_mdtest || ! o.backend->readdir || ! o.backend->stat){
+      ERR("Backend doesn't support MD-Find, it requires readdir and stat");
+  }
+  o.backend_options = airoi_update_module_options(o.backend, global_options);
+  if (o.iterations < 1 || o.poll_entries < 1){
+      ERR("The iterations and poll entries must be at least 1");
+  }
+
+  if(o.backend->xfer_hints){
+    o.backend->xfer_hints(& o.hints);
+  }
+  if(o.backend->check_params){
+    o.backend->check_params(o.backend_options);
+  }
+  if (o.backend->initialize){
+    o.backend->initialize(o.backend_options);
+  }
+
+  // the process counts of the traversals
+  int counts[64];
+  int count_num = 0;
+  if (o.scaling){
+    for (int p = 1; p < o.size; p *= 2){
+      counts[count_num++] = p;
+    }
+  }
+  counts[count_num++] = o.size;
+
+  size_t result_count = o.iterations * count_num;
+  o.results = malloc(sizeof(mdfind_results_t) + sizeof(mdfind_result_t) * result_count);
+  memset(o.results, 0, sizeof(mdfind_results_t) + sizeof(mdfind_result_t) * result_count);
+
+  if (o.rank == 0 && ! o.quiet_output){
+    oprintf("MD-Find traversal of %s (version: %s) time: %s", o.directory, PACKAGE_VERSION, CurrentTimeString());
+  }
+
+  for (int c = 0; c < count_num; c++){
+    MPI_Comm com;
+    MPI_CHECK(MPI_Comm_split(o.com, o.rank < counts[c] ? 0 : MPI_UNDEFINED, o.rank, & com), "MPI_Comm_split error");
+    for (int i = 0; i < o.iterations; i++){
+      mdfind_result_t * res = & o.results->result[o.results->count++];
+      if (com != MPI_COMM_NULL){
+        run_traversal(com, res);
+      }
+      o.results->errors += res->errors != 0;
+      MPI_CHECK(MPI_Barrier(o.com), "MPI_Barrier error");
+    }
+    if (com != MPI_COMM_NULL){
+      MPI_Comm_free(& com);
+    }
+  }
+  if (o.rank == 0 && o.scaling && ! o.quiet_output){
+    print_scaling(o.results);
+  }
+  MPI_CHECK(MPI_Bcast(& o.results->errors, 1, MPI_INT, 0, o.com), "MPI_Bcast error");
+
+  if(o.backend->finalize){
+    o.backend->finalize(o.backend_options);
+  }
+  return o.results;
+}
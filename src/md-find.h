@@ -0,0 +1,38 @@
+#ifndef IOR_MD_FIND_H
+#define IOR_MD_FIND_H
+
+#include <stdint.h>
+#include <stdio.h>
+#include <mpi.h>
+
+// statistics for a single traversal
+typedef struct{
+  int procs; // the processes of the traversal
+  uint64_t entries; // entries that were stat'ed, including the top directory
+  uint64_t dirs; // directories that were listed
+  uint64_t bytes; // the size of all entries but directories
+  uint64_t errors; // failed readdir or stat calls
+  double runtime;
+  double rate; // entries per second
+  double dir_rate; // directories per second
+
+  // load balance
+  uint64_t entries_min;
+  uint64_t entries_max;
+  double busy_min; // the time a process listed directories
+  double busy_avg;
+  double busy_max;
+  uint64_t steal_requests;
+  uint64_t steals; // requests that returned directories
+} mdfind_result_t;
+
+typedef struct{
+  int count; // the number of results
+  int errors;
+  mdfind_result_t result[];
+} mdfind_results_t;
+
+// @Return The statistics of every traversal, for --scaling the traversals of each process count follow each other
+mdfind_results_t* md_find_run(int argc, char ** argv, MPI_Comm world_com, FILE * out_logfile);
+
+#endif
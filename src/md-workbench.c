@@ -70,6 +70,9 @@ typedef struct{ // NOTE: if this type is changed, adjust end_phase() !!!
   double max_op_time;
   double phase_start_timer;
   int stonewall_iterations;
+
+  // hardware events of the phase, NAN if not available
+  double perf[IOR_NB_PERF];
 } phase_stat_t;
 
 struct benchmark_options{
@@ -98,6 +101,8 @@ struct benchmark_options{
   ior_memory_flags gpuMemoryFlags;  /* use the GPU to store the data */
   int gpuDirect;                /* use gpuDirect, this influences gpuMemoryFlags as well */
   int gpuID;                       /* the GPU to use for gpuDirect or memory options */
+  char * huge_pages;               /* pages backing the buffers: none, thp, 2m or 1g */
+  int perf_counters;               /* count hardware events per phase */
 
   char * latency_file_prefix;
   int latency_keep_all;
@@ -414,11 +419,33 @@ static void compute_histogram(const char * name, time_result_t * times, time_sta
   stats->max = times[repeats - 1].runtime;
 }
 
+// the hardware events per operation of all processes
+static void print_perf_counters(const char * name, phase_stat_t * p){
+  const double ops = p->dset_create.suc + p->dset_delete.suc + p->obj_create.suc + p->obj_read.suc + p->obj_stat.suc + p->obj_delete.suc;
+  const double value[] = {p->perf[IOR_PERF_CYCLES] / ops, p->perf[IOR_PERF_INSTRUCTIONS] / ops,
+                          p->perf[IOR_PERF_INSTRUCTIONS] / p->perf[IOR_PERF_CYCLES],
+                          p->perf[IOR_PERF_CACHE_MISSES] / ops, p->perf[IOR_PERF_DTLB_MISSES] / ops};
+  const char * key[] = {"cycles/op", "instr/op", "IPC", "LLC-miss/op", "dTLB-miss/op"};
+  char buff[MAX_PATHLEN];
+  int pos = sprintf(buff, "%s counters", name);
+  for(int i=0; i < 5; i++){
+    if(isfinite(value[i])){
+      pos += sprintf(buff + pos, " %s:%.*f", key[i], i == 2 ? 3 : 1, value[i]);
+    }else{
+      pos += sprintf(buff + pos, " %s:NA", key[i]);
+    }
+  }
+  oprintf("%s\n", buff);
+}
+
 static void end_phase(const char * name, phase_stat_t * p){
   int ret;
   char buff[MAX_PATHLEN];
 
   //char * limit_memory_P = NULL;
+  if(o.perf_counters){
+    PerfCountersStop(p->perf);
+  }
   MPI_Barrier(o.com);
 
   int max_repeats = o.precreate * o.dset_count;
@@ -441,6 +468,10 @@ static void end_phase(const char * name, phase_stat_t * p){
   CHECK_MPI_RET(ret)
   ret = MPI_Reduce(& p->max_op_time, & g_stat.max_op_time, 1, MPI_DOUBLE, MPI_MAX, 0, o.com);
   CHECK_MPI_RET(ret)
+  if(o.perf_counters){
+    ret = MPI_Reduce(p->perf, g_stat.perf, IOR_NB_PERF, MPI_DOUBLE, MPI_SUM, 0, o.com);
+    CHECK_MPI_RET(ret)
+  }
   if( p->stonewall_iterations ){
     ret = MPI_Reduce(& p->repeats, & g_stat.repeats, 1, MPI_UINT64_T, MPI_MIN, 0, o.com);
     CHECK_MPI_RET(ret)
@@ -492,6 +523,9 @@ static void end_phase(const char * name, phase_stat_t * p){
     //print the stats:
     print_p_stat(buff, name, & g_stat, g_stat.t, 1);
     oprintf("%s\n", buff);
+    if(o.perf_counters){
+      print_perf_counters(name, & g_stat);
+    }
   }
 
   if(o.process_report){
@@ -832,6 +866,8 @@ static option_help options [] = {
   {'W', "stonewall-wear-out", "Stop with stonewall after specified time and use a soft wear-out phase -- all processes perform the same number of iterations", OPTION_FLAG, 'd', & o.stonewall_timer_wear_out},
   {'X', "verify-read", "Verify the data on read", OPTION_FLAG, 'd', & o.verify_read},
   {0, "dataPacketType", "type of packet that will be created [offset|incompressible|timestamp|random|o|i|t|r]", OPTION_OPTIONAL_ARGUMENT, 's', & o.packetTypeStr},
+  {0, "huge-pages", "Back the object buffers by huge pages: none, thp (transparent), 2m or 1g (reserved)", OPTION_OPTIONAL_ARGUMENT, 's', & o.huge_pages},
+  {0, "perf-counters", "Report the cycles, instructions, cache and TLB misses per operation (perf_event_open)", OPTION_FLAG, 'd', & o.perf_counters},
 #ifdef HAVE_CUDA
   {0, "allocateBufferOnGPU", "Allocate I/O buffers on the GPU: X=1 uses managed memory - verifications are run on CPU; X=2 managed memory - verifications on GPU; X=3 device memory with verifications on GPU.", OPTION_OPTIONAL_ARGUMENT, 'd', & o.gpuMemoryFlags},
   {0, "GPUid", "Select the GPU to use, use -1 for round-robin among local procs.", OPTION_OPTIONAL_ARGUMENT, 'd', & o.gpuID},
@@ -949,12 +985,23 @@ mdworkbench_results_t* md_workbench_run(int argc, char ** argv, MPI_Comm world_c
     o.backend->initialize(o.backend_options);
   }
 
+  const ior_topology_t *topo = GetTopology(o.com);
   int tasksBlockMapping = QueryNodeMapping(o.com, true);
-  int numNodes = GetNumNodes(o.com);
-  int numTasksOnNode0 = GetNumTasksOnNode0(o.com);
+  int numNodes = topo->numNodes;
+  int numTasksOnNode0 = topo->tasksOnNode0;
   if(o.gpuMemoryFlags != IOR_MEMORY_TYPE_CPU){
     initCUDA(tasksBlockMapping, o.rank, numNodes, numTasksOnNode0, o.gpuID);
   }
+  if(aligned_buffer_huge_pages(o.huge_pages) != 0){
+    FAIL("unknown huge pages %s, use none, thp, 2m or 1g", o.huge_pages);
+  }
+  if(o.perf_counters){
+    PerfCountersSetup(o.com);
+  }
+  if(o.gpuMemoryFlags == IOR_MEMORY_TYPE_CPU){
+    // fault in the pooled object buffer before the timed phases
+    aligned_buffer_free(aligned_buffer_alloc(o.file_size, o.gpuMemoryFlags), o.gpuMemoryFlags);
+  }
     
   int current_index = 0;
   if ( (o.phase_cleanup || o.phase_benchmark) && ! o.phase_precreate ){
@@ -1011,6 +1058,9 @@ mdworkbench_results_t* md_workbench_run(int argc, char ** argv, MPI_Comm world_c
 
     // pre-creation phase
     phase_stats.phase_start_timer = GetTimeStamp();
+    if(o.perf_counters){
+      PerfCountersStart();
+    }
     run_precreate(& phase_stats, current_index);
     phase_stats.t = GetTimeStamp() - phase_stats.phase_start_timer;
     end_phase("precreate", & phase_stats);
@@ -1025,6 +1075,9 @@ mdworkbench_results_t* md_workbench_run(int argc, char ** argv, MPI_Comm world_c
       init_stats(& phase_stats, o.num * o.dset_count);
       MPI_Barrier(o.com);
       phase_stats.phase_start_timer = GetTimeStamp();
+      if(o.perf_counters){
+        PerfCountersStart();
+      }
       run_benchmark(& phase_stats, & current_index);
       end_phase("benchmark", & phase_stats);
 
@@ -1034,6 +1087,9 @@ mdworkbench_results_t* md_workbench_run(int argc, char ** argv, MPI_Comm world_c
           init_stats(& phase_stats, o.num * o.dset_count);
           MPI_Barrier(o.com);
           phase_stats.phase_start_timer = GetTimeStamp();
+          if(o.perf_counters){
+            PerfCountersStart();
+          }
           run_benchmark(& phase_stats, & current_index);
           end_phase("benchmark", & phase_stats);
           o.relative_waiting_factor *= 2;
@@ -1046,6 +1102,9 @@ mdworkbench_results_t* md_workbench_run(int argc, char ** argv, MPI_Comm world_c
   if (o.phase_cleanup){
     init_stats(& phase_stats, o.precreate * o.dset_count);
     phase_stats.phase_start_timer = GetTimeStamp();
+    if(o.perf_counters){
+      PerfCountersStart();
+    }
     run_cleanup(& phase_stats, current_index);
     phase_stats.t = GetTimeStamp() - phase_stats.phase_start_timer;
     end_phase("cleanup", & phase_stats);
@@ -1063,6 +1122,8 @@ mdworkbench_results_t* md_workbench_run(int argc, char ** argv, MPI_Comm world_c
   if(o.backend->finalize){
     o.backend->finalize(o.backend_options);
   }
+  aligned_buffer_pool_release();
+  PerfCountersClose();
   if (o.rank == 0 && ! o.quiet_output){
     oprintf("Total runtime: %.0fs time: ",  t_all);
     printTime();
@@ -69,6 +69,12 @@
 #include <errno.h>
 #include <time.h>
 #include <sys/time.h>
+#ifdef HAVE_PTHREAD
+#include <pthread.h>
+#endif
+#ifdef HAVE_LINUX_IO_URING_H
+#include "aiori-POSIX.h"
+#endif
 
 #include "aiori.h"
 #include "ior.h"
@@ -100,7 +106,6 @@
 
 typedef struct {
   int size;
-  uint64_t *rand_array;
   char testdir[MAX_PATHLEN];
   char testdirpath[MAX_PATHLEN];
   char base_tree_name[MAX_PATHLEN];
@@ -121,6 +126,7 @@ typedef struct {
   ior_memory_flags gpuMemoryFlags;  /* use the GPU to store the data */
   int gpuDirect;                /* use gpuDirect, this influences gpuMemoryFlags as well */
   int gpuID;                       /* the GPU to use for gpuDirect or memory options */
+  char *hugePages;                 /* pages backing the buffers: none, thp, 2m or 1g */
 
 
 
@@ -133,6 +139,14 @@ typedef struct {
   int verification_error;
   int remove_only;
   int rename_dirs;
+  int list_dirs;                   /* list the directories of the files */
+  int list_stat;                   /* stat every entry listed */
+  int xattr_count;                 /* extended attributes per file, 0: no xattr phases */
+  int xattr_size;                  /* bytes of an attribute value */
+  int rename_files;                /* rename the files within and across directories */
+  int rename_across;               /* the files of a process are in several directories to rename across */
+  int link_files;                  /* hard link the files */
+  int symlink_files;               /* symlink the files and read the links */
   int leaf_only;
   unsigned branch_factor;
   int depth;
@@ -169,8 +183,17 @@ typedef struct {
   size_t write_bytes;
   int stone_wall_timer_seconds;
   size_t read_bytes;
+  char * size_distribution;        /* the sizes of the files instead of -w and -e, see size_distribution_parse() */
   int sync_file;
   int call_sync;
+  int resource_accounting;         /* resources used per phase, 1: of the processes, 2: also of the nodes */
+  double phase_resources[IOR_NB_RES]; /* sampled when the current phase starts */
+  int perf_counters;               /* count hardware events per phase */
+  double phase_perf[IOR_NB_PERF];  /* counted until the current phase ended */
+  int dir_handles;                 /* resolve the items relative to open directories */
+  int threads;                     /* threads per process working on the items */
+  int uring_depth;                 /* items in flight on the io_uring of a thread, 0: synchronous calls */
+  int uring_batch;                 /* calls queued before they are submitted, 0: when waiting */
   int path_count;
   int nstride; /* neighbor stride */
   int make_node;
@@ -241,6 +264,7 @@ void VerboseMessage (int root_level, int any_level, int line, char * format, ...
     }
 }
 char const * mdtest_test_name(int i);
+static int mdtest_test_enabled(int i);
 
 void parse_dirpath(char *dirpath_arg) {
     char * tmp, * token;
@@ -288,6 +312,10 @@ static void phase_prepare(){
   if (o.barriers) {
     MPI_CHECK(MPI_Barrier(testComm), "MPI_Barrier error");
   }
+  ResourcesSample(o.phase_resources, o.resource_accounting, testComm);
+  if (o.perf_counters) {
+    PerfCountersStart();
+  }
 }
 
 static void phase_end(){
@@ -301,6 +329,9 @@ static void phase_end(){
     VERBOSE(0,5,"calling epilogue: \"%s\"", o.epilogue);
     system(o.epilogue);
   }
+  if (o.perf_counters) {
+    PerfCountersStop(o.phase_perf);
+  }
 
   if (o.barriers) {
     MPI_CHECK(MPI_Barrier(testComm), "MPI_Barrier error");
@@ -328,7 +359,753 @@ void unique_dir_access(int opt, char *to) {
     VERBOSE(1,-1,"Entering unique_dir_access, set it to %s", to );
 }
 
-static void create_remove_dirs (const char *path, bool create, uint64_t itemNum) {
+#ifdef HAVE_LINUX_IO_URING_H
+/* an item in flight on the io_uring of a worker */
+typedef struct {
+    int step;                  /* the call in flight */
+    int fd;
+    uint64_t item_num;
+    double start;
+    char path[MAX_PATHLEN];
+    char * write_buffer;
+    char * read_buffer;
+    size_t bytes;              /* written to or read from the file */
+    int size_class;
+    uint64_t tail_word;        /* see size_tail_set() */
+    struct statx stx;
+} md_uring_slot_t;
+#endif
+
+/* a worker of the process, worker 0 is the calling thread */
+typedef struct {
+    char * write_buffer;       /* the pattern written to the files */
+    char * read_buffer;
+    int verification_error;    /* added to o.verification_error after each loop */
+    uint64_t list_dirs;        /* listing: the directories listed, their entries */
+    uint64_t list_entries;
+    double list_first_sum;     /* and the time until their first entries */
+    double list_first_max;
+    uint64_t size_items[2][MDTEST_SIZE_CLASSES];  /* size distribution: the files created and read per class */
+    uint64_t size_bytes[2][MDTEST_SIZE_CLASSES];
+    double size_time[2][MDTEST_SIZE_CLASSES];
+#ifdef HAVE_LINUX_IO_URING_H
+    posix_uring_t * ring;      /* NULL for synchronous calls */
+    md_uring_slot_t * slots;   /* one per item in flight */
+#endif
+} md_worker_t;
+
+/* the arguments of an item loop */
+typedef struct {
+    int dirs;
+    int create;
+    int random;
+    const char * path;
+    uint64_t itemNum;          /* create/remove: number of the first item of the directory */
+    aiori_dir_t * dh;          /* create/remove: handle of the directory or NULL */
+    ior_permutation_t order;   /* stat/read: the random order of the items */
+    int op;                    /* file phases: the calls */
+    const char * name;         /* file phases: the files are file.<name><item> */
+    uint64_t first_dir;        /* file phases: the directories of the files */
+    uint64_t num_dirs;
+    int creator;               /* read: the rank that wrote the files */
+    int stonewalled;
+    rank_progress_t * progress;
+} md_loop_t;
+
+/* processes the items first to last-1 of a loop */
+typedef void (*md_items_fn)(md_worker_t * w, void * args, uint64_t first, uint64_t last);
+
+/*
+ * The threads of a process wait for a loop, each works on a contiguous part of
+ * its items, so the items of a directory stay mostly with the same thread.
+ */
+static struct {
+    md_worker_t * workers;
+#ifdef HAVE_PTHREAD
+    pthread_t * threads;
+    pthread_mutex_t lock;
+    pthread_cond_t start;
+    pthread_cond_t done;
+    pthread_mutex_t timer_lock;  /* the per-operation timer is shared */
+    uint64_t generation;         /* incremented for every loop */
+    int busy;                    /* threads still working on the loop */
+    int stop;
+    md_items_fn fn;
+    void * args;
+    uint64_t first;
+    uint64_t last;
+#endif
+} pool;
+
+static void run_part(int t, md_items_fn fn, void * args, uint64_t first, uint64_t last){
+    const uint64_t count = last - first;
+    fn(& pool.workers[t], args, first + count * t / o.threads, first + count * (t + 1) / o.threads);
+}
+
+#ifdef HAVE_PTHREAD
+static void * worker_main(void * arg){
+    const int t = (int) (intptr_t) arg;
+    uint64_t generation = 0;
+
+    pthread_mutex_lock(& pool.lock);
+    while (1) {
+        while (pool.generation == generation) {
+            pthread_cond_wait(& pool.start, & pool.lock);
+        }
+        generation = pool.generation;
+        if (pool.stop) {
+            break;
+        }
+        pthread_mutex_unlock(& pool.lock);
+        run_part(t, pool.fn, pool.args, pool.first, pool.last);
+        pthread_mutex_lock(& pool.lock);
+        if (--pool.busy == 0) {
+            pthread_cond_signal(& pool.done);
+        }
+    }
+    pthread_mutex_unlock(& pool.lock);
+    return NULL;
+}
+#endif
+
+/* allocate the buffers of the workers and start the threads */
+static void workers_init(){
+    pool.workers = safeMalloc(sizeof(md_worker_t) * o.threads);
+    memset(pool.workers, 0, sizeof(md_worker_t) * o.threads);
+    for (int t = 0; t < o.threads; t++) {
+        md_worker_t * w = & pool.workers[t];
+        if (o.write_bytes > 0) {
+            w->write_buffer = t == 0 ? o.write_buffer : aligned_buffer_alloc(o.write_bytes, o.gpuMemoryFlags);
+            if (t > 0) {
+                generate_memory_pattern(w->write_buffer, o.write_bytes, o.random_buffer_offset, rank, o.dataPacketType, o.gpuMemoryFlags);
+            }
+        }
+        if (o.read_bytes > 0) {
+            w->read_buffer = aligned_buffer_alloc(o.read_bytes, o.gpuMemoryFlags);
+            invalidate_buffer_pattern(w->read_buffer, o.read_bytes, o.gpuMemoryFlags);
+        }
+#ifdef HAVE_LINUX_IO_URING_H
+        if (o.uring_depth > 0) {
+            w->ring = POSIX_UringInit(o.uring_depth, o.uring_batch, o.backend_options);
+            if (! w->ring) {
+                FAIL("io_uring is not available");
+            }
+            w->slots = safeMalloc(sizeof(md_uring_slot_t) * o.uring_depth);
+            memset(w->slots, 0, sizeof(md_uring_slot_t) * o.uring_depth);
+            for (int s = 0; s < o.uring_depth; s++) {
+                if (o.write_bytes > 0) {
+                    w->slots[s].write_buffer = aligned_buffer_alloc(o.write_bytes, o.gpuMemoryFlags);
+                    generate_memory_pattern(w->slots[s].write_buffer, o.write_bytes, o.random_buffer_offset, rank, o.dataPacketType, o.gpuMemoryFlags);
+                }
+                if (o.read_bytes > 0) {
+                    w->slots[s].read_buffer = aligned_buffer_alloc(o.read_bytes, o.gpuMemoryFlags);
+                }
+            }
+        }
+#endif
+    }
+#ifdef HAVE_PTHREAD
+    if (o.threads > 1) {
+        pthread_mutex_init(& pool.lock, NULL);
+        pthread_mutex_init(& pool.timer_lock, NULL);
+        pthread_cond_init(& pool.start, NULL);
+        pthread_cond_init(& pool.done, NULL);
+        pool.generation = 0;
+        pool.stop = 0;
+        pool.threads = safeMalloc(sizeof(pthread_t) * o.threads);
+        for (int t = 1; t < o.threads; t++) {
+            if (pthread_create(& pool.threads[t], NULL, worker_main, (void *) (intptr_t) t) != 0) {
+                FAIL("unable to create thread %d of %d", t, o.threads);
+            }
+        }
+    }
+#endif
+}
+
+static void workers_free(){
+#ifdef HAVE_PTHREAD
+    if (o.threads > 1) {
+        pthread_mutex_lock(& pool.lock);
+        pool.stop = 1;
+        pool.generation++;
+        pthread_cond_broadcast(& pool.start);
+        pthread_mutex_unlock(& pool.lock);
+        for (int t = 1; t < o.threads; t++) {
+            pthread_join(pool.threads[t], NULL);
+        }
+        free(pool.threads);
+        pthread_cond_destroy(& pool.done);
+        pthread_cond_destroy(& pool.start);
+        pthread_mutex_destroy(& pool.timer_lock);
+        pthread_mutex_destroy(& pool.lock);
+    }
+#endif
+    for (int t = 0; t < o.threads; t++) {
+        if (t > 0 && pool.workers[t].write_buffer) {
+            aligned_buffer_free(pool.workers[t].write_buffer, o.gpuMemoryFlags);
+        }
+        if (pool.workers[t].read_buffer) {
+            aligned_buffer_free(pool.workers[t].read_buffer, o.gpuMemoryFlags);
+        }
+#ifdef HAVE_LINUX_IO_URING_H
+        if (pool.workers[t].ring) {
+            for (int s = 0; s < o.uring_depth; s++) {
+                if (pool.workers[t].slots[s].write_buffer) {
+                    aligned_buffer_free(pool.workers[t].slots[s].write_buffer, o.gpuMemoryFlags);
+                }
+                if (pool.workers[t].slots[s].read_buffer) {
+                    aligned_buffer_free(pool.workers[t].slots[s].read_buffer, o.gpuMemoryFlags);
+                }
+            }
+            free(pool.workers[t].slots);
+            POSIX_UringFree(pool.workers[t].ring);
+        }
+#endif
+    }
+    free(pool.workers);
+    pool.workers = NULL;
+}
+
+/* process the items first to last-1 with all threads of the process */
+static void run_items(md_items_fn fn, void * args, uint64_t first, uint64_t last){
+#ifdef HAVE_PTHREAD
+    if (o.threads > 1) {
+        pthread_mutex_lock(& pool.lock);
+        pool.fn = fn;
+        pool.args = args;
+        pool.first = first;
+        pool.last = last;
+        pool.busy = o.threads - 1;
+        pool.generation++;
+        pthread_cond_broadcast(& pool.start);
+        pthread_mutex_unlock(& pool.lock);
+    }
+#endif
+    run_part(0, fn, args, first, last);
+#ifdef HAVE_PTHREAD
+    if (o.threads > 1) {
+        pthread_mutex_lock(& pool.lock);
+        while (pool.busy > 0) {
+            pthread_cond_wait(& pool.done, & pool.lock);
+        }
+        pthread_mutex_unlock(& pool.lock);
+    }
+#endif
+    for (int t = 0; t < o.threads; t++) {
+        o.verification_error += pool.workers[t].verification_error;
+        pool.workers[t].verification_error = 0;
+    }
+}
+
+static void op_timer_value(rank_progress_t * progress, double start){
+    if (! progress->ot) {
+        return;
+    }
+    double end = GetTimeStamp();
+#ifdef HAVE_PTHREAD
+    if (o.threads > 1) {
+        pthread_mutex_lock(& pool.timer_lock);
+        OpTimerValue(progress->ot, start - progress->start_time, end - start);
+        pthread_mutex_unlock(& pool.timer_lock);
+        return;
+    }
+#endif
+    OpTimerValue(progress->ot, start - progress->start_time, end - start);
+}
+
+/*
+ * Open the directory for the handle-relative operations, NULL if they are not
+ * used: the shared file is opened by all processes through the path.
+ */
+static aiori_dir_t * dir_handle_open(const char * path){
+    if (! o.dir_handles || o.shared_file) {
+        return NULL;
+    }
+    return o.backend->opendir(path, o.backend_options);
+}
+
+static void dir_handle_close(aiori_dir_t * dh){
+    if (dh) {
+        o.backend->closedir(dh, o.backend_options);
+    }
+}
+
+/*
+ * Directory of the tree rooted at path that holds the items of directory dir,
+ * the children of directory n are b*n+1 to b*n+b.
+ */
+static int tree_item_dir(char * out, const char * path, uint64_t dir){
+    if (dir == 0) {
+        return sprintf(out, "%s", path);
+    }
+    int pos = tree_item_dir(out, path, dir > o.branch_factor ? (dir - 1) / o.branch_factor : 0);
+    return pos + sprintf(out + pos, "/%s."LLU"", o.base_tree_name, dir);
+}
+
+/* directory handles of the tree used by a stat or read phase, direct mapped by directory */
+#define DIR_HANDLE_CACHE 64
+
+typedef struct {
+    int enabled;
+    uint64_t dir[DIR_HANDLE_CACHE];
+    aiori_dir_t * handle[DIR_HANDLE_CACHE];
+} dir_handle_cache_t;
+
+static void dir_handle_cache_init(dir_handle_cache_t * c){
+    memset(c, 0, sizeof(*c));
+    c->enabled = o.dir_handles && ! o.shared_file;
+}
+
+/* the handle of directory dir of the tree rooted at path, NULL to use the path */
+static aiori_dir_t * dir_handle_cache_get(dir_handle_cache_t * c, const char * path, uint64_t dir){
+    char dir_path[MAX_PATHLEN];
+    const int slot = dir % DIR_HANDLE_CACHE;
+
+    if (! c->enabled) {
+        return NULL;
+    }
+    if (c->handle[slot] && c->dir[slot] == dir) {
+        return c->handle[slot];
+    }
+    tree_item_dir(dir_path, path, dir);
+    aiori_dir_t * dh = o.backend->opendir(dir_path, o.backend_options);
+    if (! dh) {
+        /* the backend options need the paths, use them for the rest of the phase */
+        c->enabled = 0;
+        return NULL;
+    }
+    dir_handle_close(c->handle[slot]);
+    c->handle[slot] = dh;
+    c->dir[slot] = dir;
+    return dh;
+}
+
+static void dir_handle_cache_free(dir_handle_cache_t * c){
+    for (int i = 0; i < DIR_HANDLE_CACHE; i++) {
+        dir_handle_close(c->handle[i]);
+    }
+}
+
+/*
+ * The rank whose items rank r accesses k strides away among the ntasks ranks of
+ * testComm.  On an irregular node layout the stride moves along the ranks ordered
+ * by node, so a stride of the tasks of the largest node reaches another node.
+ */
+static int neighbor_rank(int r, int k, int ntasks){
+    const ior_topology_t * topo = GetTopology(testComm);
+
+    if (o.nstride == 0 || ! topo->irregular) {
+        return (r + k * o.nstride) % ntasks;
+    }
+    return NodeOrderShift(topo, r, (long long) k * o.nstride);
+}
+
+/* the number of item i of a stat or read loop */
+static uint64_t loop_item_num(md_loop_t * l, uint64_t i){
+    uint64_t item_num = l->random ? PermutationValue(& l->order, i) : i;
+
+    /* make adjustments if in leaf only mode*/
+    if (o.leaf_only) {
+        item_num += o.items_per_dir *
+            (o.num_dirs_in_tree - (uint64_t) pow( o.branch_factor, o.depth ));
+    }
+    return item_num;
+}
+
+/*
+ * File sizes drawn from a distribution instead of the fixed -w and -e, see
+ * size_distribution_parse(). The size of a file is a hash of its number and
+ * of the rank that creates it, so the read phase and later runs with -E know
+ * it. For the report, the sizes are grouped into classes.
+ */
+enum {SIZE_CREATE, SIZE_READ};
+
+typedef struct {
+    uint64_t min;              /* the sizes of the class */
+    uint64_t max;
+    double weight;             /* list, histogram: cumulative, 1 for the last class */
+} md_size_class_t;
+
+static struct {
+    int count;                 /* the classes, 0 without a distribution */
+    int lognormal;
+    double mu;                 /* lognormal: log of the median and sigma */
+    double sigma;
+    uint64_t max;              /* the largest size */
+    md_size_class_t c[MDTEST_SIZE_CLASSES];
+} sizes;
+
+static void size_class_add(uint64_t min, uint64_t max, double weight){
+    if (sizes.count == MDTEST_SIZE_CLASSES) {
+        FAIL("a size distribution has at most %d classes", MDTEST_SIZE_CLASSES);
+    }
+    if (max < min || weight < 0) {
+        FAIL("invalid size class "LLU"-"LLU" with weight %f", min, max, weight);
+    }
+    sizes.c[sizes.count++] = (md_size_class_t) {min, max, weight};
+    if (max > sizes.max) {
+        sizes.max = max;
+    }
+}
+
+static uint64_t size_value(char * str){
+    int64_t size = string_to_bytes(str);
+    if (size < 0) {
+        FAIL("invalid size \"%s\" in the size distribution", str);
+    }
+    return size;
+}
+
+/*
+ * Parse the size distribution, one of
+ *   list:SIZE=WEIGHT,...          the sizes with their weights, a class each
+ *   lognormal:MEDIAN:SIGMA:MAX    classes up to 1 KiB, 4 KiB, 16 KiB, ... and MAX
+ *   histogram:FILE                lines of "MIN MAX WEIGHT", uniform sizes in a class
+ */
+static void size_distribution_parse(const char * spec){
+    memset(& sizes, 0, sizeof(sizes));
+    if (spec == NULL) {
+        return;
+    }
+    char * type = strdup(spec);
+    char * arg = strchr(type, ':');
+    if (arg == NULL) {
+        FAIL("the size distribution is list:..., lognormal:... or histogram:..., not %s", spec);
+    }
+    *arg++ = 0;
+
+    if (strcmp(type, "list") == 0) {
+        for (char * tok = strtok(arg, ","); tok; tok = strtok(NULL, ",")) {
+            char * weight = strchr(tok, '=');
+            if (weight == NULL) {
+                FAIL("the sizes of a list are SIZE=WEIGHT, not %s", tok);
+            }
+            *weight++ = 0;
+            uint64_t size = size_value(tok);
+            size_class_add(size, size, atof(weight));
+        }
+    } else if (strcmp(type, "lognormal") == 0) {
+        char * sigma = strchr(arg, ':');
+        char * max = sigma ? strchr(sigma + 1, ':') : NULL;
+        if (max == NULL) {
+            FAIL("a lognormal size distribution is lognormal:MEDIAN:SIGMA:MAX, not %s", spec);
+        }
+        *sigma++ = 0;
+        *max++ = 0;
+        uint64_t median = size_value(arg);
+        uint64_t last = size_value(max);
+        sizes.lognormal = 1;
+        sizes.mu = log((double) median);
+        sizes.sigma = atof(sigma);
+        if (median == 0 || sizes.sigma <= 0) {
+            FAIL("the median and sigma of a lognormal size distribution must be positive");
+        }
+        for (uint64_t lo = 0, hi = 1024; lo <= last; lo = hi + 1, hi *= 4) {
+            size_class_add(lo, hi < last ? hi : last, 1);
+        }
+    } else if (strcmp(type, "histogram") == 0) {
+        FILE * f = fopen(arg, "r");
+        if (f == NULL) {
+            FAIL("unable to open the size histogram %s", arg);
+        }
+        char line[1024], min[64], max[64];
+        double weight;
+        while (fgets(line, sizeof(line), f)) {
+            if (sscanf(line, "%63s", min) != 1 || min[0] == '#') {
+                continue;
+            }
+            if (sscanf(line, "%63s %63s %lf", min, max, & weight) != 3) {
+                FAIL("the lines of a size histogram are \"MIN MAX WEIGHT\", not %s", line);
+            }
+            size_class_add(size_value(min), size_value(max), weight);
+        }
+        fclose(f);
+    } else {
+        FAIL("unknown size distribution %s, use list, lognormal or histogram", type);
+    }
+    free(type);
+
+    if (sizes.count == 0 || sizes.max == 0) {
+        FAIL("the size distribution %s has no files larger than 0 bytes, use -w 0 instead", spec);
+    }
+    if (! sizes.lognormal) {
+        double total = 0, sum = 0;
+        for (int c = 0; c < sizes.count; c++) {
+            total += sizes.c[c].weight;
+        }
+        if (total <= 0) {
+            FAIL("the weights of the size distribution %s are 0", spec);
+        }
+        for (int c = 0; c < sizes.count; c++) {
+            sum += sizes.c[c].weight;
+            sizes.c[c].weight = sum / total;
+        }
+        sizes.c[sizes.count - 1].weight = 1;
+    }
+}
+
+/* the k-th value of a file in [0, 1) */
+static double size_uniform(uint64_t item_num, int creator, int k){
+    uint64_t x = Mix64(item_num * 0x9E3779B97F4A7C15ULL ^ Mix64(((uint64_t) creator << 8) | k));
+    return (x >> 11) * (1.0 / 9007199254740992.0);
+}
+
+/* the bytes written to or read from a file and its size class */
+static size_t file_bytes(int phase, uint64_t item_num, int creator, int * cls){
+    int c = 0;
+    uint64_t size;
+
+    if (sizes.count == 0) {
+        *cls = 0;
+        return phase == SIZE_CREATE ? o.write_bytes : o.read_bytes;
+    }
+    if (sizes.lognormal) {
+        /* Box-Muller, 1 - u is in (0, 1] */
+        double z = sqrt(-2 * log(1 - size_uniform(item_num, creator, 0))) * cos(2 * M_PI * size_uniform(item_num, creator, 1));
+        double v = exp(sizes.mu + sizes.sigma * z);
+        size = v < sizes.max ? (uint64_t) v : sizes.max;
+        while (size > sizes.c[c].max) {
+            c++;
+        }
+    } else {
+        double u = size_uniform(item_num, creator, 0);
+        while (c < sizes.count - 1 && u >= sizes.c[c].weight) {
+            c++;
+        }
+        size = sizes.c[c].min + (uint64_t) (size_uniform(item_num, creator, 1) * (sizes.c[c].max - sizes.c[c].min + 1));
+    }
+    *cls = c;
+    return size;
+}
+
+/*
+ * The pattern of a file ends with bytes counting up after its last full word,
+ * the buffer for larger files has a word of the pattern there. Put the end of
+ * a file of this size into the write buffer, size_tail_restore() undoes it.
+ */
+static uint64_t size_tail_set(char * buf, size_t bytes){
+    size_t tail = bytes & ~ (size_t) 7;
+    uint64_t word = 0;
+    if (sizes.count == 0 || tail == bytes || tail + 8 > o.write_bytes) {
+        return 0;
+    }
+    memcpy(& word, buf + tail, 8);
+    for (size_t i = tail; i < bytes; i++) {
+        buf[i] = (char) i;
+    }
+    return word;
+}
+
+static void size_tail_restore(char * buf, size_t bytes, uint64_t word){
+    size_t tail = bytes & ~ (size_t) 7;
+    if (sizes.count == 0 || tail == bytes || tail + 8 > o.write_bytes) {
+        return;
+    }
+    memcpy(buf + tail, & word, 8);
+}
+
+/* account a file created or read with a size distribution */
+static void size_class_done(md_worker_t * w, int phase, int cls, size_t bytes, double start){
+    if (sizes.count == 0) {
+        return;
+    }
+    w->size_items[phase][cls]++;
+    w->size_bytes[phase][cls] += bytes;
+    w->size_time[phase][cls] += GetTimeStamp() - start;
+}
+
+/* move the size classes of the workers into the results of the phase */
+static void size_classes_collect(mdtest_results_t * res, int phase){
+    for (int t = 0; t < o.threads; t++) {
+        md_worker_t * w = & pool.workers[t];
+        for (int c = 0; c < sizes.count; c++) {
+            res->size_items[phase][c] += w->size_items[phase][c];
+            res->size_bytes[phase][c] += w->size_bytes[phase][c];
+            res->size_time[phase][c] += w->size_time[phase][c];
+            w->size_items[phase][c] = w->size_bytes[phase][c] = 0;
+            w->size_time[phase][c] = 0;
+        }
+    }
+}
+
+#ifdef HAVE_LINUX_IO_URING_H
+/* the loops processed on the io_uring and the calls of an item */
+enum {URING_CREATE_REMOVE, URING_STAT, URING_READ};
+enum {URING_META, URING_OPEN, URING_WRITE, URING_FSYNC, URING_VERIFY, URING_READ_DATA, URING_CLOSE};
+
+static void uring_close_item(md_worker_t * w, md_uring_slot_t * s, uint64_t tag){
+    s->step = URING_CLOSE;
+    POSIX_UringClose(w->ring, s->fd, tag);
+}
+
+/* start the first call of item i */
+static void uring_start_item(md_worker_t * w, md_loop_t * l, int kind, uint64_t i, uint64_t tag){
+    md_uring_slot_t * s = & w->slots[tag];
+
+    if (kind == URING_CREATE_REMOVE) {
+        s->item_num = l->itemNum + i;
+        sprintf(s->path, "%s/%s.%s"LLU"", l->path, l->dirs ? "dir" : "file", l->create ? o.mk_name : o.rm_name, s->item_num);
+    } else {
+        s->item_num = loop_item_num(l, i);
+        int pos = tree_item_dir(s->path, l->path, s->item_num / o.items_per_dir);
+        sprintf(s->path + pos, "/%s.%s"LLU"", l->dirs ? "dir" : "file", kind == URING_STAT ? o.stat_name : o.read_name, s->item_num);
+    }
+    VERBOSE(3,5,"io_uring item: %s", s->path);
+
+    if (kind == URING_READ) {
+        s->bytes = file_bytes(SIZE_READ, s->item_num, l->creator, & s->size_class);
+    } else if (kind == URING_CREATE_REMOVE && l->create && ! l->dirs) {
+        s->bytes = file_bytes(SIZE_CREATE, s->item_num, rank, & s->size_class);
+    }
+
+    s->start = GetTimeStamp();
+    s->step = URING_META;
+    if (kind == URING_STAT) {
+        POSIX_UringStat(w->ring, s->path, & s->stx, tag);
+    } else if (kind == URING_READ) {
+        s->step = URING_OPEN;
+        POSIX_UringOpen(w->ring, s->path, O_RDONLY, 0, tag);
+    } else if (! l->create) {
+        POSIX_UringUnlink(w->ring, s->path, l->dirs, tag);
+    } else if (l->dirs) {
+        POSIX_UringMkdir(w->ring, s->path, DIRMODE, tag);
+    } else {
+        s->step = URING_OPEN;
+        POSIX_UringOpen(w->ring, s->path, O_CREAT | O_RDWR, 0664, tag);
+    }
+}
+
+/* continue an item with the result of its last call, returns 1 once it is done */
+static int uring_continue_item(md_worker_t * w, md_loop_t * l, int kind, int res, uint64_t tag){
+    md_uring_slot_t * s = & w->slots[tag];
+
+    switch (s->step) {
+    case URING_META:
+        if (res < 0) {
+            WARNF("unable to %s %s %s: %s", kind == URING_STAT ? "stat" : (l->create ? "create" : "remove"),
+                  l->dirs ? "directory" : "file", s->path, strerror(-res));
+        }
+        return 1;
+    case URING_OPEN:
+        if (res < 0) {
+            WARNF("unable to %s file %s: %s", kind == URING_READ ? "open" : "create", s->path, strerror(-res));
+            return 1;
+        }
+        s->fd = res;
+        if (kind == URING_READ && s->bytes > 0) {
+            s->step = URING_READ_DATA;
+            invalidate_buffer_pattern(s->read_buffer, s->bytes, o.gpuMemoryFlags);
+            POSIX_UringXfer(w->ring, READ, s->fd, s->read_buffer, s->bytes, 0, tag);
+        } else if (kind != URING_READ && s->bytes > 0) {
+            s->step = URING_WRITE;
+            update_write_memory_pattern(s->item_num, s->write_buffer, s->bytes, o.random_buffer_offset, rank, o.dataPacketType, o.gpuMemoryFlags);
+            s->tail_word = size_tail_set(s->write_buffer, s->bytes);
+            POSIX_UringXfer(w->ring, WRITE, s->fd, s->write_buffer, s->bytes, 0, tag);
+        } else {
+            uring_close_item(w, s, tag);
+        }
+        return 0;
+    case URING_WRITE:
+        if (res != (int) s->bytes) {
+            WARNF("unable to write file %s", s->path);
+        }
+        if (o.sync_file) {
+            s->step = URING_FSYNC;
+            POSIX_UringFsync(w->ring, s->fd, tag);
+            return 0;
+        }
+        /* fall through */
+    case URING_FSYNC:
+        if (s->step == URING_FSYNC && res < 0) {
+            WARNF("unable to sync file %s: %s", s->path, strerror(-res));
+        }
+        if (o.verify_write) {
+            s->step = URING_VERIFY;
+            s->write_buffer[0] = 42;
+            POSIX_UringXfer(w->ring, READ, s->fd, s->write_buffer, s->bytes, 0, tag);
+        } else {
+            uring_close_item(w, s, tag);
+        }
+        return 0;
+    case URING_VERIFY: {
+        if (res != (int) s->bytes) {
+            WARNF("unable to verify write (read/back) file %s", s->path);
+        }
+        int error = verify_memory_pattern(s->item_num, s->write_buffer, s->bytes, o.random_buffer_offset, rank, o.dataPacketType, o.gpuMemoryFlags);
+        w->verification_error += error;
+        if (error) {
+            VERBOSE(1,1,"verification error in file: %s", s->path);
+        }
+        uring_close_item(w, s, tag);
+        return 0;
+    }
+    case URING_READ_DATA:
+        if (res != (int) s->bytes) {
+            WARNF("unable to read file %s", s->path);
+            w->verification_error += 1;
+        } else if (o.verify_read) {
+            int error = verify_memory_pattern(s->item_num, s->read_buffer, s->bytes, o.random_buffer_offset, l->creator, o.dataPacketType, o.gpuMemoryFlags);
+            w->verification_error += error;
+            if (error) {
+                VERBOSE(1,1,"verification error in file: %s", s->path);
+            }
+        }
+        uring_close_item(w, s, tag);
+        return 0;
+    default:
+        if (res < 0) {
+            WARNF("unable to close file %s: %s", s->path, strerror(-res));
+        }
+        return 1;
+    }
+}
+
+/*
+ * Process the items first to last-1 with up to o.uring_depth items in flight,
+ * the time of an item is from its first call until its last completed.
+ */
+static void uring_items(md_worker_t * w, md_loop_t * l, int kind, uint64_t first, uint64_t last){
+    rank_progress_t * progress = l->progress;
+    int free_slots[o.uring_depth];
+    int nfree = o.uring_depth;
+    uint64_t next = first;
+
+    for (int s = 0; s < o.uring_depth; s++) {
+        free_slots[s] = s;
+    }
+    while ((next < last && ! l->stonewalled) || nfree < o.uring_depth) {
+        while (next < last && nfree > 0 && ! l->stonewalled) {
+            uring_start_item(w, l, kind, next, free_slots[--nfree]);
+            next++;
+        }
+
+        uint64_t tag;
+        int res;
+        POSIX_UringComplete(w->ring, 1, & tag, & res);
+        if (uring_continue_item(w, l, kind, res, tag)) {
+            md_uring_slot_t * s = & w->slots[tag];
+            if (kind == URING_READ) {
+                size_class_done(w, SIZE_READ, s->size_class, s->bytes, s->start);
+            } else if (kind == URING_CREATE_REMOVE && l->create && ! l->dirs) {
+                size_class_done(w, SIZE_CREATE, s->size_class, s->bytes, s->start);
+                size_tail_restore(s->write_buffer, s->bytes, s->tail_word);
+            }
+            op_timer_value(progress, s->start);
+            free_slots[nfree++] = (int) tag;
+        }
+
+        /* the stonewall is only used with a single thread */
+        if (kind == URING_CREATE_REMOVE && ! l->stonewalled && CHECK_STONE_WALL(progress)) {
+            if (progress->items_done == 0) {
+                progress->items_done = next;
+            }
+            l->stonewalled = 1;
+        }
+    }
+}
+#endif
+
+static void create_remove_dirs (aiori_dir_t * dh, const char *path, bool create, uint64_t itemNum) {
     char curr_item[MAX_PATHLEN];
     const char *operation = create ? "create" : "remove";
 
@@ -338,20 +1115,21 @@ static void create_remove_dirs (const char *path, bool create, uint64_t itemNum)
 
     //create dirs
     sprintf(curr_item, "%s/dir.%s%" PRIu64, path, create ? o.mk_name : o.rm_name, itemNum);
+    const char *name = curr_item + strlen(path) + 1;
     VERBOSE(3,5,"create_remove_items_helper (dirs %s): curr_item is '%s'", operation, curr_item);
 
     if (create) {
-        if (o.backend->mkdir(curr_item, DIRMODE, o.backend_options) == -1) {
+        if ((dh ? o.backend->mkdirat(dh, name, DIRMODE, o.backend_options) : o.backend->mkdir(curr_item, DIRMODE, o.backend_options)) == -1) {
             WARNF("unable to create directory %s", curr_item);
         }
     } else {
-        if (o.backend->rmdir(curr_item, o.backend_options) == -1) {
+        if ((dh ? o.backend->rmdirat(dh, name, o.backend_options) : o.backend->rmdir(curr_item, o.backend_options)) == -1) {
             WARNF("unable to remove directory %s", curr_item);
         }
     }
 }
 
-static void remove_file (const char *path, uint64_t itemNum) {
+static void remove_file (aiori_dir_t * dh, const char *path, uint64_t itemNum) {
     char curr_item[MAX_PATHLEN];
 
     if ( (itemNum % ITEM_COUNT==0 && (itemNum != 0))) {
@@ -361,15 +1139,22 @@ static void remove_file (const char *path, uint64_t itemNum) {
     //remove files
     sprintf(curr_item, "%s/file.%s"LLU"", path, o.rm_name, itemNum);
     VERBOSE(3,5,"create_remove_items_helper (non-dirs remove): curr_item is '%s'", curr_item);
-    if (!(o.shared_file && rank != 0)) {
+    if (dh) {
+        if (o.backend->unlinkat(dh, curr_item + strlen(path) + 1, o.backend_options) == -1) {
+            WARNF("unable to remove file %s", curr_item);
+        }
+    } else if (!(o.shared_file && rank != 0)) {
         o.backend->remove (curr_item, o.backend_options);
     }
 }
 
 
-static void create_file (const char *path, uint64_t itemNum) {
+static void create_file (md_worker_t * w, aiori_dir_t * dh, const char *path, uint64_t itemNum) {
     char curr_item[MAX_PATHLEN];
     aiori_fd_t *aiori_fh = NULL;
+    double start = GetTimeStamp();
+    int size_class;
+    size_t bytes = file_bytes(SIZE_CREATE, itemNum, rank, & size_class);
 
     if ( (itemNum % ITEM_COUNT==0 && (itemNum != 0))) {
         VERBOSE(3,5,"create file: "LLU"", itemNum);
@@ -401,69 +1186,105 @@ static void create_file (const char *path, uint64_t itemNum) {
          * !collective_creates
          */
     } else {
-        o.hints.filePerProc = ! o.shared_file;
         VERBOSE(3,5,"create_remove_items_helper (non-collective, shared): open..." );
 
-        aiori_fh = o.backend->create (curr_item, IOR_WRONLY | IOR_CREAT, o.backend_options);
+        if (dh) {
+            aiori_fh = o.backend->createat (dh, curr_item + strlen(path) + 1, IOR_WRONLY | IOR_CREAT, o.backend_options);
+        } else {
+            aiori_fh = o.backend->create (curr_item, IOR_WRONLY | IOR_CREAT, o.backend_options);
+        }
         if (NULL == aiori_fh){
           WARNF("unable to create file %s", curr_item);
           return;
         }
     }
 
-    if (o.write_bytes > 0) {
+    if (bytes > 0) {
         VERBOSE(3,5,"create_remove_items_helper: write..." );
 
-        o.hints.fsyncPerWrite = o.sync_file;
-        update_write_memory_pattern(itemNum, o.write_buffer, o.write_bytes, o.random_buffer_offset, rank, o.dataPacketType, o.gpuMemoryFlags);
+        update_write_memory_pattern(itemNum, w->write_buffer, bytes, o.random_buffer_offset, rank, o.dataPacketType, o.gpuMemoryFlags);
+        uint64_t tail_word = size_tail_set(w->write_buffer, bytes);
 
-        if ( o.write_bytes != (size_t) o.backend->xfer(WRITE, aiori_fh, (IOR_size_t *) o.write_buffer, o.write_bytes, 0, o.backend_options)) {
+        if ( bytes != (size_t) o.backend->xfer(WRITE, aiori_fh, (IOR_size_t *) w->write_buffer, bytes, 0, o.backend_options)) {
             WARNF("unable to write file %s", curr_item);
         }
 
         if (o.verify_write) {
-            o.write_buffer[0] = 42;
-            if (o.write_bytes != (size_t) o.backend->xfer(READ, aiori_fh, (IOR_size_t *) o.write_buffer, o.write_bytes, 0, o.backend_options)) {
+            w->write_buffer[0] = 42;
+            if (bytes != (size_t) o.backend->xfer(READ, aiori_fh, (IOR_size_t *) w->write_buffer, bytes, 0, o.backend_options)) {
                 WARNF("unable to verify write (read/back) file %s", curr_item);
             }
-            int error = verify_memory_pattern(itemNum, o.write_buffer, o.write_bytes, o.random_buffer_offset, rank, o.dataPacketType, o.gpuMemoryFlags);
-            o.verification_error += error;
+            int error = verify_memory_pattern(itemNum, w->write_buffer, bytes, o.random_buffer_offset, rank, o.dataPacketType, o.gpuMemoryFlags);
+            w->verification_error += error;
             if(error){
                 VERBOSE(1,1,"verification error in file: %s", curr_item);
             }
         }
+        size_tail_restore(w->write_buffer, bytes, tail_word);
     }
 
     VERBOSE(3,5,"create_remove_items_helper: close..." );
     o.backend->close (aiori_fh, o.backend_options);
+    size_class_done(w, SIZE_CREATE, size_class, bytes, start);
 }
 
-/* helper for creating/removing items */
-void create_remove_items_helper(const int dirs, const int create, const char *path,
-                                uint64_t itemNum, rank_progress_t * progress) {
-
-    VERBOSE(1,-1,"Entering create_remove_items_helper on %s", path );
+/* creates or removes the items first to last-1 of a directory */
+static void create_remove_items_range(md_worker_t * w, void * args, uint64_t first, uint64_t last) {
+    md_loop_t * l = (md_loop_t *) args;
+    rank_progress_t * progress = l->progress;
 
-    for (uint64_t i = progress->items_start; i < progress->items_per_dir ; ++i) {
-        if (!dirs) {
+#ifdef HAVE_LINUX_IO_URING_H
+    if (w->ring) {
+        uring_items(w, l, URING_CREATE_REMOVE, first, last);
+        return;
+    }
+#endif
+    for (uint64_t i = first; i < last ; ++i) {
+        if (!l->dirs) {
             double start = GetTimeStamp();
-            if (create) {
-                create_file (path, itemNum + i);
+            if (l->create) {
+                create_file (w, l->dh, l->path, l->itemNum + i);
             } else {
-                remove_file (path, itemNum + i);
+                remove_file (l->dh, l->path, l->itemNum + i);
             }
-            if(progress->ot) OpTimerValue(progress->ot, start - progress->start_time, GetTimeStamp() - start);
+            op_timer_value(progress, start);
         } else {
-            create_remove_dirs (path, create, itemNum + i);
+            create_remove_dirs (l->dh, l->path, l->create, l->itemNum + i);
         }
+        /* the stonewall is only used with a single thread */
         if(CHECK_STONE_WALL(progress)){
           if(progress->items_done == 0){
             progress->items_done = i + 1;
           }
+          l->stonewalled = 1;
           return;
         }
     }
-    progress->items_done = progress->items_per_dir;
+}
+
+/* helper for creating/removing items */
+void create_remove_items_helper(const int dirs, const int create, const char *path,
+                                uint64_t itemNum, rank_progress_t * progress) {
+
+    VERBOSE(1,-1,"Entering create_remove_items_helper on %s", path );
+
+    md_loop_t loop = {.dirs = dirs, .create = create, .path = path, .itemNum = itemNum, .progress = progress};
+
+    /* all items of the call are in this directory */
+    loop.dh = dir_handle_open(path);
+
+    /* the hints are shared by the threads, set them before they start */
+    if (! dirs && create) {
+        if (! o.collective_creates) {
+            o.hints.filePerProc = ! o.shared_file;
+        }
+        o.hints.fsyncPerWrite = o.sync_file;
+    }
+    run_items(create_remove_items_range, & loop, progress->items_start, progress->items_per_dir);
+    if (! loop.stonewalled) {
+        progress->items_done = progress->items_per_dir;
+    }
+    dir_handle_close(loop.dh);
 }
 
 /* helper function to do collective operations */
@@ -473,7 +1294,7 @@ void collective_helper(const int dirs, const int create, const char* path, uint6
     VERBOSE(1,-1,"Entering collective_helper on %s", path );
     for (uint64_t i = progress->items_start ; i < progress->items_per_dir ; ++i) {
         if (dirs) {
-            create_remove_dirs (path, create, itemNum + i);
+            create_remove_dirs (NULL, path, create, itemNum + i);
             continue;
         }
 
@@ -573,22 +1394,27 @@ void create_remove_items(int currDepth, const int dirs, const int create, const
     }
 }
 
-/* stats all of the items created as specified by the input parameters */
-void mdtest_stat(const int random, const int dirs, const long dir_iter, const char *path, rank_progress_t * progress) {
+/* stats the items first to last-1 of the loop */
+static void stat_items(md_worker_t * w, void * args, uint64_t first, uint64_t last) {
+    md_loop_t * l = (md_loop_t *) args;
+    const int dirs = l->dirs;
+    const char *path = l->path;
+    rank_progress_t * progress = l->progress;
     struct stat buf;
     uint64_t parent_dir, item_num = 0;
     char item[MAX_PATHLEN], temp[MAX_PATHLEN];
 
-    VERBOSE(1,-1,"Entering mdtest_stat on %s", path );
-
-    uint64_t stop_items = o.items;
-
-    if( o.directory_loops != 1 ){
-      stop_items = o.items_per_dir;
+#ifdef HAVE_LINUX_IO_URING_H
+    if (w->ring) {
+        uring_items(w, l, URING_STAT, first, last);
+        return;
     }
+#endif
+    dir_handle_cache_t handles;
+    dir_handle_cache_init(& handles);
 
     /* iterate over all of the item IDs */
-    for (uint64_t i = 0 ; i < stop_items ; ++i) {
+    for (uint64_t i = first ; i < last ; ++i) {
         /*
          * It doesn't make sense to pass the address of the array because that would
          * be like passing char **. Tested it on a Cray and it seems to work either
@@ -601,17 +1427,7 @@ void mdtest_stat(const int random, const int dirs, const long dir_iter, const ch
 
 
         /* determine the item number to stat */
-        if (random) {
-            item_num = o.rand_array[i];
-        } else {
-            item_num = i;
-        }
-
-        /* make adjustments if in leaf only mode*/
-        if (o.leaf_only) {
-            item_num += o.items_per_dir *
-                (o.num_dirs_in_tree - (uint64_t) pow( o.branch_factor, o.depth ));
-        }
+        item_num = loop_item_num(l, i);
 
         /* create name of file/dir to stat */
         if (dirs) {
@@ -628,49 +1444,29 @@ void mdtest_stat(const int random, const int dirs, const long dir_iter, const ch
 
         /* determine the path to the file/dir to be stat'ed */
         parent_dir = item_num / o.items_per_dir;
+        aiori_dir_t * dh = dir_handle_cache_get(& handles, path, parent_dir);
 
-        if (parent_dir > 0) {        //item is not in tree's root directory
-
-            /* prepend parent directory to item's path */
-            sprintf(temp, "%s."LLU"/%s", o.base_tree_name, parent_dir, item);
-            strcpy(item, temp);
-
-            //still not at the tree's root dir
-            while (parent_dir > o.branch_factor) {
-                parent_dir = (uint64_t) ((parent_dir-1) / o.branch_factor);
-                sprintf(temp, "%s."LLU"/%s", o.base_tree_name, parent_dir, item);
-                strcpy(item, temp);
-            }
+        if (! dh) {
+            /* Now get item to have the full path */
+            int pos = tree_item_dir(temp, path, parent_dir);
+            sprintf(temp + pos, "/%s", item);
+            strcpy( item, temp );
         }
 
-        /* Now get item to have the full path */
-        sprintf( temp, "%s/%s", path, item );
-        strcpy( item, temp );
-
         /* below temp used to be hiername */
         VERBOSE(3,5,"mdtest_stat %4s: %s", (dirs ? "dir" : "file"), item);
         double start = GetTimeStamp();
-        if (-1 == o.backend->stat (item, &buf, o.backend_options)) {
+        if (-1 == (dh ? o.backend->statat (dh, item, &buf, o.backend_options) : o.backend->stat (item, &buf, o.backend_options))) {
             WARNF("unable to stat %s %s", dirs ? "directory" : "file", item);
         }
-        if(progress->ot) OpTimerValue(progress->ot, start - progress->start_time, GetTimeStamp() - start);        
+        op_timer_value(progress, start);
     }
+    dir_handle_cache_free(& handles);
 }
 
-/* reads all of the items created as specified by the input parameters */
-void mdtest_read(int random, int dirs, const long dir_iter, char *path, rank_progress_t * progress) {
-    uint64_t parent_dir, item_num = 0;
-    char item[MAX_PATHLEN], temp[MAX_PATHLEN];
-    aiori_fd_t *aiori_fh;
-
-    VERBOSE(1,-1,"Entering mdtest_read on %s", path );
-    char *read_buffer;
-
-    /* allocate read buffer */
-    if (o.read_bytes > 0) {
-        read_buffer = aligned_buffer_alloc(o.read_bytes, o.gpuMemoryFlags);
-        invalidate_buffer_pattern(read_buffer, o.read_bytes, o.gpuMemoryFlags);
-    }
+/* stats all of the items created as specified by the input parameters */
+void mdtest_stat(const int random, const int dirs, const long dir_iter, const char *path, rank_progress_t * progress) {
+    VERBOSE(1,-1,"Entering mdtest_stat on %s", path );
 
     uint64_t stop_items = o.items;
 
@@ -678,8 +1474,38 @@ void mdtest_read(int random, int dirs, const long dir_iter, char *path, rank_pro
       stop_items = o.items_per_dir;
     }
 
+    md_loop_t loop = {.random = random, .dirs = dirs, .path = path, .progress = progress};
+
+    /* the random order of the items, the same for every call with the seed */
+    if (random) {
+      PermutationInit(& loop.order, stop_items, o.random_seed);
+    }
+
+    run_items(stat_items, & loop, 0, stop_items);
+}
+
+/* reads the items first to last-1 of the loop */
+static void read_items(md_worker_t * w, void * args, uint64_t first, uint64_t last) {
+    md_loop_t * l = (md_loop_t *) args;
+    const int dirs = l->dirs;
+    const char *path = l->path;
+    rank_progress_t * progress = l->progress;
+    uint64_t parent_dir, item_num = 0;
+    char item[MAX_PATHLEN], temp[MAX_PATHLEN];
+    aiori_fd_t *aiori_fh;
+    char *read_buffer = w->read_buffer;
+
+#ifdef HAVE_LINUX_IO_URING_H
+    if (w->ring) {
+        uring_items(w, l, URING_READ, first, last);
+        return;
+    }
+#endif
+    dir_handle_cache_t handles;
+    dir_handle_cache_init(& handles);
+
     /* iterate over all of the item IDs */
-    for (uint64_t i = 0 ; i < stop_items ; ++i) {
+    for (uint64_t i = first ; i < last ; ++i) {
         /*
          * It doesn't make sense to pass the address of the array because that would
          * be like passing char **. Tested it on a Cray and it seems to work either
@@ -693,17 +1519,7 @@ void mdtest_read(int random, int dirs, const long dir_iter, char *path, rank_pro
         memset(temp, 0, MAX_PATHLEN);
 
         /* determine the item number to read */
-        if (random) {
-            item_num = o.rand_array[i];
-        } else {
-            item_num = i;
-        }
-
-        /* make adjustments if in leaf only mode*/
-        if (o.leaf_only) {
-            item_num += o.items_per_dir *
-                (o.num_dirs_in_tree - (uint64_t) pow (o.branch_factor, o.depth));
-        }
+        item_num = loop_item_num(l, i);
 
         /* create name of file to read */
         if (!dirs) {
@@ -715,66 +1531,342 @@ void mdtest_read(int random, int dirs, const long dir_iter, char *path, rank_pro
 
         /* determine the path to the file/dir to be read'ed */
         parent_dir = item_num / o.items_per_dir;
+        aiori_dir_t * dh = dir_handle_cache_get(& handles, path, parent_dir);
 
-        if (parent_dir > 0) {        //item is not in tree's root directory
-
-            /* prepend parent directory to item's path */
-            sprintf(temp, "%s."LLU"/%s", o.base_tree_name, parent_dir, item);
-            strcpy(item, temp);
-
-            /* still not at the tree's root dir */
-            while (parent_dir > o.branch_factor) {
-                parent_dir = (unsigned long long) ((parent_dir-1) / o.branch_factor);
-                sprintf(temp, "%s."LLU"/%s", o.base_tree_name, parent_dir, item);
-                strcpy(item, temp);
-            }
+        if (! dh) {
+            /* Now get item to have the full path */
+            int pos = tree_item_dir(temp, path, parent_dir);
+            sprintf(temp + pos, "/%s", item);
+            strcpy( item, temp );
         }
 
-        /* Now get item to have the full path */
-        sprintf( temp, "%s/%s", path, item );
-        strcpy( item, temp );
-
         /* below temp used to be hiername */
         VERBOSE(3,5,"mdtest_read file: %s", item);
 
-        o.hints.filePerProc = ! o.shared_file;
-
         double start = GetTimeStamp();
         /* open file for reading */
-        aiori_fh = o.backend->open (item, O_RDONLY, o.backend_options);
+        if (dh) {
+            aiori_fh = o.backend->openat (dh, item, IOR_RDONLY, o.backend_options);
+        } else {
+            aiori_fh = o.backend->open (item, O_RDONLY, o.backend_options);
+        }
         if (NULL == aiori_fh) {
             WARNF("unable to open file %s", item);
             continue;
         }
 
         /* read file */
-        if (o.read_bytes > 0) {
-            invalidate_buffer_pattern(read_buffer, o.read_bytes, o.gpuMemoryFlags);
-            if (o.read_bytes != (size_t) o.backend->xfer(READ, aiori_fh, (IOR_size_t *) read_buffer, o.read_bytes, 0, o.backend_options)) {
+        int size_class;
+        size_t bytes = file_bytes(SIZE_READ, item_num, l->creator, & size_class);
+        if (bytes > 0) {
+            invalidate_buffer_pattern(read_buffer, bytes, o.gpuMemoryFlags);
+            if (bytes != (size_t) o.backend->xfer(READ, aiori_fh, (IOR_size_t *) read_buffer, bytes, 0, o.backend_options)) {
                 WARNF("unable to read file %s", item);
-                o.verification_error += 1;
+                w->verification_error += 1;
                 continue;
             }     
-            int pretend_rank = (2 * o.nstride + rank) % o.size;
             if(o.verify_read){
-              if (o.shared_file) {
-                pretend_rank = rank;
-              }
-              int error = verify_memory_pattern(item_num, read_buffer, o.read_bytes, o.random_buffer_offset, pretend_rank, o.dataPacketType, o.gpuMemoryFlags);
-              o.verification_error += error;
+              int error = verify_memory_pattern(item_num, read_buffer, bytes, o.random_buffer_offset, l->creator, o.dataPacketType, o.gpuMemoryFlags);
+              w->verification_error += error;
               if(error){
                 VERBOSE(1,1,"verification error in file: %s", item);
               }
             }
         }
-        if(progress->ot) OpTimerValue(progress->ot, start - progress->start_time, GetTimeStamp() - start);
+        size_class_done(w, SIZE_READ, size_class, bytes, start);
+        op_timer_value(progress, start);
 
         /* close file */
         o.backend->close (aiori_fh, o.backend_options);
     }
-    if(o.read_bytes){
-      aligned_buffer_free(read_buffer, o.gpuMemoryFlags);
+    dir_handle_cache_free(& handles);
+}
+
+/* reads all of the items created as specified by the input parameters */
+void mdtest_read(int random, int dirs, const long dir_iter, char *path, rank_progress_t * progress) {
+    VERBOSE(1,-1,"Entering mdtest_read on %s", path );
+
+    uint64_t stop_items = o.items;
+
+    if( o.directory_loops != 1 ){
+      stop_items = o.items_per_dir;
+    }
+
+    md_loop_t loop = {.random = random, .dirs = dirs, .path = path, .progress = progress};
+
+    /* the random order of the items, the same for every call with the seed */
+    if (random) {
+      PermutationInit(& loop.order, stop_items, o.random_seed);
     }
+
+    /* the rank that wrote the files */
+    loop.creator = o.shared_file ? rank : neighbor_rank(rank, 2, o.size);
+
+    o.hints.filePerProc = ! o.shared_file;
+    run_items(read_items, & loop, 0, stop_items);
+}
+
+/* a directory listed by a worker */
+typedef struct {
+    md_worker_t * w;
+    const char * dir;
+    aiori_dir_t * dh;          /* to stat the entries or NULL */
+    double start;
+    uint64_t entries;
+} md_listing_t;
+
+static void list_entry(const char * name, unsigned char type, void * arg) {
+    md_listing_t * l = (md_listing_t *) arg;
+    char item[MAX_PATHLEN];
+    struct stat buf;
+    int ret;
+
+    if (l->entries++ == 0) {
+        double t = GetTimeStamp() - l->start;
+        l->w->list_first_sum += t;
+        if (t > l->w->list_first_max) {
+            l->w->list_first_max = t;
+        }
+    }
+    if (! o.list_stat) {
+        return;
+    }
+    if (l->dh) {
+        ret = o.backend->statat (l->dh, name, &buf, o.backend_options);
+    } else {
+        sprintf(item, "%s/%s", l->dir, name);
+        ret = o.backend->stat (item, &buf, o.backend_options);
+    }
+    if (ret == -1) {
+        WARNF("unable to stat %s/%s", l->dir, name);
+    }
+}
+
+/* lists the directories first to last-1 of the tree */
+static void list_items(md_worker_t * w, void * args, uint64_t first, uint64_t last) {
+    md_loop_t * l = (md_loop_t *) args;
+    char dir[MAX_PATHLEN];
+
+    for (uint64_t d = first ; d < last ; ++d) {
+        tree_item_dir(dir, l->path, d);
+        md_listing_t listing = {.w = w, .dir = dir};
+        if (o.list_stat) {
+            listing.dh = dir_handle_open(dir);
+        }
+
+        VERBOSE(3,5,"mdtest_list dir: %s", dir);
+        listing.start = GetTimeStamp();
+        if (-1 == o.backend->readdir (dir, list_entry, & listing, o.backend_options)) {
+            WARNF("unable to list directory %s", dir);
+        }
+        op_timer_value(l->progress, listing.start);
+
+        dir_handle_close(listing.dh);
+        w->list_dirs++;
+        w->list_entries += listing.entries;
+    }
+}
+
+/*
+ * Lists the directories that hold the items, with a shared directory every
+ * process lists the entries of all processes. Returns the number of entries.
+ */
+uint64_t mdtest_list(const char *path, rank_progress_t * progress, mdtest_results_t * res) {
+    VERBOSE(1,-1,"Entering mdtest_list on %s", path );
+
+    uint64_t stop_items = o.items;
+    uint64_t entries = 0;
+
+    if( o.directory_loops != 1 ){
+      stop_items = o.items_per_dir;
+    }
+    if (stop_items == 0 || o.items_per_dir == 0) {
+      return 0;
+    }
+
+    md_loop_t loop = {.path = path, .progress = progress};
+
+    /* the items fill the directories of the tree in order */
+    run_items(list_items, & loop, loop_item_num(& loop, 0) / o.items_per_dir,
+              loop_item_num(& loop, stop_items - 1) / o.items_per_dir + 1);
+
+    for (int t = 0; t < o.threads; t++) {
+        md_worker_t * w = & pool.workers[t];
+        entries += w->list_entries;
+        res->list_dirs += w->list_dirs;
+        res->list_first_entry_sum += w->list_first_sum;
+        if (w->list_first_max > res->list_first_entry_max) {
+            res->list_first_entry_max = w->list_first_max;
+        }
+        w->list_dirs = w->list_entries = 0;
+        w->list_first_sum = w->list_first_max = 0;
+    }
+    return entries;
+}
+
+/* the calls of the phases on the existing files, see file_test_items() */
+enum {FILE_SETXATTR, FILE_GETXATTR, FILE_LISTXATTR, FILE_RENAME, FILE_MOVE, FILE_LINK, FILE_SYMLINK, FILE_READLINK,
+      /* undo a phase after it is measured */
+      FILE_RENAME_BACK, FILE_MOVE_BACK, FILE_UNLINK, FILE_UNSYMLINK};
+
+/* the buffer for the names of listxattr, the Linux limit */
+#define XATTR_LIST_SIZE 65536
+
+/* the value of attribute a of an item, the same for every process */
+static void xattr_value(char * value, uint64_t item_num, int a) {
+    for (int k = 0; k < o.xattr_size; k++) {
+        value[k] = 'a' + (item_num + a + k) % 26;
+    }
+}
+
+/* sets, gets or lists the extended attributes of the items first to last-1 */
+static void xattr_items(md_worker_t * w, void * args, uint64_t first, uint64_t last) {
+    md_loop_t * l = (md_loop_t *) args;
+    rank_progress_t * progress = l->progress;
+    char item[MAX_PATHLEN], name[64];
+    char * value = safeMalloc(o.xattr_size + 1);
+    char * expected = safeMalloc(o.xattr_size + 1);
+    char * list = l->op == FILE_LISTXATTR ? safeMalloc(XATTR_LIST_SIZE) : NULL;
+
+    for (uint64_t i = first ; i < last ; ++i) {
+        uint64_t item_num = loop_item_num(l, i);
+        int pos = tree_item_dir(item, l->path, item_num / o.items_per_dir);
+        sprintf(item + pos, "/file.%s"LLU"", l->name, item_num);
+
+        VERBOSE(3,5,"mdtest_xattr file: %s", item);
+        double start = GetTimeStamp();
+        if (l->op == FILE_LISTXATTR) {
+            if (-1 == o.backend->listxattr (item, list, XATTR_LIST_SIZE, o.backend_options)) {
+                WARNF("unable to list the extended attributes of file %s", item);
+            }
+        } else {
+            for (int a = 0; a < o.xattr_count; a++) {
+                sprintf(name, "user.mdtest.%d", a);
+                xattr_value(expected, item_num, a);
+                if (l->op == FILE_SETXATTR) {
+                    if (-1 == o.backend->setxattr (item, name, expected, o.xattr_size, o.backend_options)) {
+                        WARNF("unable to set extended attribute %s of file %s", name, item);
+                    }
+                    continue;
+                }
+                int ret = o.backend->getxattr (item, name, value, o.xattr_size, o.backend_options);
+                if (ret == -1) {
+                    WARNF("unable to get extended attribute %s of file %s", name, item);
+                } else if (ret != o.xattr_size || memcmp(value, expected, o.xattr_size) != 0) {
+                    w->verification_error += 1;
+                    VERBOSE(1,1,"verification error in extended attribute %s of file: %s", name, item);
+                }
+            }
+        }
+        op_timer_value(progress, start);
+
+        if (CHECK_STONE_WALL(progress)) {
+            progress->items_done = i + 1;
+            break;
+        }
+    }
+    free(list);
+    free(expected);
+    free(value);
+}
+
+/* renames, links or symlinks the items first to last-1, or undoes it */
+static void link_items(md_worker_t * w, void * args, uint64_t first, uint64_t last) {
+    md_loop_t * l = (md_loop_t *) args;
+    rank_progress_t * progress = l->progress;
+    char item[MAX_PATHLEN], target[MAX_PATHLEN], value[MAX_PATHLEN];
+    int ret = 0;
+
+    for (uint64_t i = first ; i < last ; ++i) {
+        uint64_t item_num = loop_item_num(l, i);
+        uint64_t dir = item_num / o.items_per_dir;
+        int pos = tree_item_dir(item, l->path, dir);
+        const char * name = item + pos + 1;
+        sprintf(item + pos, "/file.%s"LLU"", l->name, item_num);
+
+        /* the new name is next to the file, moved files go to the next directory of the process */
+        switch (l->op) {
+        case FILE_RENAME: case FILE_RENAME_BACK:
+            sprintf(target, "%s-renamed", item);
+            break;
+        case FILE_MOVE: case FILE_MOVE_BACK:
+            dir = l->first_dir + (dir - l->first_dir + 1) % l->num_dirs;
+            pos = tree_item_dir(target, l->path, dir);
+            sprintf(target + pos, "/%s-moved", name);
+            break;
+        case FILE_LINK: case FILE_UNLINK:
+            sprintf(target, "%s-link", item);
+            break;
+        default:
+            sprintf(target, "%s-symlink", item);
+        }
+
+        VERBOSE(3,5,"mdtest_link file: %s %s", item, target);
+        double start = GetTimeStamp();
+        switch (l->op) {
+        case FILE_RENAME: case FILE_MOVE:
+            ret = o.backend->rename (item, target, o.backend_options);
+            break;
+        case FILE_RENAME_BACK: case FILE_MOVE_BACK:
+            ret = o.backend->rename (target, item, o.backend_options);
+            break;
+        case FILE_LINK:
+            ret = o.backend->link (item, target, o.backend_options);
+            break;
+        case FILE_SYMLINK:
+            /* relative to the directory, like ln -s */
+            ret = o.backend->symlink (name, target, o.backend_options);
+            break;
+        case FILE_READLINK:
+            ret = o.backend->readlink (target, value, sizeof(value), o.backend_options);
+            if (ret != -1 && (ret != (int) strlen(name) || memcmp(value, name, ret) != 0)) {
+                w->verification_error += 1;
+                VERBOSE(1,1,"verification error in symbolic link: %s", target);
+            }
+            break;
+        default:
+            o.backend->remove (target, o.backend_options);
+        }
+        if (ret == -1) {
+            WARNF("unable to %s file %s", l->op == FILE_LINK ? "link" : l->op == FILE_SYMLINK ? "symlink" :
+                  l->op == FILE_READLINK ? "read the link of" : "rename", l->op == FILE_READLINK ? target : item);
+        }
+        op_timer_value(progress, start);
+
+        if (CHECK_STONE_WALL(progress)) {
+            progress->items_done = i + 1;
+            break;
+        }
+    }
+}
+
+/*
+ * Calls op for the items first to last-1 of the files of a process,
+ * progress->items_done is smaller than last if the stonewall is hit.
+ */
+void mdtest_file_op(const int op, const char *path, const char *name, uint64_t first, uint64_t last, rank_progress_t * progress) {
+    VERBOSE(1,-1,"Entering mdtest_file_op on %s", path );
+
+    uint64_t stop_items = o.items;
+
+    if( o.directory_loops != 1 ){
+      stop_items = o.items_per_dir;
+    }
+
+    md_loop_t loop = {.op = op, .name = name, .path = path, .progress = progress};
+
+    /* the directories of all files, the same for moving them and back */
+    loop.first_dir = loop_item_num(& loop, 0) / o.items_per_dir;
+    loop.num_dirs = loop_item_num(& loop, stop_items - 1) / o.items_per_dir + 1 - loop.first_dir;
+
+    /* the random order of the items, the same for every call with the seed */
+    if ((op == FILE_GETXATTR || op == FILE_LISTXATTR || op == FILE_READLINK) && o.random_seed > 0) {
+      loop.random = 1;
+      PermutationInit(& loop.order, last, o.random_seed);
+    }
+
+    progress->items_done = last;
+    run_items(op <= FILE_LISTXATTR ? xattr_items : link_items, & loop, first, last);
 }
 
 /* This method should be called by rank 0.  It subsequently does all of
@@ -804,23 +1896,23 @@ void collective_create_remove(const int create, const int dirs, const int ntasks
 
         /* set all item names appropriately */
         if (! o.shared_file) {
-            sprintf(o.mk_name, "mdtest.%d.", (i+(0*o.nstride))%ntasks);
-            sprintf(o.stat_name, "mdtest.%d.", (i+(1*o.nstride))%ntasks);
-            sprintf(o.read_name, "mdtest.%d.", (i+(2*o.nstride))%ntasks);
-            sprintf(o.rm_name, "mdtest.%d.", (i+(3*o.nstride))%ntasks);
+            sprintf(o.mk_name, "mdtest.%d.", neighbor_rank(i, 0, ntasks));
+            sprintf(o.stat_name, "mdtest.%d.", neighbor_rank(i, 1, ntasks));
+            sprintf(o.read_name, "mdtest.%d.", neighbor_rank(i, 2, ntasks));
+            sprintf(o.rm_name, "mdtest.%d.", neighbor_rank(i, 3, ntasks));
         }
         if (o.unique_dir_per_task) {
             VERBOSE(3,5,"i %d nstride %d ntasks %d", i, o.nstride, ntasks);
             sprintf(o.unique_mk_dir, "%s/mdtest_tree.%d.0", o.testdir,
-                    (i+(0*o.nstride))%ntasks);
+                    neighbor_rank(i, 0, ntasks));
             sprintf(o.unique_chdir_dir, "%s/mdtest_tree.%d.0", o.testdir,
-                    (i+(1*o.nstride))%ntasks);
+                    neighbor_rank(i, 1, ntasks));
             sprintf(o.unique_stat_dir, "%s/mdtest_tree.%d.0", o.testdir,
-                    (i+(2*o.nstride))%ntasks);
+                    neighbor_rank(i, 2, ntasks));
             sprintf(o.unique_read_dir, "%s/mdtest_tree.%d.0", o.testdir,
-                    (i+(3*o.nstride))%ntasks);
+                    neighbor_rank(i, 3, ntasks));
             sprintf(o.unique_rm_dir, "%s/mdtest_tree.%d.0", o.testdir,
-                    (i+(4*o.nstride))%ntasks);
+                    neighbor_rank(i, 4, ntasks));
             sprintf(o.unique_rm_uni_dir, "%s", o.testdir);
         }
 
@@ -837,22 +1929,22 @@ void collective_create_remove(const int create, const int dirs, const int ntasks
         sprintf(o.base_tree_name, "mdtest_tree");
     }
     if (! o.shared_file) {
-        sprintf(o.mk_name, "mdtest.%d.", (0+(0*o.nstride))%ntasks);
-        sprintf(o.stat_name, "mdtest.%d.", (0+(1*o.nstride))%ntasks);
-        sprintf(o.read_name, "mdtest.%d.", (0+(2*o.nstride))%ntasks);
-        sprintf(o.rm_name, "mdtest.%d.", (0+(3*o.nstride))%ntasks);
+        sprintf(o.mk_name, "mdtest.%d.", neighbor_rank(0, 0, ntasks));
+        sprintf(o.stat_name, "mdtest.%d.", neighbor_rank(0, 1, ntasks));
+        sprintf(o.read_name, "mdtest.%d.", neighbor_rank(0, 2, ntasks));
+        sprintf(o.rm_name, "mdtest.%d.", neighbor_rank(0, 3, ntasks));
     }
     if (o.unique_dir_per_task) {
         sprintf(o.unique_mk_dir, "%s/mdtest_tree.%d.0", o.testdir,
-                (0+(0*o.nstride))%ntasks);
+                neighbor_rank(0, 0, ntasks));
         sprintf(o.unique_chdir_dir, "%s/mdtest_tree.%d.0", o.testdir,
-                (0+(1*o.nstride))%ntasks);
+                neighbor_rank(0, 1, ntasks));
         sprintf(o.unique_stat_dir, "%s/mdtest_tree.%d.0", o.testdir,
-                (0+(2*o.nstride))%ntasks);
+                neighbor_rank(0, 2, ntasks));
         sprintf(o.unique_read_dir, "%s/mdtest_tree.%d.0", o.testdir,
-                (0+(3*o.nstride))%ntasks);
+                neighbor_rank(0, 3, ntasks));
         sprintf(o.unique_rm_dir, "%s/mdtest_tree.%d.0", o.testdir,
-                (0+(4*o.nstride))%ntasks);
+                neighbor_rank(0, 4, ntasks));
         sprintf(o.unique_rm_uni_dir, "%s", o.testdir);
     }
 }
@@ -944,6 +2036,13 @@ static void updateResult(mdtest_results_t * res, mdtest_test_num_t test, uint64_
   }
   res->items[test] = item_count;
   res->stonewall_last_item[test] = o.items;
+  if(o.resource_accounting > 0){
+    ResourcesSample(res->resources[test], o.resource_accounting, testComm);
+    ResourcesDelta(res->resources[test], o.phase_resources);
+  }
+  if(o.perf_counters){
+    memcpy(res->perf[test], o.phase_perf, sizeof(o.phase_perf));
+  }
 }
 
 void directory_test(const int iteration, const int ntasks, const char *path, rank_progress_t * progress) {
@@ -1129,14 +2228,14 @@ void directory_test(const int iteration, const int ntasks, const char *path, ran
 }
 
 /* Returns if the stonewall was hit */
-int updateStoneWallIterations(int iteration, uint64_t items_done, double tstart, uint64_t * out_max_iter){
+int updateStoneWallIterations(int iteration, mdtest_test_num_t test, uint64_t items_done, double tstart, uint64_t * out_max_iter){
   int hit = 0;
   long long unsigned max_iter = 0;
 
   VERBOSE(1,1,"stonewall hit with %lld items", (long long) items_done );
   MPI_CHECK(MPI_Allreduce(& items_done, & max_iter, 1, MPI_LONG_LONG_INT, MPI_MAX, testComm), "MPI_Allreduce error");
-  o.summary_table[iteration].stonewall_time[MDTEST_FILE_CREATE_NUM] = GetTimeStamp() - tstart;
-  o.summary_table[iteration].stonewall_last_item[MDTEST_FILE_CREATE_NUM] = items_done;
+  o.summary_table[iteration].stonewall_time[test] = GetTimeStamp() - tstart;
+  o.summary_table[iteration].stonewall_last_item[test] = items_done;
   *out_max_iter = max_iter;
 
   // continue to the maximum...
@@ -1144,8 +2243,8 @@ int updateStoneWallIterations(int iteration, uint64_t items_done, double tstart,
   MPI_CHECK(MPI_Reduce(& items_done, & min_accessed, 1, MPI_LONG_LONG_INT, MPI_MIN, 0, testComm), "MPI_Reduce error");
   long long sum_accessed = 0;
   MPI_CHECK(MPI_Reduce(& items_done, & sum_accessed, 1, MPI_LONG_LONG_INT, MPI_SUM, 0, testComm), "MPI_Reduce error");
-  o.summary_table[iteration].stonewall_item_sum[MDTEST_FILE_CREATE_NUM] = sum_accessed;
-  o.summary_table[iteration].stonewall_item_min[MDTEST_FILE_CREATE_NUM] = min_accessed * o.size;
+  o.summary_table[iteration].stonewall_item_sum[test] = sum_accessed;
+  o.summary_table[iteration].stonewall_item_min[test] = min_accessed * o.size;
 
   if(o.items != (sum_accessed / o.size)){
     VERBOSE(0,-1, "Continue stonewall hit min: %lld max: %lld avg: %.1f \n", min_accessed, max_iter, ((double) sum_accessed) / o.size);
@@ -1216,7 +2315,7 @@ void file_test_create(const int iteration, const int ntasks, const char *path, r
       // hit the stonewall
       uint64_t max_iter = 0;
       uint64_t items_done = progress->items_done + dir_iter * o.items_per_dir;
-      int hit = updateStoneWallIterations(iteration, items_done, *t_start, & max_iter);
+      int hit = updateStoneWallIterations(iteration, MDTEST_FILE_CREATE_NUM, items_done, *t_start, & max_iter);
       progress->items_start = items_done;
       progress->items_per_dir = max_iter;
       if (hit){
@@ -1227,15 +2326,92 @@ void file_test_create(const int iteration, const int ntasks, const char *path, r
         progress->stone_wall_timer_seconds = o.stone_wall_timer_seconds;
         o.items = progress->items_done;
       }
-      if (o.stoneWallingStatusFile){
-        StoreStoneWallingIterations(o.stoneWallingStatusFile, max_iter);
+      if (o.stoneWallingStatusFile){
+        StoreStoneWallingIterations(o.stoneWallingStatusFile, max_iter);
+      }
+      // reset stone wall timer to allow proper cleanup
+      progress->stone_wall_timer_seconds = 0;
+      // at the moment, stonewall can be done only with one directory_loop, so we can return here safely
+      break;
+    }
+  }
+}
+
+/*
+ * A phase on the existing files, the extended attributes, renames and links,
+ * or undoing one after it was measured. The phases that add names or values
+ * stop at the stonewall, they return the number of files to pass as the
+ * limit to the later phases on them; 0 is for all files.
+ */
+static uint64_t file_test_items(const int iteration, const int op, const char *path, uint64_t limit, rank_progress_t * progress) {
+    static const mdtest_test_num_t tests[] = {MDTEST_FILE_SETXATTR_NUM, MDTEST_FILE_GETXATTR_NUM, MDTEST_FILE_LISTXATTR_NUM,
+      MDTEST_FILE_RENAME_NUM, MDTEST_FILE_RENAME_ACROSS_NUM, MDTEST_FILE_LINK_NUM, MDTEST_FILE_SYMLINK_NUM, MDTEST_FILE_READLINK_NUM};
+    const int measured = op <= FILE_READLINK;
+    const int stonewall = o.stone_wall_timer_seconds && (op == FILE_SETXATTR || op == FILE_RENAME ||
+                          op == FILE_MOVE || op == FILE_LINK || op == FILE_SYMLINK);
+    double t_start, t_end, t_end_before_barrier;
+    char temp_path[MAX_PATHLEN];
+    uint64_t files = 0;
+
+    if (measured) {
+      phase_prepare();
+      if(o.savePerOpDataCSV != NULL) {
+        sprintf(temp_path, "%s-%s-%05d.csv", o.savePerOpDataCSV, mdtest_test_name(tests[op]), rank);
+        progress->ot = OpTimerInit(temp_path, 1);
+      }
+    }
+    if (stonewall) {
+      progress->stone_wall_timer_seconds = o.stone_wall_timer_seconds;
+    }
+    t_start = GetTimeStamp();
+    progress->start_time = t_start;
+    for (int dir_iter = 0; dir_iter < o.directory_loops; dir_iter ++){
+      prep_testdir(iteration, dir_iter);
+      if (o.unique_dir_per_task) {
+          unique_dir_access(op == FILE_SETXATTR ? MK_UNI_DIR : STAT_SUB_DIR, temp_path);
+          if (! o.time_unique_dir_overhead) {
+              t_start = GetTimeStamp();
+          }
+      } else {
+          sprintf( temp_path, "%s/%s", o.testdir, path );
       }
-      // reset stone wall timer to allow proper cleanup
-      progress->stone_wall_timer_seconds = 0;
-      // at the moment, stonewall can be done only with one directory_loop, so we can return here safely
-      break;
+
+      VERBOSE(3,5,"file_test: file operation path is '%s'", temp_path );
+
+      uint64_t stop_items = o.items;
+      if( o.directory_loops != 1 ){
+        stop_items = o.items_per_dir;
+      }
+      if (limit && limit < stop_items) {
+        stop_items = limit;
+      }
+      const char * name = op == FILE_SETXATTR ? o.mk_name : o.stat_name;
+      mdtest_file_op(op, temp_path, name, 0, stop_items, progress);
+      if (stonewall) {
+        // hit the stonewall, continue to the maximum of all processes
+        uint64_t max_iter = 0;
+        updateStoneWallIterations(iteration, tests[op], progress->items_done, t_start, & max_iter);
+        progress->stone_wall_timer_seconds = 0;
+        mdtest_file_op(op, temp_path, name, progress->items_done, max_iter, progress);
+        files = limit = max_iter;
+        // as for the create phase, stonewall can be done only with one directory_loop
+        break;
+      }
+      files += stop_items;
     }
-  }
+    progress->stone_wall_timer_seconds = 0;
+    if (! measured) {
+      return limit;
+    }
+    t_end_before_barrier = GetTimeStamp();
+    phase_end();
+    t_end = GetTimeStamp();
+    OpTimerFree(& progress->ot);
+    if (op == FILE_SETXATTR || op == FILE_GETXATTR) {
+      files *= o.xattr_count;
+    }
+    updateResult(& o.summary_table[iteration], tests[op], files, t_start, t_end, t_end_before_barrier);
+    return limit;
 }
 
 void file_test(const int iteration, const int ntasks, const char *path, rank_progress_t * progress) {
@@ -1286,6 +2462,7 @@ void file_test(const int iteration, const int ntasks, const char *path, rank_pro
       t_end = GetTimeStamp();
       OpTimerFree(& progress->ot);
       updateResult(res, MDTEST_FILE_CREATE_NUM, o.items, t_start, t_end, t_end_before_barrier);
+      size_classes_collect(res, SIZE_CREATE);
     }else{
       if (o.stoneWallingStatusFile){
         int64_t expected_items;
@@ -1310,6 +2487,12 @@ void file_test(const int iteration, const int ntasks, const char *path, rank_pro
       }
     }
 
+    /* setxattr phase */
+    uint64_t xattr_files = 0;
+    if (o.create_only && o.xattr_count > 0) {
+      xattr_files = file_test_items(iteration, FILE_SETXATTR, path, 0, progress);
+    }
+
     /* stat phase */
     if (o.stat_only ) {
       phase_prepare();
@@ -1343,6 +2526,46 @@ void file_test(const int iteration, const int ntasks, const char *path, rank_pro
       updateResult(res, MDTEST_FILE_STAT_NUM, o.items, t_start, t_end, t_end_before_barrier);
     }
 
+    /* listing phase */
+    if (o.list_dirs ) {
+      uint64_t entries = 0;
+      phase_prepare();
+      if(o.savePerOpDataCSV != NULL) {
+        char path[MAX_PATHLEN];
+        sprintf(path, "%s-%s-%05d.csv", o.savePerOpDataCSV, mdtest_test_name(MDTEST_FILE_LIST_NUM), rank);
+        progress->ot = OpTimerInit(path, 1);
+      }
+      t_start = GetTimeStamp();
+      progress->start_time = t_start;
+      for (int dir_iter = 0; dir_iter < o.directory_loops; dir_iter ++){
+        prep_testdir(iteration, dir_iter);
+        if (o.unique_dir_per_task) {
+            unique_dir_access(STAT_SUB_DIR, temp_path);
+            if (!o.time_unique_dir_overhead) {
+                t_start = GetTimeStamp();
+            }
+        } else {
+            sprintf( temp_path, "%s/%s", o.testdir, path );
+        }
+
+        VERBOSE(3,5,"file_test: list path is '%s'", temp_path );
+
+        /* list the directories */
+        entries += mdtest_list(temp_path, progress, res);
+      }
+      t_end_before_barrier = GetTimeStamp();
+      phase_end();
+      t_end = GetTimeStamp();
+      OpTimerFree(& progress->ot);
+      updateResult(res, MDTEST_FILE_LIST_NUM, entries, t_start, t_end, t_end_before_barrier);
+    }
+
+    /* getxattr and listxattr phases */
+    if (o.stat_only && o.xattr_count > 0) {
+      file_test_items(iteration, FILE_GETXATTR, path, xattr_files, progress);
+      file_test_items(iteration, FILE_LISTXATTR, path, xattr_files, progress);
+    }
+
     /* read phase */
     if (o.read_only ) {
       phase_prepare();
@@ -1378,6 +2601,30 @@ void file_test(const int iteration, const int ntasks, const char *path, rank_pro
       t_end = GetTimeStamp();
       OpTimerFree(& progress->ot);
       updateResult(res, MDTEST_FILE_READ_NUM, o.items, t_start, t_end, t_end_before_barrier);
+      size_classes_collect(res, SIZE_READ);
+    }
+
+    /* rename phases, the files get their names back after each */
+    if (o.rename_files) {
+      uint64_t files = file_test_items(iteration, FILE_RENAME, path, 0, progress);
+      file_test_items(iteration, FILE_RENAME_BACK, path, files, progress);
+      if (o.rename_across) {
+        files = file_test_items(iteration, FILE_MOVE, path, 0, progress);
+        file_test_items(iteration, FILE_MOVE_BACK, path, files, progress);
+      }
+    }
+
+    /* link phase */
+    if (o.link_files) {
+      uint64_t files = file_test_items(iteration, FILE_LINK, path, 0, progress);
+      file_test_items(iteration, FILE_UNLINK, path, files, progress);
+    }
+
+    /* symlink and readlink phases */
+    if (o.symlink_files) {
+      uint64_t files = file_test_items(iteration, FILE_SYMLINK, path, 0, progress);
+      file_test_items(iteration, FILE_READLINK, path, files, progress);
+      file_test_items(iteration, FILE_UNSYMLINK, path, files, progress);
     }
 
     /* remove phase */
@@ -1437,6 +2684,28 @@ void file_test(const int iteration, const int ntasks, const char *path, rank_pro
       VERBOSE(1,-1,"  File creation (stonewall): %14.3f sec, %14.3f ops/sec", o.summary_table[iteration].stonewall_time[MDTEST_FILE_CREATE_NUM], o.summary_table[iteration].stonewall_item_sum[MDTEST_FILE_CREATE_NUM]);
     }
     VERBOSE(1,-1,"  File stat         : %14.3f sec, %14.3f ops/sec", res->time[MDTEST_FILE_STAT_NUM], o.summary_table[iteration].rate[MDTEST_FILE_STAT_NUM]);
+    if (mdtest_test_enabled(MDTEST_FILE_LIST_NUM)) {
+      VERBOSE(1,-1,"  File listing      : %14.3f sec, %14.3f entries/sec", res->time[MDTEST_FILE_LIST_NUM], o.summary_table[iteration].rate[MDTEST_FILE_LIST_NUM]);
+    }
+    if (mdtest_test_enabled(MDTEST_FILE_SETXATTR_NUM)) {
+      VERBOSE(1,-1,"  File setxattr     : %14.3f sec, %14.3f ops/sec", res->time[MDTEST_FILE_SETXATTR_NUM], o.summary_table[iteration].rate[MDTEST_FILE_SETXATTR_NUM]);
+      if(o.summary_table[iteration].stonewall_time[MDTEST_FILE_SETXATTR_NUM]){
+        VERBOSE(1,-1,"  File setxattr (stonewall): %14.3f sec, %14.3f ops/sec", o.summary_table[iteration].stonewall_time[MDTEST_FILE_SETXATTR_NUM],
+                (double) o.summary_table[iteration].stonewall_item_sum[MDTEST_FILE_SETXATTR_NUM] * o.xattr_count / o.summary_table[iteration].stonewall_time[MDTEST_FILE_SETXATTR_NUM]);
+      }
+      VERBOSE(1,-1,"  File getxattr     : %14.3f sec, %14.3f ops/sec", res->time[MDTEST_FILE_GETXATTR_NUM], o.summary_table[iteration].rate[MDTEST_FILE_GETXATTR_NUM]);
+      VERBOSE(1,-1,"  File listxattr    : %14.3f sec, %14.3f ops/sec", res->time[MDTEST_FILE_LISTXATTR_NUM], o.summary_table[iteration].rate[MDTEST_FILE_LISTXATTR_NUM]);
+    }
+    for (int t = MDTEST_FILE_RENAME_NUM; t <= MDTEST_FILE_READLINK_NUM; t++) {
+      if (! mdtest_test_enabled(t)) {
+        continue;
+      }
+      VERBOSE(1,-1,"  %-18s: %14.3f sec, %14.3f ops/sec", mdtest_test_name(t), res->time[t], o.summary_table[iteration].rate[t]);
+      if(o.summary_table[iteration].stonewall_time[t]){
+        VERBOSE(1,-1,"  %s (stonewall): %14.3f sec, %14.3f ops/sec", mdtest_test_name(t), o.summary_table[iteration].stonewall_time[t],
+                (double) o.summary_table[iteration].stonewall_item_sum[t] / o.summary_table[iteration].stonewall_time[t]);
+      }
+    }
     VERBOSE(1,-1,"  File read         : %14.3f sec, %14.3f ops/sec", res->time[MDTEST_FILE_READ_NUM], o.summary_table[iteration].rate[MDTEST_FILE_READ_NUM]);
     VERBOSE(1,-1,"  File removal      : %14.3f sec, %14.3f ops/sec", res->time[MDTEST_FILE_REMOVE_NUM], o.summary_table[iteration].rate[MDTEST_FILE_REMOVE_NUM]);
 }
@@ -1452,6 +2721,15 @@ char const * mdtest_test_name(int i){
   case MDTEST_FILE_STAT_NUM:   return "File stat";
   case MDTEST_FILE_READ_NUM:   return "File read";
   case MDTEST_FILE_REMOVE_NUM: return "File removal";
+  case MDTEST_FILE_LIST_NUM:   return "File listing";
+  case MDTEST_FILE_SETXATTR_NUM:  return "File setxattr";
+  case MDTEST_FILE_GETXATTR_NUM:  return "File getxattr";
+  case MDTEST_FILE_LISTXATTR_NUM: return "File listxattr";
+  case MDTEST_FILE_RENAME_NUM:    return "File rename";
+  case MDTEST_FILE_RENAME_ACROSS_NUM: return "File rename across";
+  case MDTEST_FILE_LINK_NUM:      return "File link";
+  case MDTEST_FILE_SYMLINK_NUM:   return "File symlink";
+  case MDTEST_FILE_READLINK_NUM:  return "File readlink";
   case MDTEST_TREE_CREATE_NUM: return "Tree creation";
   case MDTEST_TREE_REMOVE_NUM: return "Tree removal";
   default: return "ERR INVALID TESTNAME      :";
@@ -1460,57 +2738,55 @@ char const * mdtest_test_name(int i){
 }
 
 /*
- * Store the results of each process in a file
+ * Whether the optional phase i runs, the results of disabled phases are not shown.
  */
-static void StoreRankInformation(int iterations, mdtest_results_t * agg){
-  const size_t size = sizeof(mdtest_results_t) * iterations;
-  if(rank == 0){
-    FILE* fd = fopen(o.saveRankDetailsCSV, "a");
-    if (fd == NULL){
-      FAIL("Cannot open saveRankPerformanceDetails file for writes!");
-    }
+static int mdtest_test_enabled(int i){
+  switch (i) {
+  case MDTEST_FILE_LIST_NUM:   return o.list_dirs;
+  case MDTEST_FILE_SETXATTR_NUM:
+  case MDTEST_FILE_GETXATTR_NUM:
+  case MDTEST_FILE_LISTXATTR_NUM: return o.xattr_count > 0;
+  case MDTEST_FILE_RENAME_NUM:    return o.rename_files;
+  case MDTEST_FILE_RENAME_ACROSS_NUM: return o.rename_across;
+  case MDTEST_FILE_LINK_NUM:      return o.link_files;
+  case MDTEST_FILE_SYMLINK_NUM:
+  case MDTEST_FILE_READLINK_NUM:  return o.symlink_files;
+  default: return 1;
+  }
+}
 
-    mdtest_results_t * results = safeMalloc(size * o.size);
-    MPI_CHECK(MPI_Gather(o.summary_table, size / sizeof(double), MPI_DOUBLE, results, size / sizeof(double), MPI_DOUBLE, 0, testComm), "MPI_Gather error");
+/*
+ * Store the results of each process in a file, every process appends its own
+ * line of an iteration with a collective write; rank 0 precedes its first
+ * line with the aggregated results.
+ */
+static void StoreRankInformation(int iterations, mdtest_results_t * agg){
+  char buff[8192];
 
-    char buff[4096];
+  for(int iter = 0; iter < iterations; iter++){
+    mdtest_results_t * cur = & o.summary_table[iter];
     char * cpos = buff;
-    cpos += sprintf(cpos, "all,%llu", (long long unsigned) o.items);
-    for(int e = 0; e < MDTEST_LAST_NUM; e++){
-      if(agg->items[e] == 0){
+    if(rank == 0 && iter == 0){
+      cpos += sprintf(cpos, "all,%llu", (long long unsigned) o.items);
+      for(int e = 0; e < MDTEST_LAST_NUM; e++){
+        if(agg->items[e] == 0){
+          cpos += sprintf(cpos, ",,");
+        }else{
+          cpos += sprintf(cpos, ",%.10e,%.10e", agg->items[e] / agg->time[e], agg->time[e]);
+        }
+      }
+      cpos += sprintf(cpos, "\n");
+    }
+    cpos += sprintf(cpos, "%d,", rank);
+    for(int e = 0; e < MDTEST_TREE_CREATE_NUM; e++){
+      if(cur->items[e] == 0){
         cpos += sprintf(cpos, ",,");
       }else{
-        cpos += sprintf(cpos, ",%.10e,%.10e", agg->items[e] / agg->time[e], agg->time[e]);
+        cpos += sprintf(cpos, ",%.10e,%.10e", cur->items[e] / cur->time_before_barrier[e], cur->time_before_barrier[e]);
       }
     }
     cpos += sprintf(cpos, "\n");
-    int ret = fwrite(buff, cpos - buff, 1, fd);
-
-    for(int iter = 0; iter < iterations; iter++){
-      for(int i=0; i < o.size; i++){
-        mdtest_results_t * cur = & results[i * iterations + iter];
-        cpos = buff;
-        cpos += sprintf(cpos, "%d,", i);
-        for(int e = 0; e < MDTEST_TREE_CREATE_NUM; e++){
-          if(cur->items[e] == 0){
-            cpos += sprintf(cpos, ",,");
-          }else{
-            cpos += sprintf(cpos, ",%.10e,%.10e", cur->items[e] / cur->time_before_barrier[e], cur->time_before_barrier[e]);
-          }
-        }
-        cpos += sprintf(cpos, "\n");
-        ret = fwrite(buff, cpos - buff, 1, fd);
-        if(ret != 1){
-          WARN("Couln't append to saveRankPerformanceDetailsCSV file\n");
-          break;
-        }
-      }
-    }
-    fclose(fd);
-    free(results);
-  }else{
-    /* this is a hack for now assuming all datatypes in the structure are double */
-    MPI_CHECK(MPI_Gather(o.summary_table, size / sizeof(double), MPI_DOUBLE, NULL, size / sizeof(double), MPI_DOUBLE, 0, testComm), "MPI_Gather error");
+    AppendRankRecords(o.saveRankDetailsCSV, buff, cpos - buff, testComm);
   }
 }
 
@@ -1585,6 +2861,9 @@ static void summarize_results_rank0(int iterations,  mdtest_results_t * all_resu
   }  
   PRINT("               ---            ---           ----        -------\n");
   for (int i = start; i < stop; i++) {
+    if (! mdtest_test_enabled(i)) {
+      continue;
+    }
     min = 1e308;
     max = 0;
     sum = var = 0;
@@ -1720,6 +2999,159 @@ static void summarize_results_rank0(int iterations,  mdtest_results_t * all_resu
   }
 }
 
+/*
+ Output the resources used per operation, summed over the processes and iterations
+ */
+static void summarize_resources_rank0(int iterations, mdtest_results_t * results){
+  VERBOSE(0, -1, "\nSUMMARY resources (per operation, summed over processes and iterations):");
+  VERBOSE(0, -1, "   Operation              %14s %14s %14s %14s %14s %14s", "CPU(us)", "rw syscalls", "ctxsw", "faults", "dev bytes", "net bytes");
+  VERBOSE(0, -1, "   ---------              %14s %14s %14s %14s %14s %14s", "-------", "-----------", "-----", "------", "---------", "---------");
+  for (int i = 0; i < MDTEST_TREE_CREATE_NUM; i++) {
+    double res[IOR_NB_RES] = {0};
+    double items = 0;
+    for (int j = 0; j < iterations; j++) {
+      items += results[j].items[i];
+      for (int k = 0; k < IOR_NB_RES; k++) {
+        res[k] += results[j].resources[i][k];
+      }
+    }
+    if (items == 0) {
+      continue;
+    }
+    /* the disks of the nodes if sampled, else what the processes sent to storage */
+    double device = o.resource_accounting >= 2 ? res[IOR_RES_DISK_READ] + res[IOR_RES_DISK_WRITE] :
+                                                 res[IOR_RES_READ_BYTES] + res[IOR_RES_WRITE_BYTES];
+    fprintf(out_logfile, "   %-22s %14.3f %14.3f %14.3f %14.3f %14.1f ", mdtest_test_name(i),
+            (res[IOR_RES_CPU_USER] + res[IOR_RES_CPU_SYS]) * 1e6 / items,
+            (res[IOR_RES_SYSCR] + res[IOR_RES_SYSCW]) / items,
+            (res[IOR_RES_VOL_CTXSW] + res[IOR_RES_INVOL_CTXSW]) / items,
+            (res[IOR_RES_MINFLT] + res[IOR_RES_MAJFLT]) / items, device / items);
+    if (o.resource_accounting >= 2) {
+      fprintf(out_logfile, "%14.1f\n", (res[IOR_RES_NET_RX] + res[IOR_RES_NET_TX]) / items);
+    } else {
+      fprintf(out_logfile, "%14s\n", "NA");
+    }
+  }
+  fflush(out_logfile);
+}
+
+/*
+ Output the hardware events per operation, summed over the processes and iterations
+ */
+static void summarize_perf_counters_rank0(int iterations, mdtest_results_t * results){
+  VERBOSE(0, -1, "\nSUMMARY hardware counters (per operation, summed over processes and iterations):");
+  VERBOSE(0, -1, "   Operation              %14s %14s %14s %14s %14s", "cycles", "instructions", "IPC", "LLC misses", "dTLB misses");
+  VERBOSE(0, -1, "   ---------              %14s %14s %14s %14s %14s", "------", "------------", "---", "----------", "-----------");
+  for (int i = 0; i < MDTEST_TREE_CREATE_NUM; i++) {
+    double perf[IOR_NB_PERF] = {0};
+    double items = 0;
+    for (int j = 0; j < iterations; j++) {
+      items += results[j].items[i];
+      for (int k = 0; k < IOR_NB_PERF; k++) {
+        perf[k] += results[j].perf[i][k];
+      }
+    }
+    if (items == 0) {
+      continue;
+    }
+    double value[5] = {perf[IOR_PERF_CYCLES] / items, perf[IOR_PERF_INSTRUCTIONS] / items,
+                       perf[IOR_PERF_INSTRUCTIONS] / perf[IOR_PERF_CYCLES],
+                       perf[IOR_PERF_CACHE_MISSES] / items, perf[IOR_PERF_DTLB_MISSES] / items};
+    fprintf(out_logfile, "   %-22s", mdtest_test_name(i));
+    for (int k = 0; k < 5; k++) {
+      if (isfinite(value[k])) {
+        fprintf(out_logfile, " %14.*f", k == 2 ? 3 : 1, value[k]);
+      } else {
+        fprintf(out_logfile, " %14s", "NA");
+      }
+    }
+    fprintf(out_logfile, "\n");
+  }
+  fflush(out_logfile);
+}
+
+/*
+ Output the directories listed and the time until their first entry, summed over the processes and iterations
+ */
+static void summarize_listing_rank0(int iterations, mdtest_results_t * results){
+  uint64_t dirs = 0, entries = 0;
+  double first_sum = 0, first_max = 0;
+  for (int j = 0; j < iterations; j++) {
+    dirs += results[j].list_dirs;
+    entries += results[j].items[MDTEST_FILE_LIST_NUM];
+    first_sum += results[j].list_first_entry_sum;
+    if (results[j].list_first_entry_max > first_max) {
+      first_max = results[j].list_first_entry_max;
+    }
+  }
+  if (dirs == 0) {
+    return;
+  }
+  VERBOSE(0, -1, "\nSUMMARY directory listing (summed over processes and iterations):");
+  VERBOSE(0, -1, "   Operation              %14s %14s %14s %14s", "directories", "entries/dir", "first (ms)", "max first (ms)");
+  VERBOSE(0, -1, "   ---------              %14s %14s %14s %14s", "-----------", "-----------", "----------", "--------------");
+  fprintf(out_logfile, "   %-22s %14llu %14.1f %14.3f %14.3f\n", mdtest_test_name(MDTEST_FILE_LIST_NUM),
+          (unsigned long long) dirs, (double) entries / dirs, first_sum * 1e3 / dirs, first_max * 1e3);
+  fflush(out_logfile);
+}
+
+/* a size with a binary suffix if it is a multiple of it */
+static void size_label(char * buf, uint64_t size){
+  const char * suffix[] = {"", "K", "M", "G", "T"};
+  int s = 0;
+  while (s < 4 && size >= 1024 && size % 1024 == 0) {
+    size /= 1024;
+    s++;
+  }
+  sprintf(buf, "%llu%s", (unsigned long long) size, suffix[s]);
+}
+
+/*
+ Output the files created and read per size class, summed over the processes and iterations.
+ The time of a phase is split among the classes by the time of their operations.
+ */
+static void summarize_sizes_rank0(int iterations, mdtest_results_t * results){
+  const mdtest_test_num_t tests[2] = {MDTEST_FILE_CREATE_NUM, MDTEST_FILE_READ_NUM};
+
+  VERBOSE(0, -1, "\nSUMMARY file sizes (summed over processes and iterations):");
+  VERBOSE(0, -1, "   Operation              %-14s %14s %14s %14s %14s", "size", "files", "ops/sec", "MiB/sec", "mean (ms)");
+  VERBOSE(0, -1, "   ---------              %-14s %14s %14s %14s %14s", "----", "-----", "-------", "-------", "---------");
+  for (int phase = 0; phase < 2; phase++) {
+    for (int c = 0; c < sizes.count; c++) {
+      uint64_t items = 0, bytes = 0;
+      double time = 0, op_time = 0;
+      for (int j = 0; j < iterations; j++) {
+        double phase_op_time = 0;
+        for (int k = 0; k < sizes.count; k++) {
+          phase_op_time += results[j].size_time[phase][k];
+        }
+        if (phase_op_time > 0) {
+          time += results[j].time[tests[phase]] * results[j].size_time[phase][c] / phase_op_time;
+        }
+        items += results[j].size_items[phase][c];
+        bytes += results[j].size_bytes[phase][c];
+        op_time += results[j].size_time[phase][c];
+      }
+      if (items == 0) {
+        continue;
+      }
+      char label[64], min[32], max[32];
+      size_label(min, sizes.c[c].min);
+      size_label(max, sizes.c[c].max);
+      if (sizes.lognormal) {
+        sprintf(label, "<= %s", max);
+      } else if (sizes.c[c].min == sizes.c[c].max) {
+        sprintf(label, "%s", min);
+      } else {
+        sprintf(label, "%s-%s", min, max);
+      }
+      fprintf(out_logfile, "   %-22s %-14s %14llu %14.3f %14.3f %14.3f\n", mdtest_test_name(tests[phase]), label,
+              (unsigned long long) items, time > 0 ? items / time : 0, time > 0 ? bytes / time / MEBIBYTE : 0, op_time * 1e3 / items);
+    }
+  }
+  fflush(out_logfile);
+}
+
 /*
  Output the results and summarize them into rank 0's o.summary_table
  */
@@ -1737,6 +3169,8 @@ void summarize_results(int iterations, mdtest_results_t * results) {
         double max_time = 0;
         double max_stonewall_time = 0;
         uint64_t sum_items = 0;
+        memset(results[j].resources[i], 0, sizeof(results[j].resources[i]));
+        memset(results[j].perf[i], 0, sizeof(results[j].perf[i]));
 
         // reduce over the processes
         for(int p=0; p < o.size; p++){
@@ -1749,6 +3183,12 @@ void summarize_results(int iterations, mdtest_results_t * results) {
 
           t = cur->stonewall_time[i];
           max_stonewall_time = max_stonewall_time < t ? t : max_stonewall_time;
+          for(int k=0; k < IOR_NB_RES; k++){
+            results[j].resources[i][k] += cur->resources[i][k];
+          }
+          for(int k=0; k < IOR_NB_PERF; k++){
+            results[j].perf[i][k] += cur->perf[i][k];
+          }
         }
 
         results[j].items[i] = sum_items;
@@ -1765,6 +3205,27 @@ void summarize_results(int iterations, mdtest_results_t * results) {
         results[j].stonewall_item_min[i] = o.summary_table[j].stonewall_item_min[i];
         results[j].stonewall_time[i] = o.summary_table[j].stonewall_time[i];
       }
+
+      results[j].list_dirs = 0;
+      results[j].list_first_entry_sum = results[j].list_first_entry_max = 0;
+      memset(results[j].size_items, 0, sizeof(results[j].size_items));
+      memset(results[j].size_bytes, 0, sizeof(results[j].size_bytes));
+      memset(results[j].size_time, 0, sizeof(results[j].size_time));
+      for(int p=0; p < o.size; p++){
+        mdtest_results_t * cur = get_result_index(all_results, p, j, iterations);
+        for(int phase=0; phase < 2; phase++){
+          for(int c=0; c < MDTEST_SIZE_CLASSES; c++){
+            results[j].size_items[phase][c] += cur->size_items[phase][c];
+            results[j].size_bytes[phase][c] += cur->size_bytes[phase][c];
+            results[j].size_time[phase][c] += cur->size_time[phase][c];
+          }
+        }
+        results[j].list_dirs += cur->list_dirs;
+        results[j].list_first_entry_sum += cur->list_first_entry_sum;
+        if (cur->list_first_entry_max > results[j].list_first_entry_max) {
+          results[j].list_first_entry_max = cur->list_first_entry_max;
+        }
+      }
     }
   }else{
     MPI_CHECK(MPI_Gather(o.summary_table, size / sizeof(double), MPI_DOUBLE, NULL, size / sizeof(double), MPI_DOUBLE, 0, testComm), "MPI_Gather error");
@@ -1791,6 +3252,18 @@ void summarize_results(int iterations, mdtest_results_t * results) {
   }else{
     summarize_results_rank0(iterations, all_results, o.print_time);
   }
+  if (o.resource_accounting > 0){
+    summarize_resources_rank0(iterations, results);
+  }
+  if (o.perf_counters){
+    summarize_perf_counters_rank0(iterations, results);
+  }
+  if (o.list_dirs){
+    summarize_listing_rank0(iterations, results);
+  }
+  if (sizes.count > 0){
+    summarize_sizes_rank0(iterations, results);
+  }
 
   free(all_results);
 }
@@ -1819,6 +3292,70 @@ void md_validate_tests() {
         o.dirs_only = 0;
     }
 
+    if (o.threads < 1) {
+        FAIL("the number of threads must be at least 1");
+    }
+#ifndef HAVE_PTHREAD
+    if (o.threads > 1) {
+        FAIL("--threads needs POSIX threads, mdtest was built without them");
+    }
+#endif
+    if (o.threads > 1 && o.stone_wall_timer_seconds > 0) {
+        FAIL("the stonewall timer is not supported with several threads");
+    }
+    if (o.threads > 1 && strcmp(o.backend->name, "POSIX") != 0) {
+        FAIL("--threads is only supported by the POSIX backend, the %s backend is not thread-safe", o.backend->name);
+    }
+    if (o.threads > 1 && o.perf_counters) {
+        FAIL("--perfCounters counts the events of the main thread only, it is not supported with several threads");
+    }
+
+    if (o.uring_depth < 0 || o.uring_batch < 0) {
+        FAIL("the io_uring depth and batch must not be negative");
+    }
+    if (o.uring_depth > 0) {
+#ifndef HAVE_LINUX_IO_URING_H
+        FAIL("--uringDepth needs io_uring, mdtest was built without it");
+#endif
+        if (strcmp(o.backend->name, "POSIX") != 0) {
+            FAIL("--uringDepth is only supported by the POSIX backend");
+        }
+        if (o.shared_file || o.make_node || o.dir_handles || o.gpuMemoryFlags != IOR_MEMORY_TYPE_CPU) {
+            FAIL("--uringDepth does not support -S, -k, --dirHandles or GPU buffers");
+        }
+    }
+
+    if (o.list_stat && ! o.list_dirs) {
+        FAIL("--readdirStat requires the listing phase (--readdir)");
+    }
+    if (o.list_dirs && ! o.backend->readdir) {
+        FAIL("the %s backend does not support listing directories (--readdir)", o.backend->name);
+    }
+
+    if (o.xattr_count < 0 || o.xattr_size < 0) {
+        FAIL("the number and size of the extended attributes must not be negative");
+    }
+    if (o.xattr_count > 0 && (! o.backend->setxattr || ! o.backend->getxattr || ! o.backend->listxattr)) {
+        FAIL("the %s backend does not support extended attributes (--xattrs)", o.backend->name);
+    }
+
+    if ((o.rename_files || o.link_files || o.symlink_files) && o.shared_file) {
+        FAIL("--renameFiles, --links and --symlinks are not compatible with -S");
+    }
+    if (o.rename_files && ! o.backend->rename) {
+        FAIL("the %s backend does not support renames (--renameFiles)", o.backend->name);
+    }
+    if (o.link_files && ! o.backend->link) {
+        FAIL("the %s backend does not support hard links (--links)", o.backend->name);
+    }
+    if (o.symlink_files && (! o.backend->symlink || ! o.backend->readlink)) {
+        FAIL("the %s backend does not support symbolic links (--symlinks)", o.backend->name);
+    }
+
+    if (o.dir_handles && ! o.backend->opendir) {
+        FAIL("the %s backend does not support directory handles (--dirHandles)", o.backend->name);
+    }
+
     /* check for no barriers with shifting processes for different phases.
        that is, one may not specify both -B and -N as it will introduce
        race conditions that may cause errors stat'ing or deleting after
@@ -1875,6 +3412,22 @@ void md_validate_tests() {
          FAIL("items must be a multiple of items per directory");
        }
     }
+    if (o.size_distribution) {
+        if (o.write_bytes > 0 || o.read_bytes > 0) {
+            FAIL("--sizeDistribution replaces -w and -e");
+        }
+        if (o.shared_file) {
+            FAIL("--sizeDistribution is not compatible with -S");
+        }
+        if (o.gpuMemoryFlags == IOR_MEMORY_TYPE_GPU_DEVICE_ONLY) {
+            FAIL("--sizeDistribution requires buffers the host can access");
+        }
+        size_distribution_parse(o.size_distribution);
+        o.write_bytes = o.read_bytes = sizes.max;
+    } else {
+        size_distribution_parse(NULL);
+    }
+
     /* check for using mknod */
     if (o.write_bytes > 0 && o.make_node) {
         FAIL("-k not compatible with -w");
@@ -2041,6 +3594,78 @@ void create_remove_directory_tree(int create,
     }
 }
 
+/*
+ * Path of directory n of a tree below o.testdir, the directories are numbered
+ * level by level from the root 0 and the children of n are b*n+1 to b*n+b.
+ */
+static int tree_dir_path(char * out, const char * base, uint64_t n){
+  if (n == 0) {
+    return sprintf(out, "%s/%s.0/", o.testdir, base);
+  }
+  int pos = tree_dir_path(out, base, (n - 1) / o.branch_factor);
+  return pos + sprintf(out + pos, "%s.%llu/", base, (unsigned long long) n);
+}
+
+/*
+ * Create or remove the directory tree, or the trees of all processes for
+ * collective creates, level by level: the directories of a level are
+ * partitioned among the processes, a barrier separates the levels.
+ */
+static void create_remove_directory_tree_distributed(int create){
+  const int trees = o.unique_dir_per_task ? o.size : 1;
+  uint64_t level_first[o.depth + 1];
+  uint64_t level_count[o.depth + 1];
+  char base[MAX_PATHLEN];
+  char dir[MAX_PATHLEN];
+  int me;
+
+  MPI_CHECK(MPI_Comm_rank(testComm, & me), "MPI_Comm_rank error");
+  level_first[0] = 0;
+  level_count[0] = 1;
+  for (int l = 1; l <= o.depth; l++) {
+    level_first[l] = level_first[l - 1] + level_count[l - 1];
+    level_count[l] = level_count[l - 1] * o.branch_factor;
+  }
+
+  for (int s = 0; s <= o.depth; s++) {
+    const int level = create ? s : o.depth - s;
+    const uint64_t items = level_count[level] * trees;
+    const uint64_t start = items * me / o.size;
+    const uint64_t end = items * (me + 1) / o.size;
+
+    VERBOSE(3,5,"create_remove_directory_tree_distributed: level %d, directories %llu to %llu", level, (unsigned long long) start, (unsigned long long) end);
+    for (uint64_t k = start; k < end; k++) {
+      if (o.unique_dir_per_task) {
+        sprintf(base, "mdtest_tree.%d", (int) (k / level_count[level]));
+      } else {
+        strcpy(base, o.base_tree_name);
+      }
+      tree_dir_path(dir, base, level_first[level] + k % level_count[level]);
+      if (create) {
+        VERBOSE(2,5,"Making directory '%s'", dir);
+        if (-1 == o.backend->mkdir(dir, DIRMODE, o.backend_options)) {
+          WARNF("unable to create tree directory '%s'", dir);
+        }
+#ifdef HAVE_LUSTRE_LUSTREAPI
+        /* internal node for branching, can be non-striped for children */
+        if (level == 0 && o.global_dir_layout && \
+            llapi_dir_set_default_lmv_stripe(dir, -1, 0,
+                                             LMV_HASH_TYPE_FNV_1A_64,
+                                             NULL) == -1) {
+          FAIL("Unable to reset to global default directory layout");
+        }
+#endif /* HAVE_LUSTRE_LUSTREAPI */
+      } else {
+        VERBOSE(2,5,"Remove directory '%s'", dir);
+        if (-1 == o.backend->rmdir(dir, o.backend_options)) {
+          WARNF("Unable to remove directory %s", dir);
+        }
+      }
+    }
+    MPI_CHECK(MPI_Barrier(testComm), "MPI_Barrier error");
+  }
+}
+
 static void mdtest_iteration(int i, int j, mdtest_results_t * summary_table){
   rank_progress_t progress_o;
   memset(& progress_o, 0 , sizeof(progress_o));
@@ -2050,7 +3675,8 @@ static void mdtest_iteration(int i, int j, mdtest_results_t * summary_table){
 
   /* start and end times of directory tree create/remove */
   double startCreate, endCreate;
-  int k;
+  /* collective creates build the trees of all processes */
+  const uint64_t tree_dirs = o.num_dirs_in_tree * (o.unique_dir_per_task && o.collective_creates ? o.size : 1);
 
   VERBOSE(1,-1,"main: * iteration %d *", j+1);
 
@@ -2082,34 +3708,19 @@ static void mdtest_iteration(int i, int j, mdtest_results_t * summary_table){
     for (int dir_iter = 0; dir_iter < o.directory_loops; dir_iter ++){
       prep_testdir(j, dir_iter);
 
-      if (o.unique_dir_per_task) {
-        if (o.collective_creates && (rank == 0)) {
-          /*
-           * This is inside two loops, one of which already uses "i" and the other uses "j".
-           * I don't know how this ever worked. I'm changing this loop to use "k".
-           */
-          for (k=0; k < o.size; k++) {
-            sprintf(o.base_tree_name, "mdtest_tree.%d", k);
-
-            VERBOSE(3,5,"main (create hierarchical directory loop-collective): Calling create_remove_directory_tree with '%s'", o.testdir );
-            /*
-             * Let's pass in the path to the directory we most recently made so that we can use
-             * full paths in the other calls.
-             */
-            create_remove_directory_tree(1, 0, o.testdir, 0, progress);
-            if(CHECK_STONE_WALL(progress)){
-              o.size = k;
-              break;
-            }
-          }
-        } else if (! o.collective_creates) {
-          VERBOSE(3,5,"main (create hierarchical directory loop-!collective_creates): Calling create_remove_directory_tree with '%s'", o.testdir );
-          /*
-           * Let's pass in the path to the directory we most recently made so that we can use
-           * full paths in the other calls.
-           */
-          create_remove_directory_tree(1, 0, o.testdir, 0, progress);
-        }
+      /*
+       * the processes share the test directory, the tree can be built by all
+       * of them; like the other tree paths it is not stonewalled
+       */
+      if (o.path_count <= 1 && (! o.unique_dir_per_task || o.collective_creates)) {
+        create_remove_directory_tree_distributed(1);
+      } else if (o.unique_dir_per_task) {
+        VERBOSE(3,5,"main (create hierarchical directory loop-!collective_creates): Calling create_remove_directory_tree with '%s'", o.testdir );
+        /*
+         * Let's pass in the path to the directory we most recently made so that we can use
+         * full paths in the other calls.
+         */
+        create_remove_directory_tree(1, 0, o.testdir, 0, progress);
       } else {
         if (rank == 0) {
           VERBOSE(3,5,"main (create hierarchical directory loop-!unque_dir_per_task): Calling create_remove_directory_tree with '%s'", o.testdir );
@@ -2124,10 +3735,10 @@ static void mdtest_iteration(int i, int j, mdtest_results_t * summary_table){
     }
     MPI_CHECK(MPI_Barrier(testComm), "MPI_Barrier error");
     endCreate = GetTimeStamp();
-    summary_table->rate[MDTEST_TREE_CREATE_NUM] = o.num_dirs_in_tree / (endCreate - startCreate);
+    summary_table->rate[MDTEST_TREE_CREATE_NUM] = tree_dirs / (endCreate - startCreate);
     summary_table->time[MDTEST_TREE_CREATE_NUM] = (endCreate - startCreate);
-    summary_table->items[MDTEST_TREE_CREATE_NUM] = o.num_dirs_in_tree;
-    summary_table->stonewall_last_item[MDTEST_TREE_CREATE_NUM] = o.num_dirs_in_tree;
+    summary_table->items[MDTEST_TREE_CREATE_NUM] = tree_dirs;
+    summary_table->stonewall_last_item[MDTEST_TREE_CREATE_NUM] = tree_dirs;
     VERBOSE(1,-1,"V-1: main:   Tree creation     : %14.3f sec, %14.3f ops/sec", (endCreate - startCreate), summary_table->rate[MDTEST_TREE_CREATE_NUM]);
   }
 
@@ -2144,18 +3755,18 @@ static void mdtest_iteration(int i, int j, mdtest_results_t * summary_table){
 
   if (rank < i) {
       if (! o.shared_file) {
-          sprintf(o.mk_name, "mdtest.%d.", (rank+(0*o.nstride))%i);
-          sprintf(o.stat_name, "mdtest.%d.", (rank+(1*o.nstride))%i);
-          sprintf(o.read_name, "mdtest.%d.", (rank+(2*o.nstride))%i);
-          sprintf(o.rm_name, "mdtest.%d.", (rank+(3*o.nstride))%i);
+          sprintf(o.mk_name, "mdtest.%d.", neighbor_rank(rank, 0, i));
+          sprintf(o.stat_name, "mdtest.%d.", neighbor_rank(rank, 1, i));
+          sprintf(o.read_name, "mdtest.%d.", neighbor_rank(rank, 2, i));
+          sprintf(o.rm_name, "mdtest.%d.", neighbor_rank(rank, 3, i));
       }
       if (o.unique_dir_per_task) {
           VERBOSE(3,5,"i %d nstride %d", i, o.nstride);
-          sprintf(o.unique_mk_dir, "mdtest_tree.%d.0",  (rank+(0*o.nstride))%i);
-          sprintf(o.unique_chdir_dir, "mdtest_tree.%d.0", (rank+(1*o.nstride))%i);
-          sprintf(o.unique_stat_dir, "mdtest_tree.%d.0", (rank+(2*o.nstride))%i);
-          sprintf(o.unique_read_dir, "mdtest_tree.%d.0", (rank+(3*o.nstride))%i);
-          sprintf(o.unique_rm_dir, "mdtest_tree.%d.0", (rank+(4*o.nstride))%i);
+          sprintf(o.unique_mk_dir, "mdtest_tree.%d.0",  neighbor_rank(rank, 0, i));
+          sprintf(o.unique_chdir_dir, "mdtest_tree.%d.0", neighbor_rank(rank, 1, i));
+          sprintf(o.unique_stat_dir, "mdtest_tree.%d.0", neighbor_rank(rank, 2, i));
+          sprintf(o.unique_read_dir, "mdtest_tree.%d.0", neighbor_rank(rank, 3, i));
+          sprintf(o.unique_rm_dir, "mdtest_tree.%d.0", neighbor_rank(rank, 4, i));
           o.unique_rm_uni_dir[0] = 0;
           VERBOSE(5,5,"mk_dir %s chdir %s stat_dir %s read_dir %s rm_dir %s\n", o.unique_mk_dir, o.unique_chdir_dir, o.unique_stat_dir, o.unique_read_dir, o.unique_rm_dir);
       }
@@ -2189,36 +3800,16 @@ static void mdtest_iteration(int i, int j, mdtest_results_t * summary_table){
       startCreate = GetTimeStamp();
       for (int dir_iter = 0; dir_iter < o.directory_loops; dir_iter ++){
         prep_testdir(j, dir_iter);
-        if (o.unique_dir_per_task) {
-            if (o.collective_creates && (rank == 0)) {
-                /*
-                 * This is inside two loops, one of which already uses "i" and the other uses "j".
-                 * I don't know how this ever worked. I'm changing this loop to use "k".
-                 */
-                for (k=0; k < o.size; k++) {
-                    sprintf(o.base_tree_name, "mdtest_tree.%d", k);
-
-                    VERBOSE(3,-1,"main (remove hierarchical directory loop-collective): Calling create_remove_directory_tree with '%s'", o.testdir );
-
-                    /*
-                     * Let's pass in the path to the directory we most recently made so that we can use
-                     * full paths in the other calls.
-                     */
-                    create_remove_directory_tree(0, 0, o.testdir, 0, progress);
-                    if(CHECK_STONE_WALL(progress)){
-                      o.size = k;
-                      break;
-                    }
-                }
-            } else if (! o.collective_creates) {
-                VERBOSE(3,-1,"main (remove hierarchical directory loop-!collective): Calling create_remove_directory_tree with '%s'", o.testdir );
+        if (o.path_count <= 1 && (! o.unique_dir_per_task || o.collective_creates)) {
+            create_remove_directory_tree_distributed(0);
+        } else if (o.unique_dir_per_task) {
+            VERBOSE(3,-1,"main (remove hierarchical directory loop-!collective): Calling create_remove_directory_tree with '%s'", o.testdir );
 
-                /*
-                 * Let's pass in the path to the directory we most recently made so that we can use
-                 * full paths in the other calls.
-                 */
-                create_remove_directory_tree(0, 0, o.testdir, 0, progress);
-            }
+            /*
+             * Let's pass in the path to the directory we most recently made so that we can use
+             * full paths in the other calls.
+             */
+            create_remove_directory_tree(0, 0, o.testdir, 0, progress);
         } else {
             if (rank == 0) {
                 VERBOSE(3,-1,"V-3: main (remove hierarchical directory loop-!unique_dir_per_task): Calling create_remove_directory_tree with '%s'", o.testdir );
@@ -2234,10 +3825,10 @@ static void mdtest_iteration(int i, int j, mdtest_results_t * summary_table){
 
       MPI_CHECK(MPI_Barrier(testComm), "MPI_Barrier error");
       endCreate = GetTimeStamp();
-      summary_table->rate[MDTEST_TREE_REMOVE_NUM] = o.num_dirs_in_tree / (endCreate - startCreate);
+      summary_table->rate[MDTEST_TREE_REMOVE_NUM] = tree_dirs / (endCreate - startCreate);
       summary_table->time[MDTEST_TREE_REMOVE_NUM] = endCreate - startCreate;
-      summary_table->items[MDTEST_TREE_REMOVE_NUM] = o.num_dirs_in_tree;
-      summary_table->stonewall_last_item[MDTEST_TREE_REMOVE_NUM] = o.num_dirs_in_tree;
+      summary_table->items[MDTEST_TREE_REMOVE_NUM] = tree_dirs;
+      summary_table->stonewall_last_item[MDTEST_TREE_REMOVE_NUM] = tree_dirs;
       VERBOSE(1,-1,"main   Tree removal      : %14.3f sec, %14.3f ops/sec", (endCreate - startCreate), summary_table->rate[MDTEST_TREE_REMOVE_NUM]);
       VERBOSE(2,-1,"main (at end of for j loop): Removing o.testdir of '%s'\n", o.testdir );
 
@@ -2263,6 +3854,8 @@ void mdtest_init_args(){
      .prologue = "",
      .epilogue = "",
      .gpuID = -1,
+     .threads = 1,
+     .xattr_size = 64,
   };
 }
 
@@ -2312,6 +3905,14 @@ mdtest_results_t * mdtest_run(int argc, char **argv, MPI_Comm world_com, FILE *
       {'E', NULL,        "only read files/dir", OPTION_FLAG, 'd', & o.read_only},
       {'r', NULL,        "only remove files or directories left behind by previous runs", OPTION_FLAG, 'd', & o.remove_only},
       {'U', NULL,        "enable rename directory phase", OPTION_FLAG, 'd', & o.rename_dirs},
+      {0, "readdir",     "enable the listing phase, list the directories of the files after the file stat phase", OPTION_FLAG, 'd', & o.list_dirs},
+      {0, "readdirStat", "stat every entry while listing the directories (ls -l)", OPTION_FLAG, 'd', & o.list_stat},
+      {0, "xattrs",      "number of extended attributes per file, set after the files are created, get and listed after the stat phase", OPTION_OPTIONAL_ARGUMENT, 'd', & o.xattr_count},
+      {0, "xattrSize",   "bytes of the value of an extended attribute", OPTION_OPTIONAL_ARGUMENT, 'd', & o.xattr_size},
+      {0, "renameFiles", "enable the file rename phases after the read phase, within the directory and into another directory", OPTION_FLAG, 'd', & o.rename_files},
+      {0, "links",       "enable the hard link phase after the read phase", OPTION_FLAG, 'd', & o.link_files},
+      {0, "symlinks",    "enable the symlink and readlink phases after the read phase", OPTION_FLAG, 'd', & o.symlink_files},
+      {0, "sizeDistribution", "write and read files of these sizes instead of -w and -e: list:SIZE=WEIGHT,... | lognormal:MEDIAN:SIGMA:MAX | histogram:FILE", OPTION_OPTIONAL_ARGUMENT, 's', & o.size_distribution},
       {'D', NULL,        "perform test on directories only (no files)", OPTION_FLAG, 'd', & o.dirs_only},
       {'e', NULL,        "bytes to read from each file", OPTION_OPTIONAL_ARGUMENT, 'l', & o.read_bytes},
       {'f', NULL,        "first number of tasks on which the test will run", OPTION_OPTIONAL_ARGUMENT, 'd', & first},
@@ -2351,6 +3952,13 @@ mdtest_results_t * mdtest_run(int argc, char **argv, MPI_Comm world_com, FILE *
       {0, "dataPacketType", "type of packet that will be created [offset|incompressible|timestamp|random|o|i|t|r]", OPTION_OPTIONAL_ARGUMENT, 's', & packetType},
       {0, "run-cmd-before-phase", "call this external command before each phase (excluded from the timing)", OPTION_OPTIONAL_ARGUMENT, 's', & o.prologue},
       {0, "run-cmd-after-phase",  "call this external command after each phase (included in the timing)", OPTION_OPTIONAL_ARGUMENT, 's', & o.epilogue},
+      {0, "resourceAccounting", "Report the CPU time, system calls, context switches, faults and storage bytes per operation: 1 of the processes, 2 also the disks and network of the nodes", OPTION_OPTIONAL_ARGUMENT, 'd', & o.resource_accounting},
+      {0, "perfCounters", "Report the cycles, instructions, cache and TLB misses per operation (perf_event_open)", OPTION_FLAG, 'd', & o.perf_counters},
+      {0, "threads", "number of threads of a process that create, stat, read and remove its items", OPTION_OPTIONAL_ARGUMENT, 'd', & o.threads},
+      {0, "uringDepth", "POSIX: keep this many items of a thread in flight with io_uring, 0 uses synchronous calls", OPTION_OPTIONAL_ARGUMENT, 'd', & o.uring_depth},
+      {0, "uringBatch", "POSIX: submit the io_uring calls in batches of this size, 0 submits them when waiting for completions", OPTION_OPTIONAL_ARGUMENT, 'd', & o.uring_batch},
+      {0, "dirHandles", "Create, stat, read and remove the items relative to open directory handles (openat, fstatat, unlinkat, mkdirat) instead of by path", OPTION_FLAG, 'd', & o.dir_handles},
+      {0, "hugePages", "Back the I/O buffers by huge pages: none, thp (transparent), 2m or 1g (reserved)", OPTION_OPTIONAL_ARGUMENT, 's', & o.hugePages},
 #ifdef HAVE_CUDA
       {0, "allocateBufferOnGPU", "Allocate I/O buffers on the GPU: X=1 uses managed memory - verifications are run on CPU; X=2 managed memory - verifications on GPU; X=3 device memory with verifications on GPU.", OPTION_OPTIONAL_ARGUMENT, 'd', & o.gpuMemoryFlags},
       {0, "GPUid", "Select the GPU to use, use -1 for round-robin among local procs.", OPTION_OPTIONAL_ARGUMENT, 'd', & o.gpuID},
@@ -2394,8 +4002,9 @@ mdtest_results_t * mdtest_run(int argc, char **argv, MPI_Comm world_com, FILE *
     o.pid = getpid();
     o.uid = getuid();
 
-    numNodes = GetNumNodes(testComm);
-    numTasksOnNode0 = GetNumTasksOnNode0(testComm);
+    const ior_topology_t *topo = GetTopology(testComm);
+    numNodes = topo->numNodes;
+    numTasksOnNode0 = topo->tasksOnNode0;
 
     char cmd_buffer[4096];
     strncpy(cmd_buffer, argv[0], 4096);
@@ -2463,15 +4072,25 @@ mdtest_results_t * mdtest_run(int argc, char **argv, MPI_Comm world_com, FILE *
     VERBOSE(1,-1, "stat_only               : %s", ( o.stat_only ? "True" : "False" ));
     VERBOSE(1,-1, "unique_dir_per_task     : %s", ( o.unique_dir_per_task ? "True" : "False" ));
     VERBOSE(1,-1, "write_bytes             : "LLU"", o.write_bytes );
+    VERBOSE(1,-1, "size_distribution       : %s", o.size_distribution ? o.size_distribution : "none" );
     VERBOSE(1,-1, "sync_file               : %s", ( o.sync_file ? "True" : "False" ));
     VERBOSE(1,-1, "call_sync               : %s", ( o.call_sync ? "True" : "False" ));
     VERBOSE(1,-1, "depth                   : %d", o.depth );
     VERBOSE(1,-1, "make_node               : %d", o.make_node );
     int tasksBlockMapping = QueryNodeMapping(testComm, true);
+    if (o.nstride > 0 && topo->irregular) {
+        VERBOSE(1,-1, "uneven distribution of tasks to nodes, the stride applies to the ranks ordered by node");
+    }
 
     if(o.gpuMemoryFlags != IOR_MEMORY_TYPE_CPU){
        initCUDA(tasksBlockMapping, rank, numNodes, numTasksOnNode0, o.gpuID);
     }
+    if (aligned_buffer_huge_pages(o.hugePages) != 0) {
+        FAIL("unknown hugePages %s, use none, thp, 2m or 1g", o.hugePages);
+    }
+    if (o.perf_counters) {
+        PerfCountersSetup(testComm);
+    }
 
     /* setup total number of items and number of items per dir */
     if (o.depth <= 0) {
@@ -2508,42 +4127,37 @@ mdtest_results_t * mdtest_run(int argc, char **argv, MPI_Comm world_com, FILE *
             o.items = o.items_per_dir * o.num_dirs_in_tree;
         }
     }
-
-    /* initialize rand_array */
-    if (o.random_seed > 0) {
-        srand(o.random_seed);
-
-        uint64_t s;
-
-        o.rand_array = (uint64_t *) safeMalloc( o.items * sizeof(*o.rand_array));
-
-        for (s=0; s < o.items; s++) {
-            o.rand_array[s] = s;
+    if (o.rename_files) {
+        uint64_t stop_items = o.directory_loops != 1 ? o.items_per_dir : o.items;
+        o.rename_across = stop_items > o.items_per_dir;
+        if (! o.rename_across) {
+            VERBOSE(0,-1,"WARNING: the files of a process are in a single directory, the File rename across phase is skipped");
         }
+    }
 
-        /* shuffle list randomly */
-        uint64_t n = o.items;
-        while (n>1) {
-            n--;
-
-            /*
-             * Generate a random number in the range 0 .. n
-             *
-             * rand() returns a number from 0 .. RAND_MAX. Divide that
-             * by RAND_MAX and you get a floating point number in the
-             * range 0 .. 1. Multiply that by n and you get a number in
-             * the range 0 .. n.
-             */
-            uint64_t k = ( uint64_t ) ((( double )rand() / ( double )RAND_MAX ) * ( double )n );
-
-            /*
-             * Now move the nth element to the kth (randomly chosen)
-             * element, and the kth element to the nth element.
-             */
-
-            uint64_t tmp = o.rand_array[k];
-            o.rand_array[k] = o.rand_array[n];
-            o.rand_array[n] = tmp;
+    /* estimate the memory of the run and fail before allocating it */
+    {
+        const int host = o.gpuMemoryFlags == IOR_MEMORY_TYPE_CPU;
+        ior_memory_item_t items[] = {
+            {"write buffers", host && o.write_bytes > 0 ? o.threads * aligned_buffer_footprint(o.write_bytes) : 0},
+            {"read buffers", host && o.read_bytes > 0 ? o.threads * aligned_buffer_footprint(o.read_bytes) : 0},
+            {"io_uring buffers", (size_t) o.threads * o.uring_depth * ((o.write_bytes > 0 ? aligned_buffer_footprint(o.write_bytes) : 0)
+                                   + (o.read_bytes > 0 ? aligned_buffer_footprint(o.read_bytes) : 0))},
+            {"per-operation timer", o.savePerOpDataCSV != NULL ? 2 * OP_BUFFER_SIZE * sizeof(double) : 0},
+            /* rank 0 gathers the results of all processes */
+            {"results", (2 + (rank == 0 ? o.size : 0)) * iterations * sizeof(mdtest_results_t)},
+        };
+        const int count = sizeof(items) / sizeof(items[0]);
+        ior_memory_budget_t budget;
+
+        MemoryBudget(items, count, 0, testComm, & budget);
+        for (int k = 0; k < count; k++) {
+            VERBOSE(2, -1, "Memory of a process for the %s: %zu bytes", items[k].name, items[k].bytes);
+        }
+        VERBOSE(0, -1, "memory: %.1f MiB per process, %.1f MiB per node, %.1f MiB available", (double) budget.task / MEBIBYTE,
+                (double) budget.node / MEBIBYTE, (double) budget.available / MEBIBYTE);
+        if (budget.exceeded) {
+            FAIL("node %d lacks memory: mdtest allocates %zu bytes, only %zu bytes are available", budget.nodeIndex, budget.node, budget.available);
         }
     }
 
@@ -2552,6 +4166,8 @@ mdtest_results_t * mdtest_run(int argc, char **argv, MPI_Comm world_com, FILE *
         o.write_buffer = aligned_buffer_alloc(o.write_bytes, o.gpuMemoryFlags);
         generate_memory_pattern(o.write_buffer, o.write_bytes, o.random_buffer_offset, rank, o.dataPacketType, o.gpuMemoryFlags);
     }
+    /* the buffers of all threads are allocated before the timed phases */
+    workers_init();
 
     /* setup directory path to work in */
     if (o.path_count == 0) { /* special case where no directory path provided with '-d' option */
@@ -2698,19 +4314,21 @@ mdtest_results_t * mdtest_run(int argc, char **argv, MPI_Comm world_com, FILE *
         FAIL("Unable to remove test directory path %s", o.testdirpath);
     }
 
+    size_t peak_task, peak_node;
+    GatherPeakMemory(testComm, & peak_task, & peak_node);
+    VERBOSE(0,-1,"peak memory: %.1f MiB per process, %.1f MiB per node", (double) peak_task / MEBIBYTE, (double) peak_node / MEBIBYTE);
     VERBOSE(0,-1,"-- finished at %s --\n", PrintTimestamp());
 
-    if (o.random_seed > 0) {
-        free(o.rand_array);
-    }
-
     if (o.backend->finalize){
       o.backend->finalize(o.backend_options);
     }
 
+    workers_free();
     if (o.write_bytes > 0) {
       aligned_buffer_free(o.write_buffer, o.gpuMemoryFlags);
     }
+    aligned_buffer_pool_release();
+    PerfCountersClose();
     free(o.summary_table);
 
     return aggregated_results;
@@ -16,11 +16,23 @@ typedef enum {
   MDTEST_FILE_STAT_NUM = 6,
   MDTEST_FILE_READ_NUM = 7,
   MDTEST_FILE_REMOVE_NUM = 8,
-  MDTEST_TREE_CREATE_NUM = 9,
-  MDTEST_TREE_REMOVE_NUM = 10,
+  MDTEST_FILE_LIST_NUM = 9,
+  MDTEST_FILE_SETXATTR_NUM = 10,
+  MDTEST_FILE_GETXATTR_NUM = 11,
+  MDTEST_FILE_LISTXATTR_NUM = 12,
+  MDTEST_FILE_RENAME_NUM = 13,
+  MDTEST_FILE_RENAME_ACROSS_NUM = 14,
+  MDTEST_FILE_LINK_NUM = 15,
+  MDTEST_FILE_SYMLINK_NUM = 16,
+  MDTEST_FILE_READLINK_NUM = 17,
+  MDTEST_TREE_CREATE_NUM = 18,
+  MDTEST_TREE_REMOVE_NUM = 19,
   MDTEST_LAST_NUM
 } mdtest_test_num_t;
 
+/* the most size classes of a file size distribution */
+#define MDTEST_SIZE_CLASSES 16
+
 typedef struct
 {
     double rate[MDTEST_LAST_NUM]; /* Calculated throughput after the barrier */
@@ -35,6 +47,19 @@ typedef struct
     uint64_t stonewall_last_item[MDTEST_LAST_NUM]; /* The number of items a process has accessed */
     uint64_t stonewall_item_min[MDTEST_LAST_NUM];  /* Min number of items any process has accessed */
     uint64_t stonewall_item_sum[MDTEST_LAST_NUM];  /* Total number of items accessed by all processes until stonewall */
+
+    double   resources[MDTEST_LAST_NUM][IOR_NB_RES]; /* Used by the phase, summed over all processes */
+    double   perf[MDTEST_LAST_NUM][IOR_NB_PERF];     /* Hardware events of the phase, summed over all processes, NAN if unavailable */
+
+    /* Directory listing, the items are the entries returned */
+    uint64_t list_dirs;              /* Directories listed */
+    double   list_first_entry_sum;   /* Summed time from the start of listing a directory until its first entry */
+    double   list_first_entry_max;
+
+    /* File creation [0] and read [1] with a size distribution, per size class */
+    uint64_t size_items[2][MDTEST_SIZE_CLASSES];   /* Files of the class */
+    uint64_t size_bytes[2][MDTEST_SIZE_CLASSES];   /* Bytes written or read */
+    double   size_time[2][MDTEST_SIZE_CLASSES];    /* Summed time of their operations */
 } mdtest_results_t;
 
 mdtest_results_t * mdtest_run(int argc, char **argv, MPI_Comm world_com, FILE * out_logfile);
@@ -35,6 +35,7 @@
 static IOR_param_t initialTestParams;
 
 option_help * createGlobalOptions(IOR_param_t * params);
+void DecodeDirective(char *line, IOR_param_t *params, options_all_t * module_options);
 
 
 static IOR_param_t * parameters;
@@ -67,6 +68,263 @@ static void CheckRunSettings(IOR_test_t *tests)
         }
 }
 
+/*
+ * Parameters that accept a range "START..STOP[:xFACTOR|:+STEP]" and are
+ * expanded into one test per value.
+ */
+static const char * sweepKeys[] = {"transferSize", "blockSize", "segmentCount", "numTasks", "numNodes", NULL};
+
+static const char * SweepKey(char * option)
+{
+        for (int i = 0; sweepKeys[i] != NULL; i++) {
+                if (strcasecmp(option, sweepKeys[i]) == 0)
+                        return sweepKeys[i];
+        }
+        return NULL;
+}
+
+static void RangeRemove(IOR_sweep_t * ranges, int * dims, const char * key)
+{
+        for (int i = 0; i < *dims; i++) {
+                if (strcasecmp(ranges[i].key, key) == 0) {
+                        (*dims)--;
+                        memmove(& ranges[i], & ranges[i + 1],
+                                sizeof(IOR_sweep_t) * (*dims - i));
+                        return;
+                }
+        }
+}
+
+static void RangeAdd(IOR_sweep_t * ranges, int * dims, IOR_sweep_t * range)
+{
+        RangeRemove(ranges, dims, range->key);
+        if (*dims == IOR_MAX_SWEEP_DIMS)
+                ERRF("Too many ranges for \"%s\", at most %d parameters are supported",
+                     range->key, IOR_MAX_SWEEP_DIMS);
+        ranges[(*dims)++] = *range;
+}
+
+/*
+ * Decode a range value such as "4k..16m:x2" or "1..max:+4" for key.
+ */
+static void DecodeRange(IOR_sweep_t * range, const char * key, char * value)
+{
+        char buf[MAX_STR];
+        char *stop, *step;
+
+        memset(range, 0, sizeof(IOR_sweep_t));
+        strncpy(range->key, key, sizeof(range->key) - 1);
+        strncpy(buf, value, MAX_STR - 1);
+        buf[MAX_STR - 1] = '\0';
+
+        stop = strstr(buf, "..");
+        if (stop == NULL)
+                ERRF("Range \"%s\" for %s: expected START..STOP", value, key);
+        *stop = '\0';
+        stop += 2;
+        step = strchr(stop, ':');
+        if (step != NULL) {
+                *step = '\0';
+                step++;
+        }
+
+        range->start = string_to_bytes(buf);
+        if (strcasecmp(stop, "max") == 0) {
+                if (strcasecmp(key, "numTasks") != 0 && strcasecmp(key, "numNodes") != 0)
+                        ERRF("Range \"%s\" for %s: \"max\" is only supported for numTasks and numNodes", value, key);
+                range->stop = -1;
+        } else {
+                range->stop = string_to_bytes(stop);
+                if (range->stop < range->start)
+                        ERRF("Range \"%s\" for %s: end is smaller than start", value, key);
+        }
+        if (range->start < 0)
+                ERRF("Range \"%s\" for %s: start must not be negative", value, key);
+
+        /* default is doubling, the common case for sizes and task counts */
+        range->multiply = 1;
+        range->step = 2;
+        if (step != NULL) {
+                if (step[0] == 'x' || step[0] == 'X' || step[0] == '*') {
+                        range->step = string_to_bytes(step + 1);
+                        if (range->step < 2)
+                                ERRF("Range \"%s\" for %s: factor must be at least 2", value, key);
+                } else if (step[0] == '+') {
+                        range->multiply = 0;
+                        range->step = string_to_bytes(step + 1);
+                        if (range->step < 1)
+                                ERRF("Range \"%s\" for %s: increment must be positive", value, key);
+                } else {
+                        ERRF("Range \"%s\" for %s: step must be \":xFACTOR\" or \":+STEP\"", value, key);
+                }
+        }
+        if (range->multiply && range->start == 0)
+                ERRF("Range \"%s\" for %s: start must be positive", value, key);
+}
+
+static void DecodeSweep(IOR_param_t * params, const char * key, char * value)
+{
+        IOR_sweep_t range;
+
+        DecodeRange(& range, key, value);
+        if (range.start == 0)
+                ERRF("Range \"%s\" for %s: start must be positive", value, key);
+        RangeAdd(params->sweep, & params->sweepDims, & range);
+}
+
+/*
+ * Decode "KEY:RANGE", KEY can be any directive including backend options.
+ */
+static void DecodeTune(IOR_param_t * params, char * value)
+{
+        IOR_sweep_t range;
+        char key[MAX_STR];
+        char *sep = strchr(value, ':');
+
+        if (sep == NULL || sep == value || (size_t) (sep - value) >= sizeof(range.key))
+                ERRF("Invalid tune directive \"%s\", expected KEY:START..STOP[:STEP]", value);
+        memcpy(key, value, sep - value);
+        key[sep - value] = '\0';
+        DecodeRange(& range, key, sep + 1);
+        RangeAdd(params->tune, & params->tuneDims, & range);
+}
+
+/*
+ * Set a tuned parameter of an autotune trial to value.
+ */
+void ApplyTunedValue(IOR_param_t * params, const char * key, IOR_offset_t value)
+{
+        char line[MAX_STR];
+
+        /* backend options such as "posix.odirect" are parsed as long options */
+        snprintf(line, MAX_STR, "%s%s=%lld", strchr(key, '.') && key[0] != '-' ? "--" : "",
+                 key, (long long) value);
+        DecodeDirective(line, params, global_options);
+}
+
+static void SetSweepValue(IOR_param_t * params, const char * key, IOR_offset_t value)
+{
+        if (strcmp(key, "transferSize") == 0) {
+                params->transferSize = value;
+        } else if (strcmp(key, "blockSize") == 0) {
+                params->blockSize = value;
+        } else if (strcmp(key, "segmentCount") == 0) {
+                params->segmentCount = value;
+        } else if (strcmp(key, "numTasks") == 0) {
+                params->numTasks = (int) value;
+        } else if (strcmp(key, "numNodes") == 0) {
+                params->numNodes = (int) value;
+                params->selectNodes = 1;
+        }
+}
+
+/*
+ * Replace every test that has swept parameters with one test per point of
+ * the cross product of all ranges, the first range varies slowest.
+ * Points where the transfer size does not divide the block size are skipped.
+ * The generated tests share the backend options, which allows to keep the
+ * backend initialized between them.
+ */
+static IOR_test_t * ExpandSweeps(IOR_test_t * tests, MPI_Comm com)
+{
+        IOR_test_t *head = NULL;
+        IOR_test_t *tail = NULL;
+        IOR_test_t *ptr, *next;
+        int test_num = 0;
+        int worldSize;
+        int worldNodes = -1;
+
+        MPI_CHECK(MPI_Comm_size(com, & worldSize), "cannot get number of tasks");
+
+        for (ptr = tests; ptr != NULL; ptr = next) {
+                IOR_param_t *params = & ptr->params;
+                IOR_offset_t values[IOR_MAX_SWEEP_DIMS];
+                IOR_offset_t stops[IOR_MAX_SWEEP_DIMS];
+                IOR_offset_t maxTransfer = params->transferSize;
+                IOR_test_t *first = NULL;
+                int points = 0;
+                int d;
+
+                next = ptr->next;
+                ptr->next = NULL;
+                if (params->sweepDims > 0 && params->concurrent)
+                        ERR("Parameter sweeps cannot be used for concurrent tests");
+                if (params->sweepDims > 0 && params->autotune)
+                        ERR("Parameter sweeps cannot be combined with --autotune, use -O tune=KEY:RANGE");
+                if (params->sweepDims == 0) {
+                        ptr->params.id = test_num++;
+                        if (tail == NULL)
+                                head = ptr;
+                        else
+                                tail->next = ptr;
+                        tail = ptr;
+                        continue;
+                }
+
+                for (d = 0; d < params->sweepDims; d++) {
+                        IOR_sweep_t *s = & params->sweep[d];
+                        values[d] = s->start;
+                        stops[d] = s->stop;
+                        if (s->stop == -1 && strcmp(s->key, "numNodes") == 0) {
+                                if (worldNodes == -1)
+                                        worldNodes = GetNumNodes(com);
+                                stops[d] = worldNodes;
+                        } else if (s->stop == -1) {
+                                stops[d] = worldSize;
+                        }
+                        if (strcmp(s->key, "transferSize") == 0) {
+                                for (IOR_offset_t v = s->start; v <= stops[d];
+                                     v = s->multiply ? v * s->step : v + s->step)
+                                        maxTransfer = v;
+                        }
+                }
+
+                /* iterate over the cross product like an odometer */
+                while (1) {
+                        IOR_param_t point = *params;
+                        for (d = 0; d < params->sweepDims; d++) {
+                                point.sweep[d].value = values[d];
+                                SetSweepValue(& point, point.sweep[d].key, values[d]);
+                        }
+                        point.sweepBufferSize = maxTransfer;
+
+                        if (! point.strongScaling && (point.transferSize > point.blockSize
+                            || point.blockSize % point.transferSize != 0)) {
+                                if (rank == 0 && params->verbose >= VERBOSE_1)
+                                        fprintf(out_logfile, "Skipping sweep point with blockSize=%lld transferSize=%lld\n",
+                                                point.blockSize, point.transferSize);
+                        } else {
+                                IOR_test_t *t = CreateTest(& point, test_num++);
+                                AllocResults(t);
+                                if (tail == NULL)
+                                        head = t;
+                                else
+                                        tail->next = t;
+                                tail = t;
+                                if (first == NULL)
+                                        first = t;
+                                points++;
+                        }
+
+                        for (d = params->sweepDims - 1; d >= 0; d--) {
+                                IOR_sweep_t *s = & params->sweep[d];
+                                values[d] = s->multiply ? values[d] * s->step : values[d] + s->step;
+                                if (values[d] <= stops[d])
+                                        break;
+                                values[d] = s->start;
+                        }
+                        if (d < 0)
+                                break;
+                }
+                if (points == 0)
+                        ERR("No valid point in the parameter sweep, transferSize must divide blockSize");
+
+                FreeResults(ptr);
+                free(ptr);
+        }
+        return head;
+}
+
 /*
  * Set flags from commandline string/value pairs.
  */
@@ -87,6 +345,15 @@ void DecodeDirective(char *line, IOR_param_t *params, options_all_t * module_opt
                 else
                     exit(EXIT_FAILURE);
         }
+        const char * sweepKey = SweepKey(option);
+        if (sweepKey != NULL) {
+                if (strstr(value, "..") != NULL) {
+                        DecodeSweep(params, sweepKey, value);
+                        return;
+                }
+                /* a plain value ends a sweep inherited from a previous test */
+                RangeRemove(params->sweep, & params->sweepDims, sweepKey);
+        }
         if (strcasecmp(option, "api") == 0) {
           params->api = strdup(value);
 
@@ -118,6 +385,18 @@ void DecodeDirective(char *line, IOR_param_t *params, options_all_t * module_opt
             fclose(fd);
           }
           params->saveRankDetailsCSV = strdup(value);
+          params->saveRankDetailsBinary = 0;
+        } else if (strcasecmp(option, "saveRankPerformanceDetailsBinary") == 0){
+          if (rank == 0){
+            // check that the file is writeable and truncate it
+            FILE* fd = fopen(value, "w");
+            if (fd == NULL){
+              FAIL("Cannot open saveRankPerformanceDetailsBinary file for write!");
+            }
+            fclose(fd);
+          }
+          params->saveRankDetailsCSV = strdup(value);
+          params->saveRankDetailsBinary = 1;
         } else if (strcasecmp(option, "savePerOpDataCSV") == 0){
           params->savePerOpDataCSV = strdup(value);
         } else if (strcasecmp(option, "summaryFormat") == 0) {
@@ -152,6 +431,8 @@ void DecodeDirective(char *line, IOR_param_t *params, options_all_t * module_opt
                 params->stoneWallingWearOut = atoi(value);
         } else if (strcasecmp(option, "stoneWallingWearOutIterations") == 0) {
                 params->stoneWallingWearOutIterations = atoll(value);
+        } else if (strcasecmp(option, "stoneWallingWorkStealing") == 0) {
+                params->stoneWallingWorkStealing = atoi(value);
         } else if (strcasecmp(option, "stoneWallingStatusFile") == 0) {
                 params->stoneWallingStatusFile  = strdup(value);
         } else if (strcasecmp(option, "maxtimeduration") == 0) {
@@ -162,6 +443,12 @@ void DecodeDirective(char *line, IOR_param_t *params, options_all_t * module_opt
                 params->outlierThreshold = atoi(value);
         } else if (strcasecmp(option, "numnodes") == 0) {
                 params->numNodes = atoi(value);
+        } else if (strcasecmp(option, "concurrent") == 0) {
+                params->concurrent = atoi(value);
+        } else if (strcasecmp(option, "selectNodes") == 0) {
+                params->selectNodes = atoi(value);
+        } else if (strcasecmp(option, "strongScaling") == 0) {
+                params->strongScaling = atoi(value);
         } else if (strcasecmp(option, "numtasks") == 0) {
                 params->numTasks = atoi(value);
         } else if (strcasecmp(option, "numtasksonnode0") == 0) {
@@ -186,6 +473,22 @@ void DecodeDirective(char *line, IOR_param_t *params, options_all_t * module_opt
                 params->reorderTasksRandom = atoi(value);
         } else if (strcasecmp(option, "reordertasksrandomSeed") == 0) {
                 params->reorderTasksRandomSeed = atoi(value);
+        } else if (strcasecmp(option, "reordertaskstopology") == 0) {
+                params->reorderTasksTopology = atoi(value);
+        } else if (strcasecmp(option, "topologyfile") == 0) {
+                params->topologyFile = strdup(value);
+        } else if (strcasecmp(option, "cpubind") == 0) {
+                params->cpuBind = strdup(value);
+        } else if (strcasecmp(option, "numanode") == 0) {
+                params->numaNode = strdup(value);
+        } else if (strcasecmp(option, "hugepages") == 0) {
+                params->hugePages = strdup(value);
+        } else if (strcasecmp(option, "sharedpatternbuffer") == 0) {
+                params->sharedPatternBuffer = atoi(value);
+        } else if (strcasecmp(option, "resourceaccounting") == 0) {
+                params->resourceAccounting = atoi(value);
+        } else if (strcasecmp(option, "perfcounters") == 0) {
+                params->perfCounters = atoi(value);
         } else if (strcasecmp(option, "reordertasks") == 0) {
                 /* Backwards compatibility for the "reorderTasks" option.
                    MUST follow the other longer reordertasks checks. */
@@ -238,6 +541,14 @@ void DecodeDirective(char *line, IOR_param_t *params, options_all_t * module_opt
                 params->memoryPerTask = 0;
         } else if (strcasecmp(option, "summaryalways") == 0) {
                 params->summary_every_test = atoi(value);
+        } else if (strcasecmp(option, "tune") == 0) {
+                DecodeTune(params, value);
+        } else if (strcasecmp(option, "autotuneBudget") == 0) {
+                params->autotuneBudget = atoi(value);
+        } else if (strcasecmp(option, "autotuneTrialTime") == 0) {
+                params->autotuneTrialTime = atoi(value);
+        } else if (strcasecmp(option, "autotuneRepetitions") == 0) {
+                params->autotuneRepetitions = atoi(value);
         } else {
                 // backward compatibility for now
                 if (strcasecmp(option, "useo_direct") == 0) {
@@ -425,6 +736,7 @@ option_help * createGlobalOptions(IOR_param_t * params){
     {.help="  -O stoneWallingWearOut=1           -- once the stonewalling timeout is over, all process finish to access the amount of data", .arg = OPTION_OPTIONAL_ARGUMENT},
     {.help="  -O stoneWallingWearOutIterations=N -- stop after processing this number of iterations, needed for reading data back written with stoneWallingWearOut", .arg = OPTION_OPTIONAL_ARGUMENT},
     {.help="  -O stoneWallingStatusFile=FILE     -- this file keeps the number of iterations from stonewalling during write and allows to use them for read", .arg = OPTION_OPTIONAL_ARGUMENT},
+    {.help="  -O stoneWallingWorkStealing=1      -- during the wear out, fast processes take over the remaining transfers of slow processes (shared file, sequential offsets)", .arg = OPTION_OPTIONAL_ARGUMENT},
     {.help="  -O minTimeDuration=0           -- minimum Runtime for the run (will repeat from beginning of the file if time is not yet over)", .arg = OPTION_OPTIONAL_ARGUMENT},
 #ifdef HAVE_CUDA
     {.help="  -O allocateBufferOnGPU=X           -- allocate I/O buffers on the GPU: X=1 uses managed memory - verifications are run on CPU; X=2 managed memory - verifications on GPU; X=3 device memory with verifications on GPU.", .arg = OPTION_OPTIONAL_ARGUMENT},
@@ -474,9 +786,27 @@ option_help * createGlobalOptions(IOR_param_t * params){
     {0, "warningAsErrors",        "Any warning should lead to an error.", OPTION_FLAG, 'd', & params->warningAsErrors},
     {.help="  -O summaryFile=FILE                 -- store result data into this file", .arg = OPTION_OPTIONAL_ARGUMENT},
     {.help="  -O summaryFormat=[default,JSON,CSV] -- use the format for outputting the summary", .arg = OPTION_OPTIONAL_ARGUMENT},
+    {.help="  -O reorderTasksTopology=1         -- reorder tasks for read back such that each task reads data of the most distant node", .arg = OPTION_OPTIONAL_ARGUMENT},
+    {.help="  -O topologyFile=FILE              -- switch and rack of the hosts for reorderTasksTopology, lines of: host switch [rack]", .arg = OPTION_OPTIONAL_ARGUMENT},
+    {.help="  -O cpuBind=[none,core,share,numa] -- bind each task to a core, to its share of the cores of the node or to the cores of numaNode", .arg = OPTION_OPTIONAL_ARGUMENT},
+    {.help="  -O numaNode=[N,file,DEVICE]       -- place the buffers on NUMA node N, the node of the test file's block device or of a NIC/block device", .arg = OPTION_OPTIONAL_ARGUMENT},
+    {.help="  -O hugePages=[none,thp,2m,1g]     -- back the buffers by transparent or reserved 2 MiB/1 GiB huge pages", .arg = OPTION_OPTIONAL_ARGUMENT},
+    {.help="  -O sharedPatternBuffer=1          -- the tasks of a node write from one pattern buffer in MPI shared memory, with a private header per transfer", .arg = OPTION_OPTIONAL_ARGUMENT},
+    {.help="  -O resourceAccounting=[1,2]       -- report CPU time, system calls, faults and storage bytes per phase, 2 adds disks and network of the nodes", .arg = OPTION_OPTIONAL_ARGUMENT},
+    {.help="  -O perfCounters=1                 -- count cycles, instructions, cache and TLB misses while reading and writing (perf_event_open)", .arg = OPTION_OPTIONAL_ARGUMENT},
     {.help="  -O saveRankPerformanceDetailsCSV=<FILE> -- store the performance of each rank into the named CSV file.", .arg = OPTION_OPTIONAL_ARGUMENT},
+    {.help="  -O saveRankPerformanceDetailsBinary=<FILE> -- store the performance of each rank as binary records (IOR_rank_record_t) into the named file.", .arg = OPTION_OPTIONAL_ARGUMENT},
     {.help="  -O savePerOpDataCSV=<FILE> -- store the performance of each rank into an individual file prefixed with this option.", .arg = OPTION_OPTIONAL_ARGUMENT},
+    {.help="  -O transferSize=4k..16m:x2      -- sweep a parameter, one test per value (also blockSize, segmentCount, numTasks=1..max:+1)", .arg = OPTION_OPTIONAL_ARGUMENT},
+    {.help="  -O numNodes=1..max:x2           -- scaling study, run on all tasks of the first 1, 2, 4, ... nodes", .arg = OPTION_OPTIONAL_ARGUMENT},
+    {.help="  -O strongScaling=1              -- scaling study with a fixed aggregate size: blockSize is the work of one node", .arg = OPTION_OPTIONAL_ARGUMENT},
+    {.help="  -O concurrent=1                 -- in a script: run this test at the same time as the previous one, on the next numTasks ranks", .arg = OPTION_OPTIONAL_ARGUMENT},
     {0, "dryRun",      "do not perform any I/Os just run evtl. inputs print dummy output", OPTION_FLAG, 'd', & params->dryRun},
+    {0, "autotune",    "search the parameters given with -O tune=KEY:RANGE for the best bandwidth", OPTION_FLAG, 'd', & params->autotune},
+    {.help="  -O tune=transferSize:64k..16m:x2 -- bounds of a tuned parameter, KEY can be any directive or backend option", .arg = OPTION_OPTIONAL_ARGUMENT},
+    {.help="  -O autotuneBudget=300           -- time budget of the search in seconds", .arg = OPTION_OPTIONAL_ARGUMENT},
+    {.help="  -O autotuneTrialTime=5          -- stonewalling deadline of a single trial in seconds", .arg = OPTION_OPTIONAL_ARGUMENT},
+    {.help="  -O autotuneRepetitions=5        -- repetitions to measure the best configuration", .arg = OPTION_OPTIONAL_ARGUMENT},
     LAST_OPTION,
   };
   option_help * options = malloc(sizeof(o));
@@ -509,6 +839,7 @@ IOR_test_t *ParseCommandLine(int argc, char **argv, MPI_Comm com)
       AllocResults(tests);
     }
 
+    tests = ExpandSweeps(tests, com);
     CheckRunSettings(tests);
 
     return (tests);
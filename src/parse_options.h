@@ -14,5 +14,6 @@
 #include "ior.h"
 
 IOR_test_t *ParseCommandLine(int argc, char **argv, MPI_Comm com);
+void ApplyTunedValue(IOR_param_t * params, const char * key, IOR_offset_t value);
 
 #endif  /* !_PARSE_OPTIONS_H */
@@ -24,8 +24,26 @@
 
 #ifdef __linux__
 #  define _GNU_SOURCE            /* Needed for O_DIRECT in fcntl */
+#  include <sys/sysmacros.h>     /* major(), minor() */
 #endif                           /* __linux__ */
 
+#ifdef HAVE_SCHED_SETAFFINITY
+#  include <sched.h>
+#endif
+
+#ifdef HAVE_LINUX_MEMPOLICY_H
+#  include <linux/mempolicy.h>
+#  include <unistd.h>
+#  include <sys/syscall.h>
+#endif
+
+#ifdef HAVE_LINUX_PERF_EVENT_H
+#  include <linux/perf_event.h>
+#  include <sys/ioctl.h>
+#  include <unistd.h>
+#  include <sys/syscall.h>
+#endif
+
 #include <stdarg.h>
 #include <stdio.h>
 #include <stdlib.h>
@@ -33,6 +51,8 @@
 #include <fcntl.h>
 #include <math.h>               /* pow() */
 #include <string.h>
+#include <sys/mman.h>
+#include <sys/resource.h>       /* getrusage() */
 #include <sys/stat.h>
 #include <sys/types.h>
 #include <time.h>
@@ -179,6 +199,50 @@ void invalidate_buffer_pattern(char * buffer, size_t bytes, ior_memory_flags typ
   }
 }
 
+/* the splitmix64 finalizer, mixes all bits of x */
+uint64_t Mix64(uint64_t x){
+  x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+  x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+  return x ^ (x >> 31);
+}
+
+/*
+ * A pseudo-random permutation of [0, count) determined by seed: a balanced
+ * Feistel network over the smallest even number of bits covering count is a
+ * bijection, values beyond count are mapped again until they fall into it
+ * (cycle walking, less than 4 rounds on average).
+ */
+void PermutationInit(ior_permutation_t *p, uint64_t count, uint64_t seed){
+  int bits = 0;
+
+  while (bits < 64 && (count - 1) >> bits)
+    bits++;
+  bits += bits & 1;
+  p->count = count;
+  p->halfBits = bits / 2;
+  p->halfMask = (1ULL << p->halfBits) - 1;
+  for (int r = 0; r < IOR_PERMUTATION_ROUNDS; r++)
+    p->keys[r] = Mix64(seed + (r + 1) * 0x9e3779b97f4a7c15ULL);
+}
+
+uint64_t PermutationValue(const ior_permutation_t *p, uint64_t index){
+  uint64_t x = index;
+
+  if (p->count <= 1)
+    return 0;
+  do {
+    uint64_t left = x >> p->halfBits;
+    uint64_t right = x & p->halfMask;
+    for (int r = 0; r < IOR_PERMUTATION_ROUNDS; r++) {
+      uint64_t next = left ^ (Mix64(right ^ p->keys[r]) & p->halfMask);
+      left = right;
+      right = next;
+    }
+    x = (left << p->halfBits) | right;
+  } while (x >= p->count);
+  return x;
+}
+
 int verify_memory_pattern(uint64_t item, char * buffer, size_t bytes, int rand_seed, int pretendRank, ior_dataPacketType_e dataPacketType, ior_memory_flags type){  
   int error = 0;
 #ifdef HAVE_GPU_DIRECT
@@ -244,9 +308,6 @@ struct OpTimer{
     int pos;
 };
 
-/* by default store 1M operations into the buffer before flushing */
-#define OP_BUFFER_SIZE 1000000
-
 OpTimer* OpTimerInit(char * filename, int size){
   if(filename == NULL) {
     return NULL;
@@ -335,7 +396,7 @@ size_t NodeMemoryStringToBytes(char *size_str)
         long long mem;
 
         rc = sscanf(size_str, " %d %% ", &percent);
-        if (rc == 0)
+        if (rc == 0 || strchr(size_str, '%') == NULL)
                 return (size_t) string_to_bytes(size_str);
         if (percent > 100 || percent < 0)
                 ERR("percentage must be between 0 and 100");
@@ -358,6 +419,133 @@ size_t NodeMemoryStringToBytes(char *size_str)
         return mem / 100 * percent;
 }
 
+/*
+ * Memory the node can still provide without swapping: MemAvailable of
+ * /proc/meminfo, else the free physical pages, 0 if unknown.
+ */
+size_t GetAvailableMemory(void)
+{
+        char line[MAX_STR];
+        unsigned long long kib;
+        FILE *fd = fopen("/proc/meminfo", "r");
+
+        if (fd != NULL) {
+                while (fgets(line, sizeof(line), fd) != NULL) {
+                        if (sscanf(line, "MemAvailable: %llu kB", &kib) == 1) {
+                                fclose(fd);
+                                return (size_t) kib * 1024;
+                        }
+                }
+                fclose(fd);
+        }
+#if defined(HAVE_SYSCONF) && defined(_SC_AVPHYS_PAGES)
+        long pages = sysconf(_SC_AVPHYS_PAGES);
+        if (pages > 0)
+                return (size_t) pages * sysconf(_SC_PAGESIZE);
+#endif
+        return 0;
+}
+
+/*
+ * The peak resident set size of the process.
+ */
+size_t GetPeakMemory(void)
+{
+        struct rusage usage;
+
+        if (getrusage(RUSAGE_SELF, &usage) != 0)
+                return 0;
+#ifdef __APPLE__
+        return usage.ru_maxrss;
+#else
+        return (size_t) usage.ru_maxrss * 1024;  /* in KiB */
+#endif
+}
+
+/*
+ * Sum the allocations of the tasks of comm per task and per node and compare
+ * them together with the reserve of each task (e.g., memoryPerTask) with the
+ * memory available on the nodes. The node with the least memory left is
+ * reported. On return items[i].bytes is the largest allocation of any task.
+ */
+void MemoryBudget(ior_memory_item_t *items, int count, size_t reserve, MPI_Comm comm,
+                  ior_memory_budget_t *budget)
+{
+        const ior_topology_t *topo = GetTopology(comm);
+        const int nodes = topo->numNodes;
+        /* allocations, reserve and available memory of each node */
+        unsigned long long *local = safeMalloc(sizeof(unsigned long long) * 3 * nodes);
+        unsigned long long *sum = safeMalloc(sizeof(unsigned long long) * 3 * nodes);
+        unsigned long long *bytes = safeMalloc(sizeof(unsigned long long) * (count + 1));
+        unsigned long long *maxBytes = safeMalloc(sizeof(unsigned long long) * (count + 1));
+        unsigned long long task = 0;
+        long long left = 0;
+        int known = 0;
+
+        for (int i = 0; i < count; i++) {
+                bytes[i] = items[i].bytes;
+                task += items[i].bytes;
+        }
+        bytes[count] = task;
+        memset(local, 0, sizeof(unsigned long long) * 3 * nodes);
+        local[3 * topo->nodeIndex] = task;
+        local[3 * topo->nodeIndex + 1] = reserve;
+        if (topo->localRank == 0)
+                local[3 * topo->nodeIndex + 2] = GetAvailableMemory();
+        MPI_CHECK(MPI_Allreduce(bytes, maxBytes, count + 1, MPI_UNSIGNED_LONG_LONG, MPI_MAX, comm),
+                  "cannot reduce the allocations of the tasks");
+        MPI_CHECK(MPI_Allreduce(local, sum, 3 * nodes, MPI_UNSIGNED_LONG_LONG, MPI_SUM, comm),
+                  "cannot reduce the allocations of the nodes");
+
+        for (int i = 0; i < count; i++)
+                items[i].bytes = maxBytes[i];
+        memset(budget, 0, sizeof(*budget));
+        budget->task = maxBytes[count];
+        for (int n = 0; n < nodes; n++) {
+                const unsigned long long *s = &sum[3 * n];
+                long long l = (long long) s[2] - s[0] - s[1];
+                /* without the available memory of any node, the one allocating most */
+                if (s[2] != 0 ? ! known || l < left : ! known && s[0] >= budget->node) {
+                        known = s[2] != 0;
+                        left = l;
+                        budget->nodeIndex = n;
+                        budget->node = s[0];
+                        budget->reserve = s[1];
+                        budget->available = s[2];
+                }
+        }
+        budget->exceeded = known && left < 0;
+        free(local);
+        free(sum);
+        free(bytes);
+        free(maxBytes);
+}
+
+/*
+ * The largest peak resident set size of a task and of the tasks of a node.
+ */
+void GatherPeakMemory(MPI_Comm comm, size_t *task, size_t *node)
+{
+        const ior_topology_t *topo = GetTopology(comm);
+        unsigned long long *local = safeMalloc(sizeof(unsigned long long) * (topo->numNodes + 1));
+        unsigned long long *sum = safeMalloc(sizeof(unsigned long long) * (topo->numNodes + 1));
+        unsigned long long peak = GetPeakMemory(), maxPeak;
+
+        memset(local, 0, sizeof(unsigned long long) * (topo->numNodes + 1));
+        local[topo->nodeIndex] = peak;
+        MPI_CHECK(MPI_Allreduce(&peak, &maxPeak, 1, MPI_UNSIGNED_LONG_LONG, MPI_MAX, comm),
+                  "cannot reduce the peak memory of the tasks");
+        MPI_CHECK(MPI_Allreduce(local, sum, topo->numNodes, MPI_UNSIGNED_LONG_LONG, MPI_SUM, comm),
+                  "cannot reduce the peak memory of the nodes");
+        *task = maxPeak;
+        *node = 0;
+        for (int n = 0; n < topo->numNodes; n++)
+                if (sum[n] > *node)
+                        *node = sum[n];
+        free(local);
+        free(sum);
+}
+
 ior_dataPacketType_e parsePacketType(char t){
     switch(t) {
     case '\0': return DATA_TIMESTAMP;
@@ -467,42 +655,20 @@ void DumpBuffer(void *buffer,
 
 /* a function that prints an int array where each index corresponds to a rank
    and the value is whether that rank is on the same host as root.
-   Also returns 1 if rank 1 is on same host and 0 otherwise
+   Also returns 1 if the tasks fill the nodes in contiguous blocks of ranks
 */
 int QueryNodeMapping(MPI_Comm comm, int print_nodemap) {
-    char localhost[MAX_PATHLEN], roothost[MAX_PATHLEN];
-    int num_ranks;
-    MPI_Comm_size(comm, &num_ranks);
-    int *node_map = (int*)malloc(sizeof(int) * num_ranks);
-    if ( ! node_map ) {
-        FAIL("malloc");
-    }
-    if (gethostname(localhost, MAX_PATHLEN) != 0) {
-        FAIL("gethostname()");
-    }
-    if (rank==0) {
-        strncpy(roothost,localhost,MAX_PATHLEN);
-    }
-
-    /* have rank 0 broadcast out its hostname */
-    MPI_Bcast(roothost, MAX_PATHLEN, MPI_CHAR, 0, comm);
-    //printf("Rank %d received root host as %s\n", rank, roothost);
-    /* then every rank figures out whether it is same host as root and then gathers that */
-    int same_as_root = strcmp(roothost,localhost) == 0;
-    MPI_Gather( &same_as_root, 1, MPI_INT, node_map, 1, MPI_INT, 0, comm);
+    const ior_topology_t *topo = GetTopology(comm);
+    int rank;
+    MPI_Comm_rank(comm, & rank);
     if ( print_nodemap && rank==0) {
         fprintf( out_logfile, "Nodemap: " );
-        for ( int i = 0; i < num_ranks; i++ ) {
-            fprintf( out_logfile, "%d", node_map[i] );
+        for ( int i = 0; i < topo->numTasks; i++ ) {
+            fprintf( out_logfile, "%d", topo->nodeOfRank[i] == 0 );
         }
         fprintf( out_logfile, "\n" );
     }
-    int ret = 1;
-    if(num_ranks>1)
-        ret = node_map[1] == 1;
-    MPI_Bcast(&ret, 1, MPI_INT, 0, comm);
-    free(node_map);
-    return ret;
+    return topo->blockMapping;
 }
 
 void initCUDA(int blockMapping, int rank, int numNodes, int tasksPerNode, int useGPUID){  
@@ -536,47 +702,196 @@ void initCUDA(int blockMapping, int rank, int numNodes, int tasksPerNode, int us
 }
 
 /*
- * There is a more direct way to determine the node count in modern MPI
- * versions so we use that if possible.
+ * The node layout of the tasks of a communicator is determined once and
+ * cached as an attribute of the communicator, later calls are local.
  *
- * For older versions we use a method which should still provide accurate
- * results even if the total number of tasks is not evenly divisible by the
- * tasks on node rank 0.
+ * Nodes are numbered in the order of their lowest rank, i.e., rank 0 is
+ * always on node 0.  With MPI-3 the tasks sharing a node are found with
+ * MPI_Comm_split_type(), older versions compare a hash of gethostname();
+ * gethostname() rather than MPI_Get_processor_name() as we are interested in
+ * the tasks sharing a file system client, which differs on machines like
+ * BlueGene/Q.  Every task receives the complete rank to node map, hence all
+ * derived values are identical on all tasks, which matters as they are used
+ * to redistribute the files read by the tasks.
+ *
+ * Nothing guarantees the same number of tasks per node, e.g., 64 tasks on
+ * 4 nodes that can run 20 tasks each yield 3 nodes with 20 tasks and one with
+ * 4.  Such layouts, and mappings that are neither by node nor by slot, are
+ * flagged as irregular.
  */
-int GetNumNodes(MPI_Comm comm) {
-    if (getenv("IOR_FAKE_NODES")){
-      int numNodes = atoi(getenv("IOR_FAKE_NODES"));
-      int rank;
-      MPI_Comm_rank(comm, & rank);
-      if(rank == 0){
-        printf("Fake number of node: using %d\n", numNodes);
-      }
-      return numNodes;
-    }
+static int topologyKeyval = MPI_KEYVAL_INVALID;
+
+static int TopologyDelete(MPI_Comm comm, int keyval, void *attr, void *extra)
+{
+        ior_topology_t *topo = attr;
+
+        free(topo->nodeOfRank);
+        free(topo->tasksPerNode);
+        free(topo->nodeOrderPos);
+        free(topo->nodeOrderRank);
+        free(topo);
+        return MPI_SUCCESS;
+}
+
+#if MPI_VERSION < 3
+static uint64_t HostnameHash(void)
+{
+        char localhost[MAX_PATHLEN];
+        uint64_t hash = 14695981039346656037ULL; /* FNV-1a */
+
+        if (gethostname(localhost, MAX_PATHLEN) != 0) {
+                FAIL("gethostname()");
+        }
+        for (char *c = localhost; *c != '\0'; c++) {
+                hash = (hash ^ (unsigned char) *c) * 1099511628211ULL;
+        }
+        return hash;
+}
+#endif
+
+const ior_topology_t *GetTopology(MPI_Comm comm) {
+        ior_topology_t *topo;
+        int found = 0;
+        int rank, size;
+        int nodeIndex = 0;
+
+        if (topologyKeyval == MPI_KEYVAL_INVALID) {
+                MPI_CHECK(MPI_Comm_create_keyval(MPI_COMM_NULL_COPY_FN, TopologyDelete, &topologyKeyval, NULL),
+                          "MPI_Comm_create_keyval() error");
+        }
+        MPI_CHECK(MPI_Comm_get_attr(comm, topologyKeyval, &topo, &found), "MPI_Comm_get_attr() error");
+        if (found) {
+                return topo;
+        }
+
+        MPI_Comm_rank(comm, & rank);
+        MPI_Comm_size(comm, & size);
+        topo = safeMalloc(sizeof(ior_topology_t));
+        topo->numTasks = size;
+        topo->nodeOfRank = safeMalloc(sizeof(int) * size);
+
+        if (getenv("IOR_FAKE_NODES") && atoi(getenv("IOR_FAKE_NODES")) > 0) {
+                int numNodes = atoi(getenv("IOR_FAKE_NODES"));
+                if (rank == 0) {
+                        printf("Fake number of node: using %d\n", numNodes);
+                }
+                /* fake nodes get a contiguous block of ranks each */
+                for (int i = 0; i < size; i++) {
+                        topo->nodeOfRank[i] = i / ((size + numNodes - 1) / numNodes);
+                }
+                topo->numNodes = numNodes;
+        } else {
 #if MPI_VERSION >= 3
-        MPI_Comm shared_comm;
-        int shared_rank = 0;
-        int local_result = 0;
-        int numNodes = 0;
-
-        MPI_CHECK(MPI_Comm_split_type(comm, MPI_COMM_TYPE_SHARED, 0, MPI_INFO_NULL, &shared_comm),
-                  "MPI_Comm_split_type() error");
-        MPI_CHECK(MPI_Comm_rank(shared_comm, &shared_rank), "MPI_Comm_rank() error");
-        local_result = shared_rank == 0? 1 : 0;
-        MPI_CHECK(MPI_Allreduce(&local_result, &numNodes, 1, MPI_INT, MPI_SUM, comm),
-                  "MPI_Allreduce() error");
-        MPI_CHECK(MPI_Comm_free(&shared_comm), "MPI_Comm_free() error");
-
-        return numNodes;
+                MPI_Comm shared_comm;
+                MPI_Comm leader_comm;
+                int shared_rank = 0;
+
+                MPI_CHECK(MPI_Comm_split_type(comm, MPI_COMM_TYPE_SHARED, 0, MPI_INFO_NULL, &shared_comm),
+                          "MPI_Comm_split_type() error");
+                MPI_CHECK(MPI_Comm_rank(shared_comm, &shared_rank), "MPI_Comm_rank() error");
+                MPI_CHECK(MPI_Comm_split(comm, shared_rank == 0 ? 0 : MPI_UNDEFINED, 0, &leader_comm),
+                          "MPI_Comm_split() error");
+                if (leader_comm != MPI_COMM_NULL) {
+                        MPI_CHECK(MPI_Comm_rank(leader_comm, &nodeIndex), "MPI_Comm_rank() error");
+                        MPI_CHECK(MPI_Comm_free(&leader_comm), "MPI_Comm_free() error");
+                }
+                MPI_CHECK(MPI_Bcast(&nodeIndex, 1, MPI_INT, 0, shared_comm), "MPI_Bcast() error");
+                MPI_CHECK(MPI_Comm_free(&shared_comm), "MPI_Comm_free() error");
+                MPI_CHECK(MPI_Allgather(&nodeIndex, 1, MPI_INT, topo->nodeOfRank, 1, MPI_INT, comm),
+                          "MPI_Allgather() error");
 #else
-        int numTasks = 0;
-        int numTasksOnNode0 = 0;
+                unsigned long long hash = HostnameHash();
+                unsigned long long *hashes = safeMalloc(sizeof(unsigned long long) * size);
+                unsigned long long *nodeHashes = safeMalloc(sizeof(unsigned long long) * size);
+                int nodes = 0;
+
+                MPI_CHECK(MPI_Allgather(&hash, 1, MPI_UNSIGNED_LONG_LONG, hashes, 1, MPI_UNSIGNED_LONG_LONG, comm),
+                          "MPI_Allgather() error");
+                for (int i = 0; i < size; i++) {
+                        int n;
+                        for (n = 0; n < nodes && nodeHashes[n] != hashes[i]; n++)
+                                ;
+                        if (n == nodes) {
+                                nodeHashes[nodes++] = hashes[i];
+                        }
+                        topo->nodeOfRank[i] = n;
+                }
+                free(nodeHashes);
+                free(hashes);
+#endif
+                topo->numNodes = 0;
+                for (int i = 0; i < size; i++) {
+                        if (topo->nodeOfRank[i] >= topo->numNodes)
+                                topo->numNodes = topo->nodeOfRank[i] + 1;
+                }
+        }
+
+        topo->tasksPerNode = safeMalloc(sizeof(int) * topo->numNodes);
+        memset(topo->tasksPerNode, 0, sizeof(int) * topo->numNodes);
+        topo->localRank = 0;
+        topo->blockMapping = 1;
+        int roundRobin = 1;
+        for (int i = 0; i < size; i++) {
+                int node = topo->nodeOfRank[i];
+                if (i < rank && node == topo->nodeOfRank[rank])
+                        topo->localRank++;
+                if (i > 0 && node < topo->nodeOfRank[i - 1])
+                        topo->blockMapping = 0;
+                if (node != i % topo->numNodes)
+                        roundRobin = 0;
+                topo->tasksPerNode[node]++;
+        }
+        topo->nodeIndex = topo->nodeOfRank[rank];
+        topo->tasksOnNode = topo->tasksPerNode[topo->nodeIndex];
+        topo->tasksOnNode0 = topo->tasksPerNode[0];
+        topo->irregular = ! topo->blockMapping && ! roundRobin;
+        topo->maxTasksOnNode = topo->tasksOnNode0;
+        for (int n = 1; n < topo->numNodes; n++) {
+                if (topo->tasksPerNode[n] != topo->tasksOnNode0)
+                        topo->irregular = 1;
+                if (topo->tasksPerNode[n] > topo->maxTasksOnNode)
+                        topo->maxTasksOnNode = topo->tasksPerNode[n];
+        }
 
-        numTasks = GetNumTasks(comm);
-        numTasksOnNode0 = GetNumTasksOnNode0(comm);
+        /* order the ranks by node, keeping the rank order within a node */
+        int *next = safeMalloc(sizeof(int) * topo->numNodes);
+        topo->nodeOrderPos = safeMalloc(sizeof(int) * size);
+        topo->nodeOrderRank = safeMalloc(sizeof(int) * size);
+        next[0] = 0;
+        for (int n = 1; n < topo->numNodes; n++)
+                next[n] = next[n - 1] + topo->tasksPerNode[n - 1];
+        for (int i = 0; i < size; i++) {
+                int pos = next[topo->nodeOfRank[i]]++;
+                topo->nodeOrderPos[i] = pos;
+                topo->nodeOrderRank[pos] = i;
+        }
+        free(next);
+        if (getenv("IOR_FAKE_TASK_PER_NODES")) {
+                topo->tasksOnNode0 = atoi(getenv("IOR_FAKE_TASK_PER_NODES"));
+                if (rank == 0) {
+                        printf("Fake tasks per node: using %d\n", topo->tasksOnNode0);
+                }
+        }
 
-        return ((numTasks - 1) / numTasksOnNode0) + 1;
-#endif
+        MPI_CHECK(MPI_Comm_set_attr(comm, topologyKeyval, topo), "MPI_Comm_set_attr() error");
+        return topo;
+}
+
+/*
+ * The rank shift places after rank when the ranks are ordered by node, the
+ * order used to shift tasks on irregular layouts.  A shift of at least the
+ * tasks of the largest node reaches another node, unless a node runs more
+ * than half of the tasks.
+ */
+int NodeOrderShift(const ior_topology_t *topo, int rank, long long shift)
+{
+        int pos = (int) ((topo->nodeOrderPos[rank] + shift) % topo->numTasks);
+
+        return topo->nodeOrderRank[pos];
+}
+
+int GetNumNodes(MPI_Comm comm) {
+        return GetTopology(comm)->numNodes;
 }
 
 
@@ -589,109 +904,46 @@ int GetNumTasks(MPI_Comm comm) {
 }
 
 
+int GetNodeIndex(MPI_Comm comm) {
+        return GetTopology(comm)->nodeIndex;
+}
+
+
 /*
- * It's very important that this method provide the same result to every
- * process as it's used for redistributing which jobs read from which files.
- * It was renamed accordingly.
- *
- * If different nodes get different results from this method then jobs get
- * redistributed unevenly and you no longer have a 1:1 relationship with some
- * nodes reading multiple files while others read none.
- *
- * In the common case the number of tasks on each node (MPI_Comm_size on an
- * MPI_COMM_TYPE_SHARED communicator) will be the same.  However, there is
- * nothing which guarantees this.  It's valid to have, for example, 64 jobs
- * across 4 systems which can run 20 jobs each.  In that scenario you end up
- * with 3 MPI_COMM_TYPE_SHARED groups of 20, and one group of 4.
- *
- * In the (MPI_VERSION < 3) implementation of this method consistency is
- * ensured by asking specifically about the number of tasks on the node with
- * rank 0.  In the original implementation for (MPI_VERSION >= 3) this was
- * broken by using the LOCAL process count which differed depending on which
- * node you were on.
- *
- * This was corrected below by first splitting the comm into groups by node
- * (MPI_COMM_TYPE_SHARED) and then having only the node with world rank 0 and
- * shared rank 0 return the MPI_Comm_size of its shared subgroup. This yields
- * the original consistent behavior no matter which node asks.
- *
- * In the common case where every node has the same number of tasks this
- * method will return the same value it always has.
+ * The number of tasks on the node with rank 0, the same value on all tasks.
  */
 int GetNumTasksOnNode0(MPI_Comm comm) {
-  if (getenv("IOR_FAKE_TASK_PER_NODES")){
-    int tasksPerNode = atoi(getenv("IOR_FAKE_TASK_PER_NODES"));
-    int rank;
-    MPI_Comm_rank(comm, & rank);
-    if(rank == 0){
-      printf("Fake tasks per node: using %d\n", tasksPerNode);
-    }
-    return tasksPerNode;
-  }
-#if MPI_VERSION >= 3
-        MPI_Comm shared_comm;
-        int shared_rank = 0;
-        int tasks_on_node_rank0 = 0;
-        int local_result = 0;
-
-        MPI_CHECK(MPI_Comm_split_type(comm, MPI_COMM_TYPE_SHARED, 0, MPI_INFO_NULL, &shared_comm),
-                  "MPI_Comm_split_type() error");
-        MPI_CHECK(MPI_Comm_rank(shared_comm, &shared_rank), "MPI_Comm_rank() error");
-        if (rank == 0 && shared_rank == 0) {
-                MPI_CHECK(MPI_Comm_size(shared_comm, &local_result), "MPI_Comm_size() error");
-        }
-        MPI_CHECK(MPI_Allreduce(&local_result, &tasks_on_node_rank0, 1, MPI_INT, MPI_SUM, comm),
-                  "MPI_Allreduce() error");
-        MPI_CHECK(MPI_Comm_free(&shared_comm), "MPI_Comm_free() error");
+        return GetTopology(comm)->tasksOnNode0;
+}
+
 
-        return tasks_on_node_rank0;
-#else
 /*
- * This version employs the gethostname() call, rather than using
- * MPI_Get_processor_name().  We are interested in knowing the number
- * of tasks that share a file system client (I/O node, compute node,
- * whatever that may be).  However on machines like BlueGene/Q,
- * MPI_Get_processor_name() uniquely identifies a cpu in a compute node,
- * not the node where the I/O is function shipped to.  gethostname()
- * is assumed to identify the shared filesystem client in more situations.
+ * Append the record of each task to a shared file in the order of the ranks
+ * with a single collective MPI-IO write, records may differ in length.  This
+ * avoids gathering all records on rank 0.
  */
-    int size;
-    MPI_Comm_size(comm, & size);
-    /* for debugging and testing */
-    char       localhost[MAX_PATHLEN],
-        hostname[MAX_PATHLEN];
-    int        count               = 1,
-        i;
-    MPI_Status status;
-
-    if (( rank == 0 ) && ( verbose >= 1 )) {
-        fprintf( out_logfile, "V-1: Entering count_tasks_per_node...\n" );
-        fflush( out_logfile );
-    }
-
-    if (gethostname(localhost, MAX_PATHLEN) != 0) {
-        FAIL("gethostname()");
-    }
-    if (rank == 0) {
-        /* MPI_receive all hostnames, and compares them to the local hostname */
-        for (i = 0; i < size-1; i++) {
-            MPI_Recv(hostname, MAX_PATHLEN, MPI_CHAR, MPI_ANY_SOURCE,
-                     MPI_ANY_TAG, comm, &status);
-            if (strcmp(hostname, localhost) == 0) {
-                count++;
-            }
-        }
-    } else {
-        /* MPI_send hostname to root node */
-        MPI_Send(localhost, MAX_PATHLEN, MPI_CHAR, 0, 0, comm);
-    }
-    MPI_Bcast(&count, 1, MPI_INT, 0, comm);
-
-    return(count);
-#endif
+void AppendRankRecords(char *filename, const void *record, int length, MPI_Comm comm)
+{
+        MPI_File fh;
+        MPI_Offset end;
+        long long len = length;
+        long long offset = 0;
+        int rank;
+
+        MPI_CHECK(MPI_Comm_rank(comm, &rank), "cannot get rank");
+        MPI_CHECK(MPI_Exscan(&len, &offset, 1, MPI_LONG_LONG_INT, MPI_SUM, comm),
+                  "cannot compute the offset of the record");
+        if (rank == 0)
+                offset = 0;     /* the result of MPI_Exscan() is undefined on rank 0 */
+
+        MPI_CHECK(MPI_File_open(comm, filename, MPI_MODE_WRONLY | MPI_MODE_CREATE, MPI_INFO_NULL, &fh),
+                  "cannot open the file for the records");
+        MPI_CHECK(MPI_File_get_size(fh, &end), "cannot get the file size");
+        MPI_CHECK(MPI_File_write_at_all(fh, end + offset, (void *) record, length, MPI_BYTE, MPI_STATUS_IGNORE),
+                  "cannot write the records");
+        MPI_CHECK(MPI_File_close(&fh), "cannot close the file for the records");
 }
 
-
 /*
  * Extract key/value pair from hint string.
  */
@@ -984,6 +1236,250 @@ static double TimeDeviation(MPI_Comm com)
         return max - min;
 }
 
+const char *ResourceNames[IOR_NB_RES] = {
+  "cpuUser", "cpuSys", "volCtxSwitches", "involCtxSwitches", "minorFaults", "majorFaults",
+  "readSyscalls", "writeSyscalls", "storageReadBytes", "storageWriteBytes",
+  "diskReadBytes", "diskWriteBytes", "netRxBytes", "netTxBytes"
+};
+
+/*
+ * Counters of the block devices and network interfaces of the node. Only
+ * physical disks are counted, partitions and virtual devices (loop, dm, md)
+ * would count the same I/O twice; the loopback interface is ignored.
+ */
+static void ResourcesSampleNode(double *res)
+{
+  char line[MAX_STR];
+  FILE *fd = fopen("/proc/diskstats", "r");
+  if (fd != NULL) {
+    while (fgets(line, sizeof(line), fd) != NULL) {
+      char name[MAX_STR], device[MAX_PATHLEN];
+      unsigned long long rd, rdMerged, rdSectors, rdTime, wr, wrMerged, wrSectors;
+      if (sscanf(line, "%*u %*u %1023s %llu %llu %llu %llu %llu %llu %llu", name, &rd, &rdMerged,
+                 &rdSectors, &rdTime, &wr, &wrMerged, &wrSectors) != 8)
+        continue;
+      snprintf(device, sizeof(device), "/sys/block/%s/device", name);
+      if (access(device, F_OK) != 0)
+        continue;
+      /* sectors of /proc/diskstats are always 512 bytes */
+      res[IOR_RES_DISK_READ] += 512.0 * rdSectors;
+      res[IOR_RES_DISK_WRITE] += 512.0 * wrSectors;
+    }
+    fclose(fd);
+  }
+  fd = fopen("/proc/net/dev", "r");
+  if (fd != NULL) {
+    while (fgets(line, sizeof(line), fd) != NULL) {
+      char *colon = strchr(line, ':');
+      unsigned long long rx, tx;
+      if (colon == NULL)
+        continue;
+      *colon = '\0';
+      char *name = line + strspn(line, " ");
+      if (strcmp(name, "lo") == 0)
+        continue;
+      if (sscanf(colon + 1, "%llu %*u %*u %*u %*u %*u %*u %*u %llu", &rx, &tx) != 2)
+        continue;
+      res[IOR_RES_NET_RX] += rx;
+      res[IOR_RES_NET_TX] += tx;
+    }
+    fclose(fd);
+  }
+}
+
+/*
+ * Sample the resources used so far: level 1 takes the counters of the task
+ * from getrusage() and /proc/self/io, level 2 adds the block devices and
+ * network interfaces of the node, sampled by its first task only so that the
+ * sum over the tasks counts each node once. Missing counters remain 0.
+ */
+void ResourcesSample(double *res, int level, MPI_Comm comm)
+{
+  struct rusage usage;
+
+  memset(res, 0, sizeof(double) * IOR_NB_RES);
+  if (level <= 0)
+    return;
+  if (getrusage(RUSAGE_SELF, &usage) == 0) {
+    res[IOR_RES_CPU_USER] = usage.ru_utime.tv_sec + usage.ru_utime.tv_usec * 1e-6;
+    res[IOR_RES_CPU_SYS] = usage.ru_stime.tv_sec + usage.ru_stime.tv_usec * 1e-6;
+    res[IOR_RES_VOL_CTXSW] = usage.ru_nvcsw;
+    res[IOR_RES_INVOL_CTXSW] = usage.ru_nivcsw;
+    res[IOR_RES_MINFLT] = usage.ru_minflt;
+    res[IOR_RES_MAJFLT] = usage.ru_majflt;
+  }
+  FILE *fd = fopen("/proc/self/io", "r");
+  if (fd != NULL) {
+    char key[64];
+    unsigned long long value;
+    while (fscanf(fd, "%63s %llu", key, &value) == 2) {
+      if (strcmp(key, "syscr:") == 0)
+        res[IOR_RES_SYSCR] = value;
+      else if (strcmp(key, "syscw:") == 0)
+        res[IOR_RES_SYSCW] = value;
+      else if (strcmp(key, "read_bytes:") == 0)
+        res[IOR_RES_READ_BYTES] = value;
+      else if (strcmp(key, "write_bytes:") == 0)
+        res[IOR_RES_WRITE_BYTES] = value;
+    }
+    fclose(fd);
+  }
+  if (level >= 2 && GetTopology(comm)->localRank == 0)
+    ResourcesSampleNode(res);
+}
+
+/*
+ * Turn the sample res into the difference to the sample start.
+ */
+void ResourcesDelta(double *res, const double *start)
+{
+  for (int i = 0; i < IOR_NB_RES; i++)
+    res[i] -= start[i];
+}
+
+const char *PerfCounterNames[IOR_NB_PERF] = {
+  "cycles", "instructions", "cacheReferences", "cacheMisses", "dtlbLoadMisses"
+};
+
+#ifdef HAVE_LINUX_PERF_EVENT_H
+/*
+ * The counters form two groups scheduled together on the PMU, cycles and
+ * instructions for the IPC and the cache and TLB events for the miss ratios.
+ */
+static const struct {
+  int group;
+  uint32_t type;
+  uint64_t config;
+} perf_events[IOR_NB_PERF] = {
+  {0, PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES},
+  {0, PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS},
+  {1, PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_REFERENCES},
+  {1, PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES},
+  {1, PERF_TYPE_HW_CACHE, PERF_COUNT_HW_CACHE_DTLB | (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+                          (PERF_COUNT_HW_CACHE_RESULT_MISS << 16)},
+};
+#endif
+
+static int perf_fd[IOR_NB_PERF] = {-1, -1, -1, -1, -1};
+static int perf_leader[IOR_NB_PERF];
+
+/*
+ * Open the hardware counters of the calling thread, disabled. The kernel is
+ * counted as well unless perf_event_paranoid forbids it, then *userOnly is
+ * set. Returns the number of counters available, 0 if the kernel, container
+ * or virtual machine does not offer them.
+ */
+int PerfCountersOpen(int *userOnly)
+{
+  int count = 0;
+
+  *userOnly = 0;
+  PerfCountersClose();
+#ifdef HAVE_LINUX_PERF_EVENT_H
+  int leader[2] = {-1, -1};
+  for (int i = 0; i < IOR_NB_PERF; i++) {
+    struct perf_event_attr attr;
+    int g = perf_events[i].group;
+
+    memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = perf_events[i].type;
+    attr.config = perf_events[i].config;
+    attr.disabled = leader[g] == -1;
+    attr.exclude_hv = 1;
+    attr.exclude_kernel = *userOnly;
+    attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+    perf_fd[i] = syscall(SYS_perf_event_open, &attr, 0, -1, leader[g], 0);
+    if (perf_fd[i] < 0 && (errno == EACCES || errno == EPERM) && ! *userOnly && count == 0) {
+      *userOnly = 1;
+      attr.exclude_kernel = 1;
+      perf_fd[i] = syscall(SYS_perf_event_open, &attr, 0, -1, leader[g], 0);
+    }
+    if (perf_fd[i] < 0)
+      continue;
+    if (leader[g] == -1)
+      leader[g] = perf_fd[i];
+    perf_leader[i] = leader[g];
+    count++;
+  }
+#endif
+  return count;
+}
+
+/*
+ * Open the counters of all processes of comm and warn once if a counter is
+ * missing on any process, which reports it as not available.
+ */
+void PerfCountersSetup(MPI_Comm comm)
+{
+  int userOnly, minCount, anyUserOnly, me;
+  int count = PerfCountersOpen(&userOnly);
+
+  MPI_CHECK(MPI_Allreduce(&count, &minCount, 1, MPI_INT, MPI_MIN, comm),
+            "cannot reduce the number of counters");
+  MPI_CHECK(MPI_Allreduce(&userOnly, &anyUserOnly, 1, MPI_INT, MPI_MAX, comm),
+            "cannot reduce the counter mode");
+  MPI_CHECK(MPI_Comm_rank(comm, &me), "cannot get rank");
+  if (me != 0)
+    return;
+  if (minCount == 0)
+    WARN("hardware counters are not available (kernel.perf_event_paranoid, container or virtual machine), they are reported as NA");
+  else if (minCount < IOR_NB_PERF)
+    WARN("some hardware counters are not available, they are reported as NA");
+  if (minCount > 0 && anyUserOnly)
+    WARN("kernel.perf_event_paranoid restricts the hardware counters to user space");
+}
+
+/*
+ * Reset and start the counters of the calling thread.
+ */
+void PerfCountersStart(void)
+{
+#ifdef HAVE_LINUX_PERF_EVENT_H
+  for (int i = 0; i < IOR_NB_PERF; i++) {
+    if (perf_fd[i] >= 0 && perf_leader[i] == perf_fd[i]) {
+      ioctl(perf_fd[i], PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+      ioctl(perf_fd[i], PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+    }
+  }
+#endif
+}
+
+/*
+ * Stop the counters and store the events counted since the start into res,
+ * scaled up if the PMU was shared with other groups. Counters which are not
+ * available or were never scheduled are NAN, a sum over tasks stays NAN.
+ */
+void PerfCountersStop(double *res)
+{
+  for (int i = 0; i < IOR_NB_PERF; i++)
+    res[i] = NAN;
+#ifdef HAVE_LINUX_PERF_EVENT_H
+  for (int i = 0; i < IOR_NB_PERF; i++) {
+    if (perf_fd[i] >= 0 && perf_leader[i] == perf_fd[i])
+      ioctl(perf_fd[i], PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP);
+  }
+  for (int i = 0; i < IOR_NB_PERF; i++) {
+    uint64_t value[3]; /* count, time enabled, time running */
+    if (perf_fd[i] < 0 || read(perf_fd[i], value, sizeof(value)) != sizeof(value))
+      continue;
+    if (value[2] == 0)
+      res[i] = value[0] == 0 && value[1] == 0 ? 0 : NAN;
+    else
+      res[i] = (double) value[0] * value[1] / value[2];
+  }
+#endif
+}
+
+void PerfCountersClose(void)
+{
+  for (int i = 0; i < IOR_NB_PERF; i++) {
+    if (perf_fd[i] >= 0)
+      close(perf_fd[i]);
+    perf_fd[i] = -1;
+  }
+}
+
 void init_clock(MPI_Comm com){
 
 }
@@ -1133,15 +1629,337 @@ unsigned long GetProcessorAndCore(int *chip, int *core){
 #endif
 
 
+#ifdef HAVE_SCHED_SETAFFINITY
+/* affinity of the process before the first BindToCpus() */
+static cpu_set_t originalCpus;
+static int originalCpusSaved = 0;
+
+/*
+ * Parse a CPU list of sysfs such as "0-3,8-11".
+ */
+static int ParseCpuList(const char *list, cpu_set_t *set)
+{
+        CPU_ZERO(set);
+        while (*list != '\0' && *list != '\n') {
+                char *end;
+                long first = strtol(list, &end, 10);
+                long last = first;
+                if (end == list)
+                        return -1;
+                if (*end == '-')
+                        last = strtol(end + 1, &end, 10);
+                for (long cpu = first; cpu <= last && cpu < CPU_SETSIZE; cpu++)
+                        CPU_SET(cpu, set);
+                list = *end == ',' ? end + 1 : end;
+        }
+        return 0;
+}
+#endif
+
+/*
+ * Bind this process, and the threads it starts later, to CPUs: "core" pins
+ * each task of a node to its own CPU, "share" divides the CPUs evenly among
+ * the tasks of a node, "numa" uses the CPUs of numaNode and "none" restores
+ * the original affinity. The CPUs are taken from the affinity the process
+ * was started with, so the MPI launcher should not bind the tasks itself.
+ * Returns 0 on success.
+ */
+int BindToCpus(const char *mode, int numaNode, MPI_Comm comm)
+{
+        if (mode == NULL || strcasecmp(mode, "none") == 0) {
+#ifdef HAVE_SCHED_SETAFFINITY
+                if (originalCpusSaved)
+                        return sched_setaffinity(0, sizeof(cpu_set_t), &originalCpus);
+#endif
+                return 0;
+        }
+#ifdef HAVE_SCHED_SETAFFINITY
+        cpu_set_t set;
+        int count = 0;
+
+        if (! originalCpusSaved) {
+                if (sched_getaffinity(0, sizeof(cpu_set_t), &originalCpus) != 0)
+                        return -1;
+                originalCpusSaved = 1;
+        }
+        int *cpus = safeMalloc(sizeof(int) * CPU_SETSIZE);
+        for (int cpu = 0; cpu < CPU_SETSIZE; cpu++)
+                if (CPU_ISSET(cpu, &originalCpus))
+                        cpus[count++] = cpu;
+
+        CPU_ZERO(&set);
+        if (strcasecmp(mode, "core") == 0) {
+                const ior_topology_t *topo = GetTopology(comm);
+                CPU_SET(cpus[topo->localRank % count], &set);
+        } else if (strcasecmp(mode, "share") == 0) {
+                const ior_topology_t *topo = GetTopology(comm);
+                int first = (int) ((long long) topo->localRank * count / topo->tasksOnNode);
+                int last = (int) ((long long) (topo->localRank + 1) * count / topo->tasksOnNode);
+                if (last == first) /* more tasks than CPUs */
+                        CPU_SET(cpus[first % count], &set);
+                for (int i = first; i < last; i++)
+                        CPU_SET(cpus[i], &set);
+        } else if (strcasecmp(mode, "numa") == 0 && numaNode >= 0) {
+                char file[MAX_PATHLEN];
+                char list[MAX_STR] = "";
+                snprintf(file, sizeof(file), "/sys/devices/system/node/node%d/cpulist", numaNode);
+                FILE *fd = fopen(file, "r");
+                if (fd != NULL) {
+                        if (fgets(list, sizeof(list), fd) == NULL)
+                                list[0] = '\0';
+                        fclose(fd);
+                }
+                if (ParseCpuList(list, &set) != 0)
+                        CPU_ZERO(&set);
+        }
+        free(cpus);
+        if (CPU_COUNT(&set) == 0)
+                return -1;
+        return sched_setaffinity(0, sizeof(cpu_set_t), &set);
+#else
+        return -1;
+#endif
+}
+
+/*
+ * Read the NUMA node of a sysfs device, walking up the device hierarchy to
+ * the bus device, e.g., from a partition to its NVMe controller.
+ */
+static int SysfsNumaNode(const char *sysfsPath)
+{
+        char path[MAX_PATHLEN];
+        char file[MAX_PATHLEN + 16];
+        int node = -1;
+
+        if (realpath(sysfsPath, path) == NULL)
+                return -1;
+        while (strlen(path) > strlen("/sys/devices")) {
+                snprintf(file, sizeof(file), "%s/numa_node", path);
+                FILE *fd = fopen(file, "r");
+                if (fd != NULL) {
+                        if (fscanf(fd, "%d", &node) != 1)
+                                node = -1;
+                        fclose(fd);
+                        return node;
+                }
+                *strrchr(path, '/') = '\0';
+        }
+        return -1;
+}
+
+/*
+ * Return the NUMA node given by device: a node number, "file" for the block
+ * device holding path, or the name of a network, InfiniBand or block device.
+ * Returns -1 if the node is unknown, e.g., for network file systems.
+ */
+int GetDeviceNumaNode(const char *device, const char *path)
+{
+        static const char *classes[] = {"net", "infiniband", "block", "nvme"};
+        char sysfsPath[MAX_PATHLEN];
+        char *end;
+
+        if (device == NULL || *device == '\0')
+                return -1;
+        long node = strtol(device, &end, 10);
+        if (*end == '\0')
+                return (int) node;
+#ifdef __linux__
+        if (strcasecmp(device, "file") == 0) {
+                struct stat sb;
+                if (stat(path, &sb) != 0) {
+                        /* the file may not exist yet, use its directory */
+                        char dir[MAX_PATHLEN];
+                        snprintf(dir, sizeof(dir), "%s", path);
+                        char *slash = strrchr(dir, '/');
+                        if (slash == NULL)
+                                strcpy(dir, ".");
+                        else
+                                slash[slash == dir ? 1 : 0] = '\0';
+                        if (stat(dir, &sb) != 0)
+                                return -1;
+                }
+                snprintf(sysfsPath, sizeof(sysfsPath), "/sys/dev/block/%u:%u",
+                         major(sb.st_dev), minor(sb.st_dev));
+                return SysfsNumaNode(sysfsPath);
+        }
+        for (size_t i = 0; i < sizeof(classes) / sizeof(classes[0]); i++) {
+                snprintf(sysfsPath, sizeof(sysfsPath), "/sys/class/%s/%s", classes[i], device);
+                if (access(sysfsPath, F_OK) == 0)
+                        return SysfsNumaNode(sysfsPath);
+        }
+#endif
+        return -1;
+}
+
+/* NUMA node of the buffers allocated by aligned_buffer_alloc(), -1 for any */
+static int bufferNumaNode = -1;
+
+void SetBufferNumaNode(int node)
+{
+        bufferNumaNode = node;
+}
+
+/*
+ * Fill in where the task runs and on which NUMA node buf resides, the first
+ * page of a host buffer buf is touched for this. Unknown values are -1.
+ */
+void GetPlacement(void *buf, ior_placement_t *placement)
+{
+        placement->node = -1;
+        placement->cpu = -1;
+        placement->cpuNumaNode = -1;
+        placement->cpusAllowed = -1;
+        placement->bufferNumaNode = -1;
+#ifdef HAVE_GETCPU_SYSCALL
+        unsigned cpu, node;
+        if (syscall(SYS_getcpu, &cpu, &node, NULL) == 0) {
+                placement->cpu = cpu;
+                placement->cpuNumaNode = node;
+        }
+#endif
+#ifdef HAVE_SCHED_SETAFFINITY
+        cpu_set_t set;
+        if (sched_getaffinity(0, sizeof(cpu_set_t), &set) == 0)
+                placement->cpusAllowed = CPU_COUNT(&set);
+#endif
+#ifdef HAVE_LINUX_MEMPOLICY_H
+        if (buf != NULL) {
+                int bufNode;
+                *(volatile char *) buf = *(volatile char *) buf;
+                if (syscall(SYS_get_mempolicy, &bufNode, NULL, 0, buf, MPOL_F_NODE | MPOL_F_ADDR) == 0)
+                        placement->bufferNumaNode = bufNode;
+        }
+#endif
+}
+
+enum {
+  HUGE_PAGES_NONE,
+  HUGE_PAGES_THP,       /* transparent huge pages */
+  HUGE_PAGES_2M,        /* explicit huge pages of hugetlbfs */
+  HUGE_PAGES_1G
+};
+
+/* pages backing the buffers of aligned_buffer_alloc() */
+static int hugePages = HUGE_PAGES_NONE;
+
+/*
+ * Host buffers are kept in a pool by aligned_buffer_free() and handed out
+ * again for requests they fit, so that phases and repetitions reuse memory
+ * that is mapped and faulted in already.
+ */
+typedef struct {
+  void *buf;            /* start of the mapping */
+  size_t length;        /* length of the mapping */
+  int hugePages;
+  int numaNode;
+  int inUse;
+} pool_buffer_t;
+
+static pool_buffer_t *pool = NULL;
+static int poolCount = 0;
+
+/*
+ * Back the buffers by base pages ("none"), transparent huge pages ("thp") or
+ * explicit huge pages of 2 MiB ("2m") or 1 GiB ("1g") that must be reserved
+ * by the administrator. Returns -1 for an unknown mode.
+ */
+int aligned_buffer_huge_pages(const char *mode)
+{
+  if (mode == NULL || strcasecmp(mode, "none") == 0)
+    hugePages = HUGE_PAGES_NONE;
+  else if (strcasecmp(mode, "thp") == 0)
+    hugePages = HUGE_PAGES_THP;
+  else if (strcasecmp(mode, "2m") == 0)
+    hugePages = HUGE_PAGES_2M;
+  else if (strcasecmp(mode, "1g") == 0)
+    hugePages = HUGE_PAGES_1G;
+  else
+    return -1;
+  return 0;
+}
+
+/*
+ * Bytes a buffer of size bytes occupies with the current page size.
+ */
+size_t aligned_buffer_footprint(size_t size)
+{
+#ifdef HAVE_SYSCONF
+  size_t page = sysconf(_SC_PAGESIZE);
+#else
+  size_t page = getpagesize();
+#endif
+
+  if (hugePages == HUGE_PAGES_1G)
+    page = GIBIBYTE;
+  else if (hugePages != HUGE_PAGES_NONE)
+    page = 2 * MEBIBYTE;
+  return (size + page - 1) / page * page;
+}
+
+/*
+ * Map an anonymous region of at least size bytes with the current page size,
+ * explicit huge pages fall back to transparent ones if none are available.
+ */
+static void *PoolMap(size_t size, size_t *length)
+{
+#ifdef HAVE_SYSCONF
+  size_t pageSize = sysconf(_SC_PAGESIZE);
+#else
+  size_t pageSize = getpagesize();
+#endif
+  size_t hugeSize = 2 * MEBIBYTE;
+  char *buf;
+
+  if (size == 0)
+    size = 1;
+#if defined(MAP_HUGETLB) && defined(MAP_HUGE_SHIFT)
+  if (hugePages == HUGE_PAGES_2M || hugePages == HUGE_PAGES_1G) {
+    static int warned = 0;
+    int shift = hugePages == HUGE_PAGES_2M ? 21 : 30;
+    size_t huge = (size_t) 1 << shift;
+    *length = (size + huge - 1) & ~(huge - 1);
+    buf = mmap(NULL, *length, PROT_READ | PROT_WRITE,
+               MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB | (shift << MAP_HUGE_SHIFT), -1, 0);
+    if (buf != MAP_FAILED)
+      return buf;
+    if (! warned) {
+      warned = 1;
+      WARNF("cannot map %zu bytes of %s huge pages (%s), using transparent huge pages",
+            *length, hugePages == HUGE_PAGES_2M ? "2 MiB" : "1 GiB", strerror(errno));
+    }
+  }
+#endif
+  if (hugePages == HUGE_PAGES_NONE) {
+    *length = (size + pageSize - 1) & ~(pageSize - 1);
+    buf = mmap(NULL, *length, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (buf == MAP_FAILED)
+      ERRF("cannot map %zu bytes: %s", *length, strerror(errno));
+    return buf;
+  }
+
+  /* align to the huge page size, so that the whole buffer can use them */
+  *length = (size + hugeSize - 1) & ~(hugeSize - 1);
+  buf = mmap(NULL, *length + hugeSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  if (buf == MAP_FAILED)
+    ERRF("cannot map %zu bytes: %s", *length + hugeSize, strerror(errno));
+  size_t head = (hugeSize - ((size_t) buf & (hugeSize - 1))) & (hugeSize - 1);
+  if (head > 0)
+    munmap(buf, head);
+  munmap(buf + head + *length, hugeSize - head);
+  buf += head;
+#ifdef MADV_HUGEPAGE
+  madvise(buf, *length, MADV_HUGEPAGE);
+#endif
+  return buf;
+}
 
 /*
  * Allocate a page-aligned (required by O_DIRECT) buffer.
  */
 void *aligned_buffer_alloc(size_t size, ior_memory_flags type)
 {
-  size_t pageMask;
-  char *buf, *tmp;
-  char *aligned;
+  char *buf;
+  int best = -1;
 
   if(type == IOR_MEMORY_TYPE_GPU_MANAGED_CHECK_CPU || type == IOR_MEMORY_TYPE_GPU_MANAGED_CHECK_GPU){
 #ifdef HAVE_CUDA
@@ -1164,27 +1982,57 @@ void *aligned_buffer_alloc(size_t size, ior_memory_flags type)
 #endif
     }
 
-#ifdef HAVE_SYSCONF
-  long pageSize = sysconf(_SC_PAGESIZE);
-#else
-  size_t pageSize = getpagesize();
-#endif
-
-  pageMask = pageSize - 1;
-  buf = safeMalloc(size + pageSize + sizeof(void *));
-  /* find the alinged buffer */
-  tmp = buf + sizeof(char *);
-  aligned = tmp + pageSize - ((size_t) tmp & pageMask);
-  /* write a pointer to the original malloc()ed buffer into the bytes
-     preceding "aligned", so that the aligned buffer can later be free()ed */
-  tmp = aligned - sizeof(void *);
-  *(void **)tmp = buf;
+  int node = bufferNumaNode;
+  for (int i = 0; i < poolCount; i++) {
+    if (pool[i].inUse || pool[i].hugePages != hugePages || pool[i].numaNode != node
+        || pool[i].length < size)
+      continue;
+    if (best < 0 || pool[i].length < pool[best].length)
+      best = i;
+  }
+  if (best >= 0) {
+    pool[best].inUse = 1;
+    return pool[best].buf;
+  }
 
-  return (void *)aligned;
+  /* the buffers kept do not fit, the sizes of the workload changed */
+  aligned_buffer_pool_release();
+  size_t length;
+  buf = PoolMap(size, &length);
+
+#ifdef HAVE_LINUX_MEMPOLICY_H
+  if (node >= 0) {
+    static int warned = 0;
+    unsigned long mask[16] = {0};
+    int ret = -1;
+    if (node < (int) (sizeof(mask) * 8)) {
+      mask[node / (8 * sizeof(long))] = 1UL << (node % (8 * sizeof(long)));
+      ret = syscall(SYS_mbind, buf, length, MPOL_BIND, mask, sizeof(mask) * 8, MPOL_MF_MOVE);
+    }
+    if (ret != 0 && ! warned) {
+      warned = 1;
+      WARNF("cannot place the buffer on NUMA node %d: %s", node, strerror(errno));
+    }
+  }
+#endif
+  /* fault the pages in now instead of in the first timed phase */
+  memset(buf, 0, length);
+
+  pool = realloc(pool, sizeof(pool_buffer_t) * (poolCount + 1));
+  if (pool == NULL)
+    ERR("out of memory");
+  pool[poolCount].buf = buf;
+  pool[poolCount].length = length;
+  pool[poolCount].hugePages = hugePages;
+  pool[poolCount].numaNode = node;
+  pool[poolCount].inUse = 1;
+  poolCount++;
+  return buf;
 }
 
 /*
- * Free a buffer allocated by aligned_buffer_alloc().
+ * Return a buffer allocated by aligned_buffer_alloc(), host buffers are kept
+ * in the pool for reuse.
  */
 void aligned_buffer_free(void *buf, ior_memory_flags gpu)
 {
@@ -1198,5 +2046,31 @@ void aligned_buffer_free(void *buf, ior_memory_flags gpu)
     ERR("No CUDA supported, cannot free on the GPU");
 #endif
   }
-  free(*(void **)((char *)buf - sizeof(char *)));
+  for (int i = 0; i < poolCount; i++) {
+    if (pool[i].buf == buf) {
+      pool[i].inUse = 0;
+      return;
+    }
+  }
+  WARN("Cannot free a buffer not allocated by aligned_buffer_alloc()");
+}
+
+/*
+ * Unmap the pooled buffers not in use.
+ */
+void aligned_buffer_pool_release(void)
+{
+  int kept = 0;
+
+  for (int i = 0; i < poolCount; i++) {
+    if (pool[i].inUse)
+      pool[kept++] = pool[i];
+    else
+      munmap(pool[i].buf, pool[i].length);
+  }
+  poolCount = kept;
+  if (poolCount == 0) {
+    free(pool);
+    pool = NULL;
+  }
 }
@@ -56,14 +56,71 @@ void DumpBuffer(void *, size_t);
 void SetHints (MPI_Info *, char *);
 void ShowHints (MPI_Info *);
 char *HumanReadable(IOR_offset_t value, int base);
+/* node layout of the tasks of a communicator, see GetTopology() */
+typedef struct {
+        int numTasks;
+        int numNodes;
+        int nodeIndex;          /* node of this task */
+        int localRank;          /* rank of this task among the tasks of its node */
+        int tasksOnNode;        /* tasks on the node of this task */
+        int tasksOnNode0;       /* tasks on the node of rank 0 */
+        int maxTasksOnNode;     /* tasks on the node with the most tasks */
+        int *nodeOfRank;        /* node of each rank */
+        int *tasksPerNode;      /* number of tasks of each node */
+        int *nodeOrderPos;      /* position of each rank when the ranks are ordered by node */
+        int *nodeOrderRank;     /* rank at each position of the node order */
+        int blockMapping;       /* ranks fill one node after the other */
+        int irregular;          /* uneven tasks per node or neither mapped by node nor by slot */
+} ior_topology_t;
+
+const ior_topology_t *GetTopology(MPI_Comm comm);
+int NodeOrderShift(const ior_topology_t *topo, int rank, long long shift);
+
+/* an allocation of a task, see MemoryBudget() */
+typedef struct {
+        const char *name;
+        size_t bytes;
+} ior_memory_item_t;
+
+typedef struct {
+        size_t task;            /* largest allocations of a task */
+        size_t node;            /* allocations of the tasks of the node with the least memory left */
+        size_t reserve;         /* memory reserved by the tasks of that node */
+        size_t available;       /* memory available on that node, 0 if unknown */
+        int nodeIndex;          /* that node */
+        int exceeded;           /* the node cannot provide its allocations and reserve */
+} ior_memory_budget_t;
+
+size_t GetAvailableMemory(void);
+size_t GetPeakMemory(void);
+void MemoryBudget(ior_memory_item_t *items, int count, size_t reserve, MPI_Comm comm,
+                  ior_memory_budget_t *budget);
+void GatherPeakMemory(MPI_Comm comm, size_t *task, size_t *node);
 int QueryNodeMapping(MPI_Comm comm, int print_nodemap);
 int GetNumNodes(MPI_Comm);
+int GetNodeIndex(MPI_Comm);
 int GetNumTasks(MPI_Comm);
 int GetNumTasksOnNode0(MPI_Comm);
 void DelaySecs(int delay);
 void updateParsedOptions(IOR_param_t * options, options_all_t * global_options);
 size_t NodeMemoryStringToBytes(char *size_str);
 
+uint64_t Mix64(uint64_t x);
+
+/* a seeded pseudo-random permutation of [0, count), see PermutationInit() */
+#define IOR_PERMUTATION_ROUNDS 4
+typedef struct {
+  uint64_t count;
+  int halfBits;
+  uint64_t halfMask;
+  uint64_t keys[IOR_PERMUTATION_ROUNDS];
+} ior_permutation_t;
+
+void PermutationInit(ior_permutation_t *p, uint64_t count, uint64_t seed);
+uint64_t PermutationValue(const ior_permutation_t *p, uint64_t index);
+
+/* by default store 1M operations into the buffer before flushing */
+#define OP_BUFFER_SIZE 1000000
 typedef struct OpTimer OpTimer;
 OpTimer* OpTimerInit(char * filename, int size);
 void OpTimerValue(OpTimer* otimer_in, double now, double runTime);
@@ -72,12 +129,41 @@ void OpTimerFree(OpTimer** otimer_in);
 
 /* Returns -1, if cannot be read  */
 int64_t ReadStoneWallingIterations(char * const filename, MPI_Comm com);
+void AppendRankRecords(char *filename, const void *record, int length, MPI_Comm comm);
 void StoreStoneWallingIterations(char * const filename, int64_t count);
 
+extern const char *ResourceNames[IOR_NB_RES];
+void ResourcesSample(double *res, int level, MPI_Comm comm);
+void ResourcesDelta(double *res, const double *start);
+
+extern const char *PerfCounterNames[IOR_NB_PERF];
+int PerfCountersOpen(int *userOnly);
+void PerfCountersSetup(MPI_Comm comm);
+void PerfCountersStart(void);
+void PerfCountersStop(double *res);
+void PerfCountersClose(void);
+
 void init_clock(MPI_Comm com);
 double GetTimeStamp(void);
 char * PrintTimestamp(void); // TODO remove this function
 unsigned long GetProcessorAndCore(int *chip, int *core);
+
+/* where a task runs and where its transfer buffer resides */
+typedef struct {
+        int node;               /* index of the node of the task */
+        int cpu;                /* CPU the task runs on */
+        int cpuNumaNode;        /* NUMA node of that CPU */
+        int cpusAllowed;        /* number of CPUs the task may run on */
+        int bufferNumaNode;     /* NUMA node of the buffer, -1 if unknown */
+} ior_placement_t;
+
+int BindToCpus(const char *mode, int numaNode, MPI_Comm comm);
+int GetDeviceNumaNode(const char *device, const char *path);
+void SetBufferNumaNode(int node);
+void GetPlacement(void *buf, ior_placement_t *placement);
 void *aligned_buffer_alloc(size_t size, ior_memory_flags type);
 void aligned_buffer_free(void *buf, ior_memory_flags type);
+int aligned_buffer_huge_pages(const char *mode);
+size_t aligned_buffer_footprint(size_t size);
+void aligned_buffer_pool_release(void);
 #endif  /* !_UTILITIES_H */
@@ -15,6 +15,36 @@ source $ROOT/test-lib.sh
 IOR 2 -a POSIX -w     -C              -k -e -i1 -m -t 100k -b 200k
 # Random read the file previously created
 IOR 2 -a POSIX -r                     -k -e -i1 -m -t 100k -b 200k -s 10 -z -z
+IOR 2 -a POSIX -w -r -e -b 256k -O transferSize=64k..256k:x2
+IOR 2 -a POSIX -w -r -e -b 1m --autotune -O tune=transferSize:64k..1m:x2 -O autotuneBudget=10 -O autotuneTrialTime=1 -O autotuneRepetitions=1
+IOR 2 -a POSIX -w -r -e -t 64k -b 256k -O numNodes=1..max:x2
+IOR 2 -f "$ROOT/test_concurrent.ior"
+IOR 2 -a POSIX -w -e -t 64k -b 1m -D 1 -O stoneWallingWearOut=1 -O stoneWallingWorkStealing=1
+IOR 3 -a POSIX -w -r -C -e -i 2 -t 64k -b 256k
+IOR 4 -a POSIX -w -r -C -Q 2 -e -t 64k -b 256k
+IOR 2 -a POSIX -w -e -t 64k -b 256k -O saveRankPerformanceDetailsCSV=${IOR_OUT}/rank.csv -O saveRankPerformanceDetailsBinary=${IOR_OUT}/rank.bin
+IOR 2 -a POSIX -w -r -e -t 64k -b 256k -O reorderTasksTopology=1
+IOR 2 -a POSIX -w -r -e -t 64k -b 256k -O cpuBind=share -O numaNode=0
+IOR 2 -a POSIX -w -r -C -k -e -t 64k -b 256k -O hugePages=thp
+IOR 2 -a POSIX -w -r -W -R -C -e -t 64k -b 256k -O sharedPatternBuffer=1
+IOR 2 -a POSIX -w -r -e -t 64k -b 256k -O resourceAccounting=2
+MDTEST_NOPATTERN 2 -a POSIX -n 20 --resourceAccounting=1
+IOR 2 -a POSIX -w -r -e -t 64k -b 256k -O perfCounters=1
+MDTEST_NOPATTERN 2 -a POSIX -n 20 --perfCounters
+IOR 2 -a POSIX -w -r -e -t 64k -b 256k -O memoryPerTask=16m
+MDTEST_NOPATTERN 3 -a POSIX -n 30 -z 2 -b 3
+MDTEST_NOPATTERN 3 -a POSIX -n 30 -z 2 -b 2 -c
+MDTEST_NOPATTERN 2 -a POSIX -n 50 -w 100 -e 100 -R
+MDTEST_NOPATTERN 2 -a POSIX -n 50 -w 100 -e 100 --dirHandles
+MDTEST_NOPATTERN 2 -a POSIX -n 50 -w 100 -e 100 -X --threads=4
+MDTEST_NOPATTERN 2 -a POSIX -n 50 -w 100 -e 100 -X --uringDepth=8
+MDTEST_NOPATTERN 2 -a POSIX -n 50 -z 1 -b 2 --readdir
+MDTEST_NOPATTERN 2 -a POSIX -n 50 --xattrs=2 -R
+MDTEST_NOPATTERN 2 -a POSIX -n 60 -z 1 -b 2 --renameFiles --links --symlinks
+MDTEST_NOPATTERN 2 -a POSIX -C -n 50 -z 2 -b 3
+MDFIND 1 -a POSIX
+MDFIND 3 -a POSIX -i 2 --scaling --process-reports
+MDTEST_NOPATTERN 2 -a POSIX -X -n 100 --sizeDistribution=list:0=1,100=2,4k=2,64k=1
 
 exit 1
 
@@ -17,6 +17,7 @@ IOR_EXTRA=${IOR_EXTRA:-} # Add global options like verbosity
 MDTEST_EXTRA=${MDTEST_EXTRA:-}
 MDTEST_TEST_PATTERNS=${MDTEST_TEST_PATTERNS:-../testing/mdtest-patterns/$TYPE}
 MDWB_EXTRA=${MDWB_EXTRA:-}
+MDFIND_EXTRA=${MDFIND_EXTRA:-}
 
 
 ################################################################################
@@ -87,6 +88,24 @@ function MDTEST(){
   I=$((${I}+1))
 }
 
+# like MDTEST, but the output is not compared to a pattern, for the runs that
+# precede the pattern tests
+function MDTEST_NOPATTERN(){
+  RANKS=$1
+  shift
+  rm -rf ${IOR_TMP}/mdest
+  WHAT="${IOR_MPIRUN} $RANKS ${IOR_BIN_DIR}/mdtest ${@} -d ${IOR_TMP}/mdest ${MDTEST_EXTRA} -V=4"
+  $WHAT 1>"${IOR_OUT}/test_out.$I" 2>&1
+  if [[ $? != 0 ]]; then
+    echo -n "ERR"
+    ERRORS=$(($ERRORS + 1))
+  else
+    echo -n "OK "
+  fi
+  echo " $WHAT"
+  I=$((${I}+1))
+}
+
 function MDWB(){
   RANKS=$1
   shift
@@ -106,6 +125,22 @@ function MDWB(){
   I=$((${I}+1))
 }
 
+# traverse the tree of the previous MDTEST run
+function MDFIND(){
+  RANKS=$1
+  shift
+  WHAT="${IOR_MPIRUN} $RANKS ${IOR_BIN_DIR}/md-find ${@} -d ${IOR_TMP}/mdest ${MDFIND_EXTRA}"
+  $WHAT 1>"${IOR_OUT}/test_out.$I" 2>&1
+  if [[ $? != 0 ]]; then
+    echo -n "ERR"
+    ERRORS=$(($ERRORS + 1))
+  else
+    echo -n "OK "
+  fi
+  echo " $WHAT"
+  I=$((${I}+1))
+}
+
 function END(){
   if [[ ${ERRORS} == 0 ]] ; then
     echo "PASSED"